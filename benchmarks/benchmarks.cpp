@@ -0,0 +1,12 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+#include "block_benchmark.h"
+#include "exporter_benchmark.h"
+#include "reader_benchmark.h"
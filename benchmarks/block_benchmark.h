@@ -0,0 +1,108 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+
+namespace CDNS {
+    /**
+     * @brief Rate of inserting DNS records into Block with add_question_response_record().
+     * First argument enables pre-encoding of Block tables, second one sets limit of Block table cache.
+     */
+    static void BM_BlockIngest(benchmark::State& state) {
+        const auto& traffic = bench_traffic();
+        BlockParameters bp;
+        CdnsBlock block(bp, 0);
+        block.set_pre_encode(state.range(0));
+        block.set_table_cache(state.range(1));
+        std::size_t i = 0;
+
+        for (auto _ : state) {
+            if (block.add_question_response_record(traffic[i]))
+                block.clear();
+            i = (i + 1) % traffic.size();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_BlockIngest)->Args({0, 0})->Args({1, 0})->Args({0, 65536})->Args({1, 65536});
+
+    /**
+     * @brief Rate of lookups and insertions of NAMEs into Block table
+     */
+    static void BM_BlockTableAdd(benchmark::State& state) {
+        const auto& traffic = bench_traffic();
+        BlockTable<StringItem> table;
+        std::size_t i = 0;
+
+        for (auto _ : state) {
+            const std::string& name = *traffic[i].query_name;
+            benchmark::DoNotOptimize(table.add(name.data(), name.size()));
+            if (++i == BlockParameters().storage_parameters.max_block_items) {
+                table.clear();
+                i = 0;
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_BlockTableAdd);
+
+    /**
+     * @brief Time of encoding full Block to CBOR in memory. Argument enables pre-encoding of Block tables.
+     */
+    static void BM_BlockFlush(benchmark::State& state) {
+        const auto& traffic = bench_traffic();
+        BlockParameters bp;
+        CdnsBlock block(bp, 0);
+        block.set_pre_encode(state.range(0));
+        for (std::size_t i = 0; i < bp.storage_parameters.max_block_items; i++)
+            block.add_question_response_record(traffic[i]);
+
+        std::string output;
+        std::size_t written = 0;
+
+        for (auto _ : state) {
+            output.clear();
+            CdnsEncoder enc(output);
+            written += block.write(enc);
+        }
+
+        state.SetBytesProcessed(written);
+        state.SetItemsProcessed(state.iterations() * bp.storage_parameters.max_block_items);
+    }
+    BENCHMARK(BM_BlockFlush)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+    /**
+     * @brief Heap memory held by one full Block
+     */
+    static void BM_BlockMemory(benchmark::State& state) {
+        const auto& traffic = bench_traffic();
+        BlockParameters bp;
+        std::size_t bytes = 0;
+
+        for (auto _ : state) {
+            std::size_t before = bench_heap_bytes();
+            {
+                CdnsBlock block(bp, 0);
+                block.set_pre_encode(state.range(0));
+                for (std::size_t i = 0; i < bp.storage_parameters.max_block_items; i++)
+                    block.add_question_response_record(traffic[i]);
+                bytes += bench_heap_bytes() - before;
+            }
+        }
+
+        state.counters["heap_bytes_per_block"] = benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+        state.counters["heap_bytes_per_record"] =
+            benchmark::Counter(static_cast<double>(bytes) / bp.storage_parameters.max_block_items, benchmark::Counter::kAvgIterations);
+    }
+    BENCHMARK(BM_BlockMemory)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+}
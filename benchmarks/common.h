@@ -0,0 +1,72 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "../src/cdns.h"
+
+namespace CDNS {
+    /**
+     * @brief Get shared set of generated DNS transactions, large enough for several full Blocks
+     */
+    inline const std::vector<GenericQueryResponse>& bench_traffic() {
+        static const std::vector<GenericQueryResponse> traffic = TrafficGenerator().generate_qrs(100000);
+        return traffic;
+    }
+
+    /**
+     * @brief Export given DNS transactions to C-DNS and return content of the C-DNS file
+     * @param traffic DNS transactions to export
+     * @param compression Compression of the C-DNS file
+     */
+    inline std::string bench_cdns_file(const std::vector<GenericQueryResponse>& traffic,
+                                       CborOutputCompression compression = CborOutputCompression::NO_COMPRESSION) {
+        char name[] = "/tmp/cdns_benchXXXXXX";
+        int fd = mkstemp(name);
+        if (fd < 0)
+            throw std::runtime_error("Couldn't create temporary file");
+
+        {
+            FilePreamble fp;
+            CdnsExporter exporter(fp, fd, compression);
+            for (auto& qr : traffic)
+                exporter.buffer_qr(qr);
+            exporter.write_block();
+        }
+
+        std::ifstream input(name, std::ifstream::binary);
+        std::string ret((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        std::remove(name);
+        return ret;
+    }
+
+    /**
+     * @brief Get number of bytes currently allocated on heap (0 if not supported by the C library)
+     */
+    inline std::size_t bench_heap_bytes() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+        // Older glibc has only mallinfo() with int fields that wrap around above 2 GiB
+        return static_cast<unsigned>(mallinfo().uordblks);
+#else
+        return 0;
+#endif
+    }
+}
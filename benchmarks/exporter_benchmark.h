@@ -0,0 +1,50 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <fcntl.h>
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+
+namespace CDNS {
+    /**
+     * @brief Throughput of exporting full Blocks to output with given compression
+     * (argument is CborOutputCompression value)
+     */
+    static void BM_ExportCompression(benchmark::State& state) {
+        const auto& traffic = bench_traffic();
+        int fd = open("/dev/null", O_WRONLY);
+        if (fd < 0) {
+            state.SkipWithError("Couldn't open /dev/null");
+            return;
+        }
+
+        FilePreamble fp;
+        CdnsExporter exporter(fp, fd, static_cast<CborOutputCompression>(state.range(0)));
+        uint64_t items = fp.get_block_parameters(0).storage_parameters.max_block_items;
+        std::size_t written = 0;
+        std::size_t i = 0;
+
+        for (auto _ : state) {
+            for (uint64_t j = 0; j < items; j++) {
+                written += exporter.buffer_qr(traffic[i]);
+                i = (i + 1) % traffic.size();
+            }
+        }
+
+        state.SetBytesProcessed(written);
+        state.SetItemsProcessed(state.iterations() * items);
+    }
+    BENCHMARK(BM_ExportCompression)
+        ->Arg(static_cast<int>(CborOutputCompression::NO_COMPRESSION))
+        ->Arg(static_cast<int>(CborOutputCompression::GZIP))
+        ->Arg(static_cast<int>(CborOutputCompression::XZ))
+        ->Unit(benchmark::kMillisecond);
+}
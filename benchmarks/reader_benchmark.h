@@ -0,0 +1,173 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <sstream>
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+
+namespace CDNS {
+    /**
+     * @brief Get uncompressed C-DNS file with all generated DNS transactions
+     */
+    inline const std::string& bench_decode_input() {
+        static const std::string input = bench_cdns_file(bench_traffic());
+        return input;
+    }
+
+    /**
+     * @brief Throughput of decoding whole C-DNS file to Blocks
+     */
+    static void BM_DecodeBlocks(benchmark::State& state) {
+        const std::string& input = bench_decode_input();
+        uint64_t blocks = 0;
+
+        for (auto _ : state) {
+            std::istringstream stream(input);
+            CdnsReader reader(stream);
+            bool end = false;
+            while (true) {
+                CdnsBlockRead block = reader.read_block(end);
+                if (end)
+                    break;
+                blocks++;
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations() * input.size());
+        state.counters["blocks"] = benchmark::Counter(blocks, benchmark::Counter::kAvgIterations);
+    }
+    BENCHMARK(BM_DecodeBlocks)->Unit(benchmark::kMillisecond);
+
+    /**
+     * @brief Throughput of splitting whole C-DNS file to raw Blocks without decoding them
+     */
+    static void BM_SplitBlocks(benchmark::State& state) {
+        const std::string& input = bench_decode_input();
+        uint64_t blocks = 0;
+        CdnsRawBlock block;
+
+        for (auto _ : state) {
+            std::istringstream stream(input);
+            CdnsReader reader(stream);
+            bool end = false;
+            while (true) {
+                reader.read_raw_block(block, end);
+                if (end)
+                    break;
+                blocks++;
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations() * input.size());
+        state.counters["blocks"] = benchmark::Counter(blocks, benchmark::Counter::kAvgIterations);
+    }
+    BENCHMARK(BM_SplitBlocks)->Unit(benchmark::kMillisecond);
+
+    /**
+     * @brief Throughput of decoding whole C-DNS file to GenericQueryResponse records
+     */
+    static void BM_DecodeRecords(benchmark::State& state) {
+        const std::string& input = bench_decode_input();
+        uint64_t records = 0;
+
+        for (auto _ : state) {
+            std::istringstream stream(input);
+            CdnsReader reader(stream);
+            bool end = false;
+            while (true) {
+                CdnsBlockRead block = reader.read_block(end);
+                if (end)
+                    break;
+
+                while (true) {
+                    GenericQueryResponse gqr = block.read_generic_qr(end);
+                    if (end)
+                        break;
+                    records++;
+                }
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations() * input.size());
+        state.SetItemsProcessed(records);
+    }
+    BENCHMARK(BM_DecodeRecords)->Unit(benchmark::kMillisecond);
+
+    /**
+     * @brief Throughput of decoding GenericQueryResponse records within time range covering 10 % of
+     * time-ordered C-DNS file
+     */
+    static void BM_DecodeTimeRange(benchmark::State& state) {
+        const std::string& input = bench_decode_input();
+        const std::vector<GenericQueryResponse>& traffic = bench_traffic();
+        Timestamp start = *traffic[traffic.size() / 2].ts;
+        Timestamp end = *traffic[traffic.size() / 2 + traffic.size() / 10].ts;
+        uint64_t records = 0;
+
+        for (auto _ : state) {
+            std::istringstream stream(input);
+            CdnsReader reader(stream);
+            reader.set_time_filter(start, end, true);
+            CdnsBlockRead block;
+            bool end_of_input = false;
+            while (true) {
+                reader.read_block(block, end_of_input);
+                if (end_of_input)
+                    break;
+
+                while (true) {
+                    GenericQueryResponse gqr = block.read_generic_qr(end_of_input);
+                    if (end_of_input)
+                        break;
+                    records++;
+                }
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations() * input.size());
+        state.SetItemsProcessed(records);
+    }
+    BENCHMARK(BM_DecodeTimeRange)->Unit(benchmark::kMillisecond);
+
+    /**
+     * @brief Throughput of decoding GenericQueryResponse records with one client IP address
+     */
+    static void BM_DecodeClientIp(benchmark::State& state) {
+        const std::string& input = bench_decode_input();
+        const std::vector<GenericQueryResponse>& traffic = bench_traffic();
+        std::string address = *traffic[traffic.size() / 2].client_ip;
+        uint64_t records = 0;
+
+        for (auto _ : state) {
+            std::istringstream stream(input);
+            CdnsReader reader(stream);
+            reader.set_client_ip_filter(address);
+            CdnsBlockRead block;
+            bool end_of_input = false;
+            while (true) {
+                reader.read_block(block, end_of_input);
+                if (end_of_input)
+                    break;
+
+                while (true) {
+                    GenericQueryResponse gqr = block.read_generic_qr(end_of_input);
+                    if (end_of_input)
+                        break;
+                    records++;
+                }
+            }
+        }
+
+        state.SetBytesProcessed(state.iterations() * input.size());
+        state.SetItemsProcessed(records);
+    }
+    BENCHMARK(BM_DecodeClientIp)->Unit(benchmark::kMillisecond);
+}
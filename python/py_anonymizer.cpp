@@ -0,0 +1,32 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory>
+#include <pybind11/pybind11.h>
+#include "anonymizer.h"
+#include "py_common.h"
+
+namespace py = pybind11;
+
+void init_anonymizer(py::module& m)
+{
+    py::enum_<CDNS::IpAnonymizationMethod>(m, "IpAnonymizationMethod")
+        .value("PREFIX_MASK", CDNS::IpAnonymizationMethod::PREFIX_MASK)
+        .value("CRYPTOPAN", CDNS::IpAnonymizationMethod::CRYPTOPAN)
+        .export_values();
+
+    py::class_<CDNS::IpAnonymizer, std::shared_ptr<CDNS::IpAnonymizer>>(m, "IpAnonymizer")
+        .def(py::init())
+        .def(py::init<const std::string&>())
+        .def("get_method", &CDNS::IpAnonymizer::get_method)
+        .def("anonymize", [](CDNS::IpAnonymizer& self, py::bytes address) {
+            std::string addr = address;
+            self.anonymize(reinterpret_cast<uint8_t*>(&addr[0]), addr.size());
+            return py::bytes(addr);
+        });
+}
@@ -128,7 +128,8 @@ void init_block(py::module& m)
         .def_readwrite("unmatched_queries", &CDNS::BlockStatistics::unmatched_queries)
         .def_readwrite("unmatched_responses", &CDNS::BlockStatistics::unmatched_responses)
         .def_readwrite("discarded_opcode", &CDNS::BlockStatistics::discarded_opcode)
-        .def_readwrite("malformed_items", &CDNS::BlockStatistics::malformed_items);
+        .def_readwrite("malformed_items", &CDNS::BlockStatistics::malformed_items)
+        .def_readwrite("dropped_items", &CDNS::BlockStatistics::dropped_items);
 
     py::class_<CDNS::QueryResponse>(m, "QueryResponse")
         .def(py::init())
@@ -197,7 +198,31 @@ void init_block(py::module& m)
         .def("write", &CDNS::IndexListItem::write)
         .def("read", &CDNS::IndexListItem::read)
         .def("reset", &CDNS::IndexListItem::reset)
-        .def_readwrite("list", &CDNS::IndexListItem::list);
+        .def_property("list",
+            [](const CDNS::IndexListItem& self) {
+                return std::vector<CDNS::index_t>(self.list.begin(), self.list.end());
+            },
+            [](CDNS::IndexListItem& self, const std::vector<CDNS::index_t>& list) {
+                self.list.assign(list.begin(), list.end());
+            });
+
+    py::class_<CDNS::BlockTableMetrics>(m, "BlockTableMetrics")
+        .def(py::init())
+        .def_readwrite("items", &CDNS::BlockTableMetrics::items)
+        .def_readwrite("lookups", &CDNS::BlockTableMetrics::lookups)
+        .def("hit_ratio", &CDNS::BlockTableMetrics::hit_ratio);
+
+    py::class_<CDNS::BlockTablesMetrics>(m, "BlockTablesMetrics")
+        .def(py::init())
+        .def_readwrite("ip_address", &CDNS::BlockTablesMetrics::ip_address)
+        .def_readwrite("classtype", &CDNS::BlockTablesMetrics::classtype)
+        .def_readwrite("name_rdata", &CDNS::BlockTablesMetrics::name_rdata)
+        .def_readwrite("qr_sig", &CDNS::BlockTablesMetrics::qr_sig)
+        .def_readwrite("qlist", &CDNS::BlockTablesMetrics::qlist)
+        .def_readwrite("qrr", &CDNS::BlockTablesMetrics::qrr)
+        .def_readwrite("rrlist", &CDNS::BlockTablesMetrics::rrlist)
+        .def_readwrite("rr", &CDNS::BlockTablesMetrics::rr)
+        .def_readwrite("malformed_message_data", &CDNS::BlockTablesMetrics::malformed_message_data);
 
     py::class_<CDNS::CdnsBlock>(m, "CdnsBlock")
         .def(py::init())
@@ -205,19 +230,24 @@ void init_block(py::module& m)
         .def(py::init<CDNS::CdnsBlock&>())
         .def("write", &CDNS::CdnsBlock::write)
         .def("get_block_parameters_index", &CDNS::CdnsBlock::get_block_parameters_index)
-        .def("add_ip_address", &CDNS::CdnsBlock::add_ip_address)
+        .def("set_anonymizer", [](CDNS::CdnsBlock& self, std::shared_ptr<CDNS::IpAnonymizer> anonymizer) {
+            self.set_anonymizer(anonymizer);
+        })
+        .def("set_table_cache", &CDNS::CdnsBlock::set_table_cache)
+        .def("set_pre_encode", &CDNS::CdnsBlock::set_pre_encode)
+        .def("add_ip_address", py::overload_cast<const std::string&>(&CDNS::CdnsBlock::add_ip_address))
         .def("get_ip_address", &CDNS::CdnsBlock::get_ip_address)
         .def("add_classtype", &CDNS::CdnsBlock::add_classtype)
         .def("get_classtype", &CDNS::CdnsBlock::get_classtype)
-        .def("add_name_rdata", &CDNS::CdnsBlock::add_name_rdata)
+        .def("add_name_rdata", py::overload_cast<const std::string&>(&CDNS::CdnsBlock::add_name_rdata))
         .def("get_name_rdata", &CDNS::CdnsBlock::get_name_rdata)
         .def("add_qr_signature", &CDNS::CdnsBlock::add_qr_signature)
         .def("get_qr_signature", &CDNS::CdnsBlock::get_qr_signature)
-        .def("add_question_list", &CDNS::CdnsBlock::add_question_list)
+        .def("add_question_list", py::overload_cast<const std::vector<CDNS::index_t>&>(&CDNS::CdnsBlock::add_question_list))
         .def("get_question_list", &CDNS::CdnsBlock::get_question_list)
         .def("add_question", &CDNS::CdnsBlock::add_question)
         .def("get_question", &CDNS::CdnsBlock::get_question)
-        .def("add_rr_list", &CDNS::CdnsBlock::add_rr_list)
+        .def("add_rr_list", py::overload_cast<const std::vector<CDNS::index_t>&>(&CDNS::CdnsBlock::add_rr_list))
         .def("get_rr_list", &CDNS::CdnsBlock::get_rr_list)
         .def("add_rr", &CDNS::CdnsBlock::add_rr)
         .def("get_rr", &CDNS::CdnsBlock::get_rr)
@@ -244,6 +274,7 @@ void init_block(py::module& m)
             const boost::optional<CDNS::BlockStatistics>&>(&CDNS::CdnsBlock::add_malformed_message),
             py::arg("mm"), py::arg("stats") = py::none())
         .def("get_item_count", &CDNS::CdnsBlock::get_item_count)
+        .def("get_table_metrics", &CDNS::CdnsBlock::get_table_metrics)
         .def("get_qr_count", &CDNS::CdnsBlock::get_qr_count)
         .def("get_aec_count", &CDNS::CdnsBlock::get_aec_count)
         .def("get_mm_count", &CDNS::CdnsBlock::get_mm_count)
@@ -287,19 +318,19 @@ void init_block(py::module& m)
         })
         .def("write", &CDNS::CdnsBlockRead::write)
         .def("get_block_parameters_index", &CDNS::CdnsBlockRead::get_block_parameters_index)
-        .def("add_ip_address", &CDNS::CdnsBlockRead::add_ip_address)
+        .def("add_ip_address", py::overload_cast<const std::string&>(&CDNS::CdnsBlockRead::add_ip_address))
         .def("get_ip_address", &CDNS::CdnsBlockRead::get_ip_address)
         .def("add_classtype", &CDNS::CdnsBlockRead::add_classtype)
         .def("get_classtype", &CDNS::CdnsBlockRead::get_classtype)
-        .def("add_name_rdata", &CDNS::CdnsBlockRead::add_name_rdata)
+        .def("add_name_rdata", py::overload_cast<const std::string&>(&CDNS::CdnsBlockRead::add_name_rdata))
         .def("get_name_rdata", &CDNS::CdnsBlockRead::get_name_rdata)
         .def("add_qr_signature", &CDNS::CdnsBlockRead::add_qr_signature)
         .def("get_qr_signature", &CDNS::CdnsBlockRead::get_qr_signature)
-        .def("add_question_list", &CDNS::CdnsBlockRead::add_question_list)
+        .def("add_question_list", py::overload_cast<const std::vector<CDNS::index_t>&>(&CDNS::CdnsBlockRead::add_question_list))
         .def("get_question_list", &CDNS::CdnsBlockRead::get_question_list)
         .def("add_question", &CDNS::CdnsBlockRead::add_question)
         .def("get_question", &CDNS::CdnsBlockRead::get_question)
-        .def("add_rr_list", &CDNS::CdnsBlockRead::add_rr_list)
+        .def("add_rr_list", py::overload_cast<const std::vector<CDNS::index_t>&>(&CDNS::CdnsBlockRead::add_rr_list))
         .def("get_rr_list", &CDNS::CdnsBlockRead::get_rr_list)
         .def("add_rr", &CDNS::CdnsBlockRead::add_rr)
         .def("get_rr", &CDNS::CdnsBlockRead::get_rr)
@@ -346,4 +377,24 @@ void init_block(py::module& m)
         .def_readwrite("m_query_responses", &CDNS::CdnsBlockRead::m_query_responses)
         .def_readwrite("m_address_event_counts", &CDNS::CdnsBlockRead::m_address_event_counts)
         .def_readwrite("m_malformed_messages", &CDNS::CdnsBlockRead::m_malformed_messages);
+
+    py::class_<CDNS::BlockItemCounts>(m, "BlockItemCounts")
+        .def(py::init())
+        .def("read", &CDNS::BlockItemCounts::read)
+        .def_readwrite("qr_count", &CDNS::BlockItemCounts::qr_count)
+        .def_readwrite("aec_count", &CDNS::BlockItemCounts::aec_count)
+        .def_readwrite("mm_count", &CDNS::BlockItemCounts::mm_count);
+
+    py::class_<CDNS::CdnsRawBlock>(m, "CdnsRawBlock")
+        .def(py::init())
+        .def("read", &CDNS::CdnsRawBlock::read)
+        .def("write", &CDNS::CdnsRawBlock::write)
+        .def("clear", &CDNS::CdnsRawBlock::clear)
+        .def("get_block_parameters_index", &CDNS::CdnsRawBlock::get_block_parameters_index)
+        .def("get_qr_count", &CDNS::CdnsRawBlock::get_qr_count)
+        .def("get_aec_count", &CDNS::CdnsRawBlock::get_aec_count)
+        .def("get_mm_count", &CDNS::CdnsRawBlock::get_mm_count)
+        .def("get_item_count", &CDNS::CdnsRawBlock::get_item_count)
+        .def("get_raw_size", &CDNS::CdnsRawBlock::get_raw_size)
+        .def_readwrite("m_block_preamble", &CDNS::CdnsRawBlock::m_block_preamble);
 }
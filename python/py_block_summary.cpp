@@ -0,0 +1,71 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <fstream>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "cdns.h"
+#include "py_common.h"
+
+namespace py = pybind11;
+
+void init_block_summary(py::module& m)
+{
+    py::class_<CDNS::BloomFilter>(m, "BloomFilter")
+        .def(py::init())
+        .def(py::init<std::size_t, unsigned>(), py::arg("items"), py::arg("bits_per_item"))
+        .def("add", [](CDNS::BloomFilter& self, py::bytes value) {
+            self.add(value);
+        })
+        .def("may_contain", [](const CDNS::BloomFilter& self, py::bytes value) {
+            return self.may_contain(value);
+        })
+        .def("size", &CDNS::BloomFilter::size);
+
+    py::class_<CDNS::BlockSummary>(m, "BlockSummary")
+        .def(py::init())
+        .def(py::init<const CDNS::CdnsBlock&, uint64_t, unsigned>(), py::arg("block"), py::arg("index"),
+             py::arg("bits_per_item") = 10)
+        .def("may_match", [](const CDNS::BlockSummary& self, const optional<CDNS::Timestamp>& start,
+                             const optional<CDNS::Timestamp>& end, const optional<py::bytes>& query_name,
+                             const optional<py::bytes>& client_ip) {
+            CDNS::ItemFilter filter;
+            if (start && end)
+                filter.time_range = CDNS::TimeRange(*start, *end);
+            if (query_name)
+                filter.query_name = std::string(*query_name);
+            if (client_ip)
+                filter.client_ip = std::string(*client_ip);
+            return self.may_match(filter);
+        }, py::arg("start") = py::none(), py::arg("end") = py::none(), py::arg("query_name") = py::none(),
+           py::arg("client_ip") = py::none())
+        .def_readwrite("block_index", &CDNS::BlockSummary::block_index)
+        .def_readwrite("earliest_time", &CDNS::BlockSummary::earliest_time)
+        .def_readwrite("min_time", &CDNS::BlockSummary::min_time)
+        .def_readwrite("max_time", &CDNS::BlockSummary::max_time)
+        .def_readwrite("qr_count", &CDNS::BlockSummary::qr_count)
+        .def_readwrite("mm_count", &CDNS::BlockSummary::mm_count)
+        .def_readwrite("query_names", &CDNS::BlockSummary::query_names)
+        .def_readwrite("client_addresses", &CDNS::BlockSummary::client_addresses)
+        .def_readwrite("rcodes", &CDNS::BlockSummary::rcodes)
+        .def_readwrite("qtypes", &CDNS::BlockSummary::qtypes);
+
+    py::class_<CDNS::BlockSummaryWriter>(m, "BlockSummaryWriter")
+        .def(py::init<const std::string&>())
+        .def(py::init<const int&>())
+        .def("write", &CDNS::BlockSummaryWriter::write);
+
+    py::class_<CDNS::BlockSummaryReader>(m, "BlockSummaryReader")
+        .def(py::init<std::ifstream&>(), py::keep_alive<1, 2>())
+        .def("read_summary", [](CDNS::BlockSummaryReader& self) {
+            bool end = false;
+            auto ret = self.read_summary(end);
+            return std::make_tuple(std::move(ret), end);
+        })
+        .def("read_summaries", &CDNS::BlockSummaryReader::read_summaries);
+}
@@ -28,8 +28,10 @@ void declare_block_table(py::module& m, std::string typestr) {
             return std::make_tuple(ret, index);
         })
         .def("add_value", py::overload_cast<const T&>(&Class::add_value))
-        .def("add", &Class::add)
+        .def("add", py::overload_cast<const T&>(&Class::add))
         .def("clear", &Class::clear)
+        .def("set_pre_encode", &Class::set_pre_encode)
+        .def("pre_encoded", &Class::pre_encoded)
         .def("__getitem__", &Class::operator[], py::return_value_policy::reference_internal)
         .def("size", &Class::size)
         .def("begin", &Class::begin)
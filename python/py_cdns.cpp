@@ -15,6 +15,8 @@
 #include <pybind11/operators.h>
 #include <pybind11/stl.h>
 #include <pybind11/iostream.h>
+#include <pybind11/chrono.h>
+#include <pybind11/functional.h>
 #include "cdns.h"
 #include "py_common.h"
 
@@ -22,12 +24,52 @@ namespace py = pybind11;
 
 void init_cdns(py::module& m)
 {
+    py::class_<CDNS::RotationParameters>(m, "RotationParameters")
+        .def(py::init())
+        .def_readwrite("interval", &CDNS::RotationParameters::interval)
+        .def_readwrite("max_bytes", &CDNS::RotationParameters::max_bytes)
+        .def_readwrite("max_blocks", &CDNS::RotationParameters::max_blocks)
+        .def_readwrite("name_template", &CDNS::RotationParameters::name_template);
+
+    py::class_<CDNS::BlockMetrics>(m, "BlockMetrics")
+        .def(py::init())
+        .def_readwrite("qr_count", &CDNS::BlockMetrics::qr_count)
+        .def_readwrite("aec_count", &CDNS::BlockMetrics::aec_count)
+        .def_readwrite("mm_count", &CDNS::BlockMetrics::mm_count)
+        .def_readwrite("bytes", &CDNS::BlockMetrics::bytes)
+        .def_readwrite("encode_time", &CDNS::BlockMetrics::encode_time)
+        .def_readwrite("output_time", &CDNS::BlockMetrics::output_time)
+        .def_readwrite("blocked_time", &CDNS::BlockMetrics::blocked_time)
+        .def_readwrite("dropped", &CDNS::BlockMetrics::dropped)
+        .def_readwrite("tables", &CDNS::BlockMetrics::tables);
+
+    py::class_<CDNS::ExporterMetrics>(m, "ExporterMetrics")
+        .def(py::init())
+        .def_readwrite("qr_items", &CDNS::ExporterMetrics::qr_items)
+        .def_readwrite("aec_items", &CDNS::ExporterMetrics::aec_items)
+        .def_readwrite("mm_items", &CDNS::ExporterMetrics::mm_items)
+        .def_readwrite("blocks_written", &CDNS::ExporterMetrics::blocks_written)
+        .def_readwrite("blocks_dropped", &CDNS::ExporterMetrics::blocks_dropped)
+        .def_readwrite("dropped_items", &CDNS::ExporterMetrics::dropped_items)
+        .def_readwrite("uncompressed_bytes", &CDNS::ExporterMetrics::uncompressed_bytes)
+        .def_readwrite("output_bytes", &CDNS::ExporterMetrics::output_bytes)
+        .def_readwrite("encode_time", &CDNS::ExporterMetrics::encode_time)
+        .def_readwrite("output_time", &CDNS::ExporterMetrics::output_time)
+        .def_readwrite("blocked_time", &CDNS::ExporterMetrics::blocked_time)
+        .def_readwrite("queued_blocks", &CDNS::ExporterMetrics::queued_blocks)
+        .def_readwrite("queued_bytes", &CDNS::ExporterMetrics::queued_bytes)
+        .def_readwrite("last_block", &CDNS::ExporterMetrics::last_block);
+
     py::class_<std::ifstream>(m, "Ifstream")
         .def(py::init<const std::string&>());
 
     py::class_<CDNS::CdnsExporter>(m, "CdnsExporter")
         .def(py::init<CDNS::FilePreamble&, const std::string&, CDNS::CborOutputCompression>())
         .def(py::init<CDNS::FilePreamble&, const int&, CDNS::CborOutputCompression>())
+        .def(py::init<CDNS::FilePreamble&, const std::string&, CDNS::CborOutputCompression,
+                      const CDNS::OutputQueueParameters&>())
+        .def(py::init<CDNS::FilePreamble&, const int&, CDNS::CborOutputCompression,
+                      const CDNS::OutputQueueParameters&>())
         .def("buffer_qr", &CDNS::CdnsExporter::buffer_qr, py::arg("qr"),
             py::arg("stats") = py::none())
         .def("buffer_aec", &CDNS::CdnsExporter::buffer_aec, py::arg("aec"),
@@ -35,6 +77,7 @@ void init_cdns(py::module& m)
         .def("buffer_mm", &CDNS::CdnsExporter::buffer_mm, py::arg("mm"),
             py::arg("stats") = py::none())
         .def("write_block", py::overload_cast<CDNS::CdnsBlock&>(&CDNS::CdnsExporter::write_block))
+        .def("write_block", py::overload_cast<CDNS::CdnsRawBlock&>(&CDNS::CdnsExporter::write_block))
         .def("write_block", py::overload_cast<>(&CDNS::CdnsExporter::write_block))
         .def("rotate_output", &CDNS::CdnsExporter::rotate_output<std::string>)
         .def("rotate_output", &CDNS::CdnsExporter::rotate_output<int>)
@@ -43,6 +86,18 @@ void init_cdns(py::module& m)
         .def("get_block_aec_count", &CDNS::CdnsExporter::get_block_aec_count)
         .def("get_block_mm_count", &CDNS::CdnsExporter::get_block_mm_count)
         .def("get_blocks_written_count", &CDNS::CdnsExporter::get_blocks_written_count)
+        .def("get_dropped_items_count", &CDNS::CdnsExporter::get_dropped_items_count)
+        .def("set_rotation_parameters", &CDNS::CdnsExporter::set_rotation_parameters)
+        .def("check_rotation", &CDNS::CdnsExporter::check_rotation)
+        .def("set_anonymizer", [](CDNS::CdnsExporter& self, std::shared_ptr<CDNS::IpAnonymizer> anonymizer) {
+            self.set_anonymizer(anonymizer);
+        })
+        .def("set_table_cache", &CDNS::CdnsExporter::set_table_cache)
+        .def("set_pre_encode", &CDNS::CdnsExporter::set_pre_encode)
+        .def("set_block_summaries", &CDNS::CdnsExporter::set_block_summaries, py::arg("suffix"),
+             py::arg("bits_per_item") = 10)
+        .def("get_metrics", &CDNS::CdnsExporter::get_metrics)
+        .def("set_metrics_callback", &CDNS::CdnsExporter::set_metrics_callback)
         .def("add_block_parameters", &CDNS::CdnsExporter::add_block_parameters)
         .def("set_active_block_parameters", &CDNS::CdnsExporter::set_active_block_parameters)
         .def("get_active_block_parameters", &CDNS::CdnsExporter::get_active_block_parameters)
@@ -58,5 +113,46 @@ void init_cdns(py::module& m)
             auto ret = self.read_block(end);
             return std::make_tuple(std::move(ret), end);
         })
+        .def("read_block", [](CDNS::CdnsReader& self, CDNS::CdnsBlockRead& block) {
+            bool end = false;
+            self.read_block(block, end);
+            return end;
+        })
+        .def("read_block_counts", [](CDNS::CdnsReader& self) {
+            bool end = false;
+            auto ret = self.read_block_counts(end);
+            return std::make_tuple(std::move(ret), end);
+        })
+        .def("read_raw_block", [](CDNS::CdnsReader& self) {
+            bool end = false;
+            auto ret = self.read_raw_block(end);
+            return std::make_tuple(std::move(ret), end);
+        })
+        .def("read_raw_block", [](CDNS::CdnsReader& self, CDNS::CdnsRawBlock& block) {
+            bool end = false;
+            self.read_raw_block(block, end);
+            return end;
+        })
+        .def("set_time_filter", &CDNS::CdnsReader::set_time_filter, py::arg("start"), py::arg("end"),
+             py::arg("time_ordered") = false)
+        .def("clear_time_filter", &CDNS::CdnsReader::clear_time_filter)
+        .def("set_query_name_filter", [](CDNS::CdnsReader& self, py::bytes name) {
+            self.set_query_name_filter(name);
+        }, py::arg("name"))
+        .def("clear_query_name_filter", &CDNS::CdnsReader::clear_query_name_filter)
+        .def("set_client_ip_filter", [](CDNS::CdnsReader& self, py::bytes address) {
+            self.set_client_ip_filter(address);
+        }, py::arg("address"))
+        .def("clear_client_ip_filter", &CDNS::CdnsReader::clear_client_ip_filter)
+        .def("set_block_summaries", &CDNS::CdnsReader::set_block_summaries)
+        .def("get_blocks_skipped_count", &CDNS::CdnsReader::get_blocks_skipped_count)
         .def_readwrite("m_file_preamble", &CDNS::CdnsReader::m_file_preamble);
+
+    py::class_<CDNS::CdnsMerger>(m, "CdnsMerger")
+        .def(py::init<unsigned>(), py::arg("threads") = 0)
+        .def("add_input", &CDNS::CdnsMerger::add_input, py::arg("reader"),
+            py::arg("block_indexes") = std::vector<CDNS::index_t>(), py::keep_alive<1, 2>())
+        .def("set_error_callback", &CDNS::CdnsMerger::set_error_callback)
+        .def("merge_blocks", &CDNS::CdnsMerger::merge_blocks, py::arg("exporter"), py::arg("decode") = false)
+        .def("merge_time_ordered", &CDNS::CdnsMerger::merge_time_ordered);
 }
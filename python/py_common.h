@@ -13,6 +13,8 @@
 #include <boost/optional.hpp>
 #include <boost/none.hpp>
 
+#include "compact_optional.h"
+
 namespace py = pybind11;
 
 using boost::optional;
@@ -20,4 +22,7 @@ using boost::optional;
 namespace PYBIND11_NAMESPACE { namespace detail {
     template <typename T>
     struct type_caster<boost::optional<T>> : optional_caster<boost::optional<T>> {};
+
+    template <typename T>
+    struct type_caster<CDNS::CompactOptional<T>> : optional_caster<CDNS::CompactOptional<T>> {};
 }}
@@ -109,6 +109,8 @@ void init_format_specification(py::module& m)
         .value("unmatched_responses", CDNS::BlockStatisticsMapIndex::unmatched_responses)
         .value("discarded_opcode", CDNS::BlockStatisticsMapIndex::discarded_opcode)
         .value("malformed_items", CDNS::BlockStatisticsMapIndex::malformed_items)
+        .value("block_statistics_standard_size", CDNS::BlockStatisticsMapIndex::block_statistics_standard_size)
+        .value("dropped_items", CDNS::BlockStatisticsMapIndex::dropped_items)
         .value("block_statistics_size", CDNS::BlockStatisticsMapIndex::block_statistics_size)
         .export_values();
 
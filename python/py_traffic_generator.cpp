@@ -0,0 +1,43 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include "cdns.h"
+#include "py_common.h"
+
+namespace py = pybind11;
+
+void init_traffic_generator(py::module& m)
+{
+    py::class_<CDNS::TrafficGeneratorConfig>(m, "TrafficGeneratorConfig")
+        .def(py::init())
+        .def_readwrite("seed", &CDNS::TrafficGeneratorConfig::seed)
+        .def_readwrite("clients", &CDNS::TrafficGeneratorConfig::clients)
+        .def_readwrite("names", &CDNS::TrafficGeneratorConfig::names)
+        .def_readwrite("servers", &CDNS::TrafficGeneratorConfig::servers)
+        .def_readwrite("client_skew", &CDNS::TrafficGeneratorConfig::client_skew)
+        .def_readwrite("name_skew", &CDNS::TrafficGeneratorConfig::name_skew)
+        .def_readwrite("ipv6_ratio", &CDNS::TrafficGeneratorConfig::ipv6_ratio)
+        .def_readwrite("tcp_ratio", &CDNS::TrafficGeneratorConfig::tcp_ratio)
+        .def_readwrite("encrypted_ratio", &CDNS::TrafficGeneratorConfig::encrypted_ratio)
+        .def_readwrite("queries_per_second", &CDNS::TrafficGeneratorConfig::queries_per_second)
+        .def_readwrite("start", &CDNS::TrafficGeneratorConfig::start)
+        .def_readwrite("ticks_per_second", &CDNS::TrafficGeneratorConfig::ticks_per_second)
+        .def_readwrite("aec_ratio", &CDNS::TrafficGeneratorConfig::aec_ratio)
+        .def_readwrite("mm_ratio", &CDNS::TrafficGeneratorConfig::mm_ratio);
+
+    py::class_<CDNS::TrafficGenerator>(m, "TrafficGenerator")
+        .def(py::init<const CDNS::TrafficGeneratorConfig&>(), py::arg("config") = CDNS::TrafficGeneratorConfig())
+        .def("get_config", &CDNS::TrafficGenerator::get_config)
+        .def("next_qr", &CDNS::TrafficGenerator::next_qr)
+        .def("next_aec", &CDNS::TrafficGenerator::next_aec)
+        .def("next_mm", &CDNS::TrafficGenerator::next_mm)
+        .def("generate_qrs", &CDNS::TrafficGenerator::generate_qrs)
+        .def("generate", &CDNS::TrafficGenerator::generate);
+}
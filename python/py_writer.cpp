@@ -21,6 +21,18 @@ void init_writer(py::module& m)
         .value("XZ", CDNS::CborOutputCompression::XZ)
         .export_values();
 
+    py::enum_<CDNS::OutputQueuePolicy>(m, "OutputQueuePolicy")
+        .value("BLOCK", CDNS::OutputQueuePolicy::BLOCK)
+        .value("DROP_NEWEST", CDNS::OutputQueuePolicy::DROP_NEWEST)
+        .value("DROP_OLDEST", CDNS::OutputQueuePolicy::DROP_OLDEST)
+        .export_values();
+
+    py::class_<CDNS::OutputQueueParameters>(m, "OutputQueueParameters")
+        .def(py::init())
+        .def_readwrite("max_blocks", &CDNS::OutputQueueParameters::max_blocks)
+        .def_readwrite("max_bytes", &CDNS::OutputQueueParameters::max_bytes)
+        .def_readwrite("policy", &CDNS::OutputQueueParameters::policy);
+
     py::register_exception<CDNS::CborOutputException>(m, "CborOutputException");
 
     py::class_<CDNS::Writer<std::string>>(m, "StringWriter")
@@ -20,9 +20,12 @@ void init_cdns_decoder(py::module&);
 void init_timestamp(py::module&);
 void init_file_preamble(py::module&);
 void init_block_table(py::module&);
+void init_anonymizer(py::module&);
 void init_block(py::module&);
+void init_block_summary(py::module&);
 void init_interface(py::module&);
 void init_cdns(py::module&);
+void init_traffic_generator(py::module&);
 
 PYBIND11_MODULE(pycdns, m)
 {
@@ -34,7 +37,10 @@ PYBIND11_MODULE(pycdns, m)
     init_timestamp(m);
     init_file_preamble(m);
     init_block_table(m);
+    init_anonymizer(m);
     init_block(m);
+    init_block_summary(m);
     init_interface(m);
     init_cdns(m);
+    init_traffic_generator(m);
 }
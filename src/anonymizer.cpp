@@ -0,0 +1,182 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <wmmintrin.h>
+#define CDNS_ANONYMIZER_X86
+#endif
+
+#include "anonymizer.h"
+
+namespace {
+    const uint8_t sbox[256] = {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+    };
+
+    const uint8_t rcon[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+
+    /**
+     * @brief Multiply byte by x in GF(2^8)
+     */
+    inline uint8_t xtime(uint8_t x) {
+        return static_cast<uint8_t>((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00));
+    }
+
+    /**
+     * @brief Expand AES-128 key to 11 round keys
+     */
+    void expand_key(const uint8_t* key, uint8_t* round_keys) {
+        std::memcpy(round_keys, key, 16);
+
+        for (unsigned i = 4; i < 44; i++) {
+            uint8_t tmp[4];
+            std::memcpy(tmp, round_keys + (i - 1) * 4, 4);
+
+            if (i % 4 == 0) {
+                uint8_t first = tmp[0];
+                tmp[0] = sbox[tmp[1]] ^ rcon[i / 4 - 1];
+                tmp[1] = sbox[tmp[2]];
+                tmp[2] = sbox[tmp[3]];
+                tmp[3] = sbox[first];
+            }
+
+            for (unsigned j = 0; j < 4; j++)
+                round_keys[i * 4 + j] = round_keys[(i - 4) * 4 + j] ^ tmp[j];
+        }
+    }
+
+    /**
+     * @brief Encrypt one block with AES-128 in software
+     */
+    void encrypt_soft(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) {
+        uint8_t state[16];
+
+        for (unsigned i = 0; i < 16; i++)
+            state[i] = in[i] ^ round_keys[i];
+
+        for (unsigned round = 1; round <= 10; round++) {
+            uint8_t tmp[16];
+
+            // SubBytes and ShiftRows
+            for (unsigned col = 0; col < 4; col++) {
+                for (unsigned row = 0; row < 4; row++)
+                    tmp[col * 4 + row] = sbox[state[((col + row) % 4) * 4 + row]];
+            }
+
+            // MixColumns (skipped in the last round)
+            if (round != 10) {
+                for (unsigned col = 0; col < 4; col++) {
+                    uint8_t* c = tmp + col * 4;
+                    uint8_t all = c[0] ^ c[1] ^ c[2] ^ c[3];
+                    uint8_t first = c[0];
+                    c[0] ^= all ^ xtime(c[0] ^ c[1]);
+                    c[1] ^= all ^ xtime(c[1] ^ c[2]);
+                    c[2] ^= all ^ xtime(c[2] ^ c[3]);
+                    c[3] ^= all ^ xtime(c[3] ^ first);
+                }
+            }
+
+            for (unsigned i = 0; i < 16; i++)
+                state[i] = tmp[i] ^ round_keys[round * 16 + i];
+        }
+
+        std::memcpy(out, state, 16);
+    }
+
+#ifdef CDNS_ANONYMIZER_X86
+    /**
+     * @brief Encrypt one block with AES-128 using AES-NI instructions
+     */
+    __attribute__((target("aes,sse2")))
+    void encrypt_aesni(const uint8_t* round_keys, const uint8_t* in, uint8_t* out) {
+        const __m128i* rk = reinterpret_cast<const __m128i*>(round_keys);
+        __m128i state = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_loadu_si128(rk));
+
+        for (unsigned round = 1; round < 10; round++)
+            state = _mm_aesenc_si128(state, _mm_loadu_si128(rk + round));
+
+        state = _mm_aesenclast_si128(state, _mm_loadu_si128(rk + 10));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+    }
+#endif
+}
+
+CDNS::IpAnonymizer::IpAnonymizer(const std::string& key)
+    : m_method(IpAnonymizationMethod::CRYPTOPAN), m_round_keys(), m_pad(), m_aesni(false)
+{
+    if (key.size() != KEY_SIZE)
+        throw std::runtime_error("Crypto-PAn key has to be " + std::to_string(KEY_SIZE) + " bytes long");
+
+#ifdef CDNS_ANONYMIZER_X86
+    __builtin_cpu_init();
+    m_aesni = __builtin_cpu_supports("aes");
+#endif
+
+    // First half of the key is AES key, second half encrypted with it is the pad
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(key.data());
+    expand_key(raw, m_round_keys);
+    encrypt(raw + 16, m_pad);
+}
+
+void CDNS::IpAnonymizer::anonymize(uint8_t* address, uint8_t size) const
+{
+    if (m_method != IpAnonymizationMethod::CRYPTOPAN || size > 16)
+        return;
+
+    uint8_t orig[16];
+    uint8_t result[16] = {};
+    std::memcpy(orig, address, size);
+
+    // Each bit of result is a function of all preceding bits of the original address
+    for (unsigned pos = 0; pos < size * 8u; pos++) {
+        unsigned full = pos / 8;
+        uint8_t mask = static_cast<uint8_t>(0xFF << (8 - pos % 8));
+        uint8_t input[16];
+        uint8_t output[16];
+
+        std::memcpy(input, orig, full);
+        input[full] = (orig[full] & mask) | (m_pad[full] & ~mask);
+        std::memcpy(input + full + 1, m_pad + full + 1, 15 - full);
+
+        encrypt(input, output);
+        result[full] |= (output[0] >> 7) << (7 - pos % 8);
+    }
+
+    for (unsigned i = 0; i < size; i++)
+        address[i] = orig[i] ^ result[i];
+}
+
+void CDNS::IpAnonymizer::encrypt(const uint8_t* in, uint8_t* out) const
+{
+#ifdef CDNS_ANONYMIZER_X86
+    if (m_aesni) {
+        encrypt_aesni(m_round_keys, in, out);
+        return;
+    }
+#endif
+
+    encrypt_soft(m_round_keys, in, out);
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace CDNS {
+
+    /**
+     * @enum IpAnonymizationMethod
+     * @brief Enumerates methods of IP address anonymization applied before addresses are stored in Block
+     */
+    enum class IpAnonymizationMethod : uint8_t {
+        PREFIX_MASK = 0, //!< Only truncate addresses to prefixes from Storage parameters
+        CRYPTOPAN //!< Prefix-preserving pseudonymization (Crypto-PAn) followed by prefix truncation
+    };
+
+    /**
+     * @brief Anonymizes IPv4 and IPv6 addresses before they are inserted into C-DNS Block
+     *
+     * Prefix truncation itself is done by CdnsBlock according to client and server address prefixes
+     * from Storage parameters. IpAnonymizer only enables this truncation for all inserted addresses
+     * and optionally pseudonymizes the addresses with Crypto-PAn before truncation. Crypto-PAn uses
+     * AES-128 accelerated by AES-NI if the CPU supports it.
+     *
+     * User should also fill `anonymization_method` in Storage parameters to describe the anonymization
+     * in the C-DNS file.
+     */
+    class IpAnonymizer {
+        public:
+        static constexpr std::size_t KEY_SIZE = 32;
+
+        /**
+         * @brief Construct a new IpAnonymizer object that only truncates addresses to prefixes
+         */
+        IpAnonymizer() : m_method(IpAnonymizationMethod::PREFIX_MASK), m_round_keys(), m_pad(), m_aesni(false) {}
+
+        /**
+         * @brief Construct a new IpAnonymizer object that pseudonymizes addresses with Crypto-PAn
+         * @param key Secret key for Crypto-PAn (32 bytes, first 16 bytes are AES key, last 16 bytes are
+         * used to generate pad)
+         * @throw std::runtime_error if the key doesn't have 32 bytes
+         */
+        explicit IpAnonymizer(const std::string& key);
+
+        /**
+         * @brief Get anonymization method of this anonymizer
+         * @return Anonymization method
+         */
+        IpAnonymizationMethod get_method() const {
+            return m_method;
+        }
+
+        /**
+         * @brief Pseudonymize raw IP address in place. Does nothing for PREFIX_MASK method.
+         * @param address Raw address bytes in network byte order
+         * @param size Size of the raw address (4 for IPv4, 16 for IPv6)
+         */
+        void anonymize(uint8_t* address, uint8_t size) const;
+
+        private:
+        /**
+         * @brief Encrypt one 16 byte block with AES-128 using expanded key
+         * @param in Plaintext block
+         * @param out Ciphertext block
+         */
+        void encrypt(const uint8_t* in, uint8_t* out) const;
+
+        IpAnonymizationMethod m_method;
+        uint8_t m_round_keys[176]; //!< Expanded AES-128 key
+        uint8_t m_pad[16]; //!< Crypto-PAn pad
+        bool m_aesni; //!< Use AES-NI instructions for encryption (always `false` on non-x86 CPUs)
+    };
+}
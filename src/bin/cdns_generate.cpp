@@ -0,0 +1,141 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <iostream>
+#include <string>
+#include <getopt.h>
+
+#include "../cdns.h"
+
+
+/**
+ * @file cdns_generate.cpp
+ * @brief Implementation of cdns-generate command line tool.
+ *
+ * cdns-generate command line tool generates C-DNS file with synthetic DNS traffic resembling traffic
+ * of a recursive resolver. The same seed always generates the same file. \n
+ * Usage: cdns-generate -o <OUTPUT_FILE> [-n <COUNT>] [-s <SEED>] [-c <CLIENTS>] [-q <NAMES>] [-r <RATE>]
+ *        [-b <BLOCK_ITEMS>] [-z <gzip|xz>] [-h] \n
+ * Options: \n
+ *      -o <OUTPUT_FILE>    : Output C-DNS file \n
+ *      -n <COUNT>          : Number of Query/Response items to generate (default 100000) \n
+ *      -s <SEED>           : Seed of the pseudorandom generator (default 42) \n
+ *      -c <CLIENTS>        : Number of distinct client addresses (default 20000) \n
+ *      -q <NAMES>          : Number of distinct query names (default 50000) \n
+ *      -r <RATE>           : Average number of queries per second (default 10000) \n
+ *      -b <BLOCK_ITEMS>    : Maximum number of items in one C-DNS block (default 10000) \n
+ *      -z <gzip|xz>        : Compress the output file \n
+ *      -h                  : Print this help message and exit \n
+ */
+
+static void print_help()
+{
+    std::cout << "cdns-generate:" << std::endl;
+    std::cout << "Generates C-DNS file with synthetic DNS traffic resembling traffic of a recursive" << std::endl;
+    std::cout << "resolver. The same seed always generates the same file." << std::endl;
+    std::cout << "Usage: cdns-generate -o <OUTPUT_FILE> [-n <COUNT>] [-s <SEED>] [-c <CLIENTS>] [-q <NAMES>]" << std::endl;
+    std::cout << "                     [-r <RATE>] [-b <BLOCK_ITEMS>] [-z <gzip|xz>] [-h]" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "\t-o <OUTPUT_FILE>    : Output C-DNS file" << std::endl;
+    std::cout << "\t-n <COUNT>          : Number of Query/Response items to generate (default 100000)" << std::endl;
+    std::cout << "\t-s <SEED>           : Seed of the pseudorandom generator (default 42)" << std::endl;
+    std::cout << "\t-c <CLIENTS>        : Number of distinct client addresses (default 20000)" << std::endl;
+    std::cout << "\t-q <NAMES>          : Number of distinct query names (default 50000)" << std::endl;
+    std::cout << "\t-r <RATE>           : Average number of queries per second (default 10000)" << std::endl;
+    std::cout << "\t-b <BLOCK_ITEMS>    : Maximum number of items in one C-DNS block (default 10000)" << std::endl;
+    std::cout << "\t-z <gzip|xz>        : Compress the output file" << std::endl;
+    std::cout << "\t-h                  : Print this help message and exit" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::string output_file;
+    uint64_t count = 100000;
+    uint64_t block_items = CDNS::DEFAULT_MAX_BLOCK_ITEMS;
+    CDNS::CborOutputCompression compression = CDNS::CborOutputCompression::NO_COMPRESSION;
+    CDNS::TrafficGeneratorConfig config;
+    int opt;
+
+    // Parse command line arguments
+    try {
+        while ((opt = getopt(argc, argv, "o:n:s:c:q:r:b:z:h")) != EOF) {
+            switch (opt) {
+                case 'o':
+                    output_file = optarg;
+                    break;
+                case 'n':
+                    count = std::stoull(optarg);
+                    break;
+                case 's':
+                    config.seed = static_cast<uint32_t>(std::stoul(optarg));
+                    break;
+                case 'c':
+                    config.clients = std::stoull(optarg);
+                    break;
+                case 'q':
+                    config.names = std::stoull(optarg);
+                    break;
+                case 'r':
+                    config.queries_per_second = std::stod(optarg);
+                    break;
+                case 'b':
+                    block_items = std::stoull(optarg);
+                    break;
+                case 'z':
+                    if (std::string(optarg) == "gzip")
+                        compression = CDNS::CborOutputCompression::GZIP;
+                    else if (std::string(optarg) == "xz")
+                        compression = CDNS::CborOutputCompression::XZ;
+                    else
+                        throw std::invalid_argument("unknown compression " + std::string(optarg));
+                    break;
+                case 'h':
+                    print_help();
+                    exit(EXIT_SUCCESS);
+                    break;
+                default:
+                    print_help();
+                    exit(EXIT_FAILURE);
+                    break;
+            }
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Invalid option value! Reason: " << e.what() << std::endl << std::endl;
+        print_help();
+        return 1;
+    }
+
+    if (optind < argc) {
+        std::cerr << "Invalid extra arguments!" << std::endl << std::endl;
+        print_help();
+        return 1;
+    }
+
+    if (output_file.empty()) {
+        std::cerr << "No output file specified!"  << std::endl << std::endl;
+        print_help();
+        return 1;
+    }
+
+    try {
+        CDNS::TrafficGenerator generator(config);
+        CDNS::FilePreamble file_preamble;
+        file_preamble.get_block_parameters(0).storage_parameters.max_block_items = block_items;
+
+        CDNS::CdnsExporter writer(file_preamble, output_file, compression);
+        generator.generate(writer, count);
+        writer.write_block();
+    }
+    catch (std::exception& e) {
+        std::cerr << "Couldn't generate file " << output_file << "! Reason: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -93,14 +93,15 @@ int main(int argc, char** argv)
         bool first = true;
 
         while (true) {
-            auto block = reader.read_block(end);
+            // Only lengths of item arrays are read, rest of the Block is skipped
+            auto block = reader.read_block_counts(end);
 
             if (end)
                 break;
 
-            qr_count += block.get_qr_count();
-            aec_count += block.get_aec_count();
-            mm_count += block.get_mm_count();
+            qr_count += block.qr_count;
+            aec_count += block.aec_count;
+            mm_count += block.mm_count;
 
             if (perblock) {
                 if (first)
@@ -110,14 +111,14 @@ int main(int argc, char** argv)
 
                 if (pretty) {
                     std::cout << "Block: " << block_count << std::endl;
-                    std::cout << "Query/Response: " << block.get_qr_count() << std::endl;
-                    std::cout << "Address Event Counts: " << block.get_aec_count() << std::endl;
-                    std::cout << "Malformed Messages: " << block.get_mm_count() << std::endl;
+                    std::cout << "Query/Response: " << block.qr_count << std::endl;
+                    std::cout << "Address Event Counts: " << block.aec_count << std::endl;
+                    std::cout << "Malformed Messages: " << block.mm_count << std::endl;
                 }
                 else {
-                    std::cout << block.get_qr_count() << std::endl;
-                    std::cout << block.get_aec_count() << std::endl;
-                    std::cout << block.get_mm_count() << std::endl;
+                    std::cout << block.qr_count << std::endl;
+                    std::cout << block.aec_count << std::endl;
+                    std::cout << block.mm_count << std::endl;
                 }
             }
 
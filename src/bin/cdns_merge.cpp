@@ -21,10 +21,17 @@
  * @brief Implementation of cdns-merge command line tool.
  *
  * cdns-merge command line tool merges multiple C-DNS files into one. Can only merge files with compatible
- * 'major.minor.private' version. \n
- * Usage: cdns-merge -o <OUTPUT_FILE> [-h] <INPUT_FILE> [<INPUT_FILE> ...] \n
+ * 'major.minor.private' version. Blocks are copied to output as they are, only their Block parameters
+ * index is rewritten. With -t option items of all input files are merged by their timestamps instead
+ * and re-packed into full Blocks. \n
+ * Usage: cdns-merge -o <OUTPUT_FILE> [-d] [-t] [-j <THREADS>] [-z <gzip|xz>] [-h] <INPUT_FILE> [<INPUT_FILE> ...] \n
  * Options: \n
  *      -o <OUTPUT_FILE>    : Output C-DNS file \n
+ *      -d                  : Decode and re-encode every Block instead of copying it \n
+ *      -t                  : Merge items of input files ordered by time and re-pack them into full
+ *                            Blocks using the first Block parameters of the first input file \n
+ *      -j <THREADS>        : Number of threads reading and decoding input files (default 0 = main thread) \n
+ *      -z <gzip|xz>        : Compress the output file in a separate thread \n
  *      -h                  : Print this help message and exit \n
  */
 
@@ -32,10 +39,19 @@ static void print_help()
 {
     std::cout << "cdns-merge:" << std::endl;
     std::cout << "Merges multiple C-DNS files into one. Can only merge files with compatible" << std::endl;
-    std::cout << "'major.minor.private' version." << std::endl;
-    std::cout << "Usage: cdns-merge -o <OUTPUT_FILE> [-h] <INPUT_FILE> [<INPUT_FILE> ...]" << std::endl;
+    std::cout << "'major.minor.private' version. Blocks are copied to output as they are, only their" << std::endl;
+    std::cout << "Block parameters index is rewritten. With -t option items of all input files are" << std::endl;
+    std::cout << "merged by their timestamps instead and re-packed into full Blocks." << std::endl;
+    std::cout << "Usage: cdns-merge -o <OUTPUT_FILE> [-d] [-t] [-j <THREADS>] [-z <gzip|xz>] [-h]" << std::endl;
+    std::cout << "                  <INPUT_FILE> [<INPUT_FILE> ...]" << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "\t-o <OUTPUT_FILE>    : Output C-DNS file" << std::endl;
+    std::cout << "\t-d                  : Decode and re-encode every Block instead of copying it" << std::endl;
+    std::cout << "\t-t                  : Merge items of input files ordered by time and re-pack them into" << std::endl;
+    std::cout << "\t                      full Blocks using the first Block parameters of the first input file" << std::endl;
+    std::cout << "\t-j <THREADS>        : Number of threads reading and decoding input files" << std::endl;
+    std::cout << "\t                      (default 0 = main thread)" << std::endl;
+    std::cout << "\t-z <gzip|xz>        : Compress the output file in a separate thread" << std::endl;
     std::cout << "\t-h                  : Print this help message and exit" << std::endl;
 }
 
@@ -43,24 +59,52 @@ int main(int argc, char** argv)
 {
     std::vector<std::string> input_files;
     std::string output_file;
+    bool decode = false;
+    bool time_ordered = false;
+    unsigned threads = 0;
+    CDNS::CborOutputCompression compression = CDNS::CborOutputCompression::NO_COMPRESSION;
     int opt;
 
     // Parse command line arguments
-    while ((opt = getopt(argc, argv, "o:h")) != EOF) {
-        switch (opt) {
-            case 'o':
-                output_file = optarg;
-                break;
-            case 'h':
-                print_help();
-                exit(EXIT_SUCCESS);
-                break;
-            default:
-                print_help();
-                exit(EXIT_FAILURE);
-                break;
+    try {
+        while ((opt = getopt(argc, argv, "o:dtj:z:h")) != EOF) {
+            switch (opt) {
+                case 'o':
+                    output_file = optarg;
+                    break;
+                case 'd':
+                    decode = true;
+                    break;
+                case 't':
+                    time_ordered = true;
+                    break;
+                case 'j':
+                    threads = static_cast<unsigned>(std::stoul(optarg));
+                    break;
+                case 'z':
+                    if (std::string(optarg) == "gzip")
+                        compression = CDNS::CborOutputCompression::GZIP;
+                    else if (std::string(optarg) == "xz")
+                        compression = CDNS::CborOutputCompression::XZ;
+                    else
+                        throw std::invalid_argument("unknown compression " + std::string(optarg));
+                    break;
+                case 'h':
+                    print_help();
+                    exit(EXIT_SUCCESS);
+                    break;
+                default:
+                    print_help();
+                    exit(EXIT_FAILURE);
+                    break;
+            }
         }
     }
+    catch (std::exception& e) {
+        std::cerr << "Invalid option value! Reason: " << e.what() << std::endl << std::endl;
+        print_help();
+        return 1;
+    }
 
     for (int i = optind; i < argc; i++) {
         input_files.push_back(argv[i]);
@@ -79,20 +123,22 @@ int main(int argc, char** argv)
     }
 
     bool first = true;
-    std::unordered_map<std::string, std::unordered_map<CDNS::index_t, CDNS::index_t>> block_indexes;
+    std::vector<std::string> valid_inputs;
+    std::vector<std::vector<CDNS::index_t>> block_indexes;
     CDNS::FilePreamble file_preamble;
 
     for (auto input: input_files) {
         try {
             std::ifstream ifs(input, std::ifstream::binary);
             CDNS::CdnsReader reader(ifs);
+            std::vector<CDNS::index_t> indexes;
 
             if (first) {
                 // Use file preamble from first input file for output
                 file_preamble = reader.m_file_preamble;
 
                 for (unsigned i = 0; i < reader.m_file_preamble.block_parameters_size(); i++) {
-                    block_indexes[input][i] = i;
+                    indexes.push_back(i);
                 }
 
                 first = false;
@@ -107,41 +153,55 @@ int main(int argc, char** argv)
                 }
 
                 // Generate new block parameters indexes for output file, because we will simply add
-                // all block parameters from all input files to output file
-                for (unsigned i = 0; i < reader.m_file_preamble.block_parameters_size(); i++) {
-                    block_indexes[input][i] = file_preamble.add_block_parameters(reader.m_file_preamble.get_block_parameters(i));
+                // all block parameters from all input files to output file. Re-packed Blocks of time
+                // ordered merge use only the first Block parameters.
+                for (unsigned i = 0; i < reader.m_file_preamble.block_parameters_size() && !time_ordered; i++) {
+                    indexes.push_back(file_preamble.add_block_parameters(reader.m_file_preamble.get_block_parameters(i)));
                 }
             }
+
+            valid_inputs.push_back(input);
+            block_indexes.push_back(indexes);
         }
         catch (std::exception& e) {
             std::cerr << "Couldn't merge file " << input << "! Reason: " << e.what() << std::endl;
         }
     }
 
-    CDNS::CdnsExporter writer(file_preamble, output_file, CDNS::CborOutputCompression::NO_COMPRESSION);
-
-    for (auto input: input_files) {
-        try {
-            std::ifstream ifs(input, std::ifstream::binary);
-            CDNS::CdnsReader reader(ifs);
-            bool end = false;
-
-            while (true) {
-                auto block = reader.read_block(end);
-
-                if (end)
-                    break;
-
-                // Assign new block parameters index for this block in output file
-                block.m_block_preamble.block_parameters_index = block_indexes[input][block.get_block_parameters_index()];
+    try {
+        // Compressed output is compressed and written in a separate thread, the queue never drops Blocks
+        std::unique_ptr<CDNS::CdnsExporter> writer;
+        if (compression != CDNS::CborOutputCompression::NO_COMPRESSION)
+            writer.reset(new CDNS::CdnsExporter(file_preamble, output_file, compression, CDNS::OutputQueueParameters()));
+        else
+            writer.reset(new CDNS::CdnsExporter(file_preamble, output_file, compression));
+
+        // All input files are opened at once, so that worker threads can read them ahead
+        std::vector<std::unique_ptr<std::ifstream>> streams;
+        std::vector<std::unique_ptr<CDNS::CdnsReader>> readers;
+        CDNS::CdnsMerger merger(threads);
+        merger.set_error_callback([&valid_inputs](std::size_t input, const std::exception& e) {
+            std::cerr << "Couldn't merge file " << valid_inputs[input] << "! Reason: " << e.what() << std::endl;
+        });
+
+        for (std::size_t i = 0; i < valid_inputs.size(); i++) {
+            streams.emplace_back(new std::ifstream(valid_inputs[i], std::ifstream::binary));
+            readers.emplace_back(new CDNS::CdnsReader(*streams.back()));
+            merger.add_input(*readers.back(), block_indexes[i]);
+        }
 
-                writer.write_block(block);
-            }
+        if (time_ordered) {
+            merger.merge_time_ordered(*writer);
+            writer->write_block();
         }
-        catch (std::exception& e) {
-            std::cerr << "Couldn't merge file " << input << "! Reason: " << e.what() << std::endl;
+        else {
+            merger.merge_blocks(*writer, decode);
         }
     }
+    catch (std::exception& e) {
+        std::cerr << "Couldn't merge files! Reason: " << e.what() << std::endl;
+        return 1;
+    }
 
     return 0;
-}
+}
\ No newline at end of file
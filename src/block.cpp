@@ -9,10 +9,25 @@
 #include <sstream>
 #include <bitset>
 #include <type_traits>
+#include <algorithm>
+#include <streambuf>
 
 #include "block.h"
 #include "cdns_encoder.h"
 #include "interface.h"
+#include "query_response_builder.h"
+
+namespace {
+    /**
+     * @brief Read-only stream buffer over existing string, avoids copying the string into std::istringstream
+     */
+    class MemoryStreamBuffer : public std::streambuf {
+        public:
+        explicit MemoryStreamBuffer(std::string& data) {
+            setg(&data[0], &data[0], &data[0] + data.size());
+        }
+    };
+}
 
 std::string CDNS::ClassType::string()
 {
@@ -888,13 +903,16 @@ std::string CDNS::BlockStatistics::string()
     if (malformed_items)
         ss << "Malformed items: " << std::to_string(malformed_items.value()) << std::endl;
 
+    if (dropped_items)
+        ss << "Dropped items: " << std::to_string(dropped_items.value()) << std::endl;
+
     return ss.str();
 }
 
 std::size_t CDNS::BlockStatistics::write(CdnsEncoder& enc)
 {
     std::size_t fields = !!processed_messages + !!qr_data_items + !!unmatched_queries + !!unmatched_responses
-                         + !!discarded_opcode + !!malformed_items;
+                         + !!discarded_opcode + !!malformed_items + !!dropped_items;
 
     if (fields == 0)
         return 0;
@@ -940,6 +958,12 @@ std::size_t CDNS::BlockStatistics::write(CdnsEncoder& enc)
         written += enc.write(malformed_items.value());
     }
 
+    // Write Dropped items
+    if (dropped_items) {
+        written += enc.write(get_map_index(CDNS::BlockStatisticsMapIndex::dropped_items));
+        written += enc.write(dropped_items.value());
+    }
+
     return written;
 }
 
@@ -974,6 +998,9 @@ void CDNS::BlockStatistics::read(CdnsDecoder& dec)
             case get_map_index(BlockStatisticsMapIndex::malformed_items):
                 malformed_items = dec.read_unsigned();
                 break;
+            case get_map_index(BlockStatisticsMapIndex::dropped_items):
+                dropped_items = dec.read_unsigned();
+                break;
             default:
                 dec.skip_item();
                 break;
@@ -991,6 +1018,7 @@ void CDNS::BlockStatistics::reset()
     unmatched_responses = boost::none;
     discarded_opcode = boost::none;
     malformed_items = boost::none;
+    dropped_items = boost::none;
 }
 
 std::string CDNS::QueryResponse::string()
@@ -1564,6 +1592,51 @@ void CDNS::IndexListItem::reset()
     list.clear();
 }
 
+CDNS::index_t CDNS::CdnsBlock::add_ip_address(const uint8_t* address, uint8_t size, bool client)
+{
+    StorageParameters& sp = m_block_parameters.storage_parameters;
+    boost::optional<uint8_t> prefix;
+
+    if (size == sizeof(in_addr))
+        prefix = client ? sp.client_address_prefix_ipv4 : sp.server_address_prefix_ipv4;
+    else if (size == sizeof(in6_addr))
+        prefix = client ? sp.client_address_prefix_ipv6 : sp.server_address_prefix_ipv6;
+    else
+        throw std::runtime_error("Invalid size of raw IP address: " + std::to_string(size));
+
+    uint8_t prefix_len = prefix ? prefix.value() : size * 8;
+    bool pseudonymize = m_anonymizer && m_anonymizer->get_method() != IpAnonymizationMethod::PREFIX_MASK;
+
+    // Pseudonymized addresses have to be looked up by whole original address
+    IpAddressKey key(address, size, prefix_len, !pseudonymize);
+    auto found = m_ip_address_keys.find(key);
+    if (found != m_ip_address_keys.end()) {
+        if (found->second.generation == m_generation) {
+            m_ip_address_key_hits++;
+            return found->second.index;
+        }
+
+        // Address cached from previous Block doesn't have to be anonymized again
+        const IpAddressKey& stored = found->second.stored;
+        found->second.index = add_ip_address(reinterpret_cast<const char*>(stored.addr), stored.length);
+        found->second.generation = m_generation;
+        return found->second.index;
+    }
+
+    IpAddressKey stored = key;
+    if (pseudonymize) {
+        uint8_t anonymized[16];
+        std::memcpy(anonymized, address, size);
+        m_anonymizer->anonymize(anonymized, size);
+        stored = IpAddressKey(anonymized, size, prefix_len);
+    }
+
+    // New address might have already been inserted as string
+    index_t ret = add_ip_address(reinterpret_cast<const char*>(stored.addr), stored.length);
+    m_ip_address_keys.emplace(key, IpAddressSlot{ret, m_generation, stored});
+    return ret;
+}
+
 std::string CDNS::CdnsBlock::string()
 {
     std::stringstream ss;
@@ -1603,82 +1676,55 @@ std::size_t CDNS::CdnsBlock::write_blocktables(CdnsEncoder& enc, std::size_t& fi
     // Write IP addresses
     if (!!m_ip_address.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::ip_address));
-        written += enc.write_array_start(m_ip_address.size());
-        for (auto& ip : m_ip_address) {
-            written += ip.write(enc);
-        }
+        written += m_ip_address.write(enc);
     }
 
     // Write Classtype
     if (!!m_classtype.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::classtype));
-        written += enc.write_array_start(m_classtype.size());
-        for (auto& classtype : m_classtype) {
-            written += classtype.write(enc);
-        }
+        written += m_classtype.write(enc);
     }
 
     // Write Name_RDATA
     if (!!m_name_rdata.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::name_rdata));
-        written += enc.write_array_start(m_name_rdata.size());
-        for (auto& name_rdata : m_name_rdata) {
-            written += name_rdata.write(enc);
-        }
+        written += m_name_rdata.write(enc);
     }
 
     // Write QR Signature
     if (!!m_qr_sig.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::qr_sig));
-        written += enc.write_array_start(m_qr_sig.size());
-        for (auto& qr_sig : m_qr_sig) {
-            written += qr_sig.write(enc);
-        }
+        written += m_qr_sig.write(enc);
     }
 
     // Write Question list
     if (!!m_qlist.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::qlist));
-        written += enc.write_array_start(m_qlist.size());
-        for (auto& qlist : m_qlist) {
-            written += qlist.write(enc);
-        }
+        written += m_qlist.write(enc);
     }
 
     // Write Question RRs
     if (!!m_qrr.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::qrr));
-        written += enc.write_array_start(m_qrr.size());
-        for (auto& qrr : m_qrr) {
-            written += qrr.write(enc);
-        }
+        written += m_qrr.write(enc);
     }
 
     // Write RR list
     if (!!m_rrlist.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::rrlist));
-        written += enc.write_array_start(m_rrlist.size());
-        for (auto& rrlist : m_rrlist) {
-            written += rrlist.write(enc);
-        }
+        written += m_rrlist.write(enc);
     }
 
     // Write Resource records
     if (!!m_rr.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::rr));
-        written += enc.write_array_start(m_rr.size());
-        for (auto& rr : m_rr) {
-            written += rr.write(enc);
-        }
+        written += m_rr.write(enc);
     }
 
     // Write Malformed messsage data
     if (!!m_malformed_message_data.size()) {
         written += enc.write(get_map_index(CDNS::BlockTablesMapIndex::malformed_message_data));
-        written += enc.write_array_start(m_malformed_message_data.size());
-        for (auto& mmd : m_malformed_message_data) {
-            written += mmd.write(enc);
-        }
+        written += m_malformed_message_data.write(enc);
     }
 
     return written;
@@ -1779,322 +1825,161 @@ CDNS::index_t CDNS::CdnsBlock::add_generic_rrlist(const std::vector<GenericResou
 bool CDNS::CdnsBlock::add_question_response_record(const GenericQueryResponse& gr,
                                                    const boost::optional<BlockStatistics>& stats)
 {
-    uint32_t qr_hints = m_block_parameters.storage_parameters.storage_hints.query_response_hints;
-    uint32_t qr_sig_hints = m_block_parameters.storage_parameters.storage_hints.query_response_signature_hints;
-
-    // Check if it'll be the first record in the block and set earliest time if yes
-    if (gr.ts && ((m_query_responses.size() == 0 && m_malformed_messages.size() == 0) ||
-                  (*gr.ts < m_block_preamble.earliest_time)))
-        m_block_preamble.earliest_time = *gr.ts;
-
-    /**
-     * Fill Query Response
-     */
-
-    QueryResponse qr;
-    bool qr_filled = false;
-
-    // Time offset
-    if ((qr_hints & QueryResponseHintsMask::time_offset) && gr.ts) {
-        qr.time_offset = *gr.ts;
-        qr_filled = true;
-    }
-
-    // Client IP address
-    if ((qr_hints & QueryResponseHintsMask::client_address_index) && gr.client_ip) {
-        qr.client_address_index = add_ip_address(*gr.client_ip);
-        qr_filled = true;
-    }
-
-    // Client port
-    if ((qr_hints & QueryResponseHintsMask::client_port) && gr.client_port) {
-        qr.client_port = *gr.client_port;
-        qr_filled = true;
-    }
-
-    // DNS transaction ID
-    if ((qr_hints & QueryResponseHintsMask::transaction_id) && gr.transaction_id) {
-        qr.transaction_id = *gr.transaction_id;
-        qr_filled = true;
-    }
-
-    // Fill Query Response Signature
-    if (qr_hints & QueryResponseHintsMask::qr_signature_index) {
-        QueryResponseSignature qrs;
-        bool qrs_filled = false;
-
-        // Server IP address
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::server_address_index) && gr.server_ip) {
-            qrs.server_address_index = add_ip_address(*gr.server_ip);
-            qrs_filled = true;
-        }
-
-        // Server port
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::server_port) && gr.server_port) {
-            qrs.server_port = *gr.server_port;
-            qrs_filled = true;
-        }
-
-        // Transport flags (IP version, transport protocol, trailing data)
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::qr_transport_flags) && gr.qr_transport_flags) {
-            qrs.qr_transport_flags = *gr.qr_transport_flags;
-            qrs_filled = true;
-        }
-
-        // Query type (stub, resolver, etc.)
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::qr_type) && gr.qr_type) {
-            qrs.qr_type = *gr.qr_type;
-            qrs_filled = true;
-        }
-
-        // QR Signature flags (is query, is response, etc.)
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::qr_sig_flags) && gr.qr_sig_flags) {
-            qrs.qr_sig_flags = *gr.qr_sig_flags;
-            qrs_filled = true;
-        }
-
-        // Query OpCode
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_opcode) && gr.query_opcode) {
-            qrs.query_opcode = *gr.query_opcode;
-            qrs_filled = true;
-        }
-
-        // DNS header flags
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::qr_dns_flags) && gr.qr_dns_flags) {
-            qrs.qr_dns_flags = *gr.qr_dns_flags;
-            qrs_filled = true;
-        }
-
-        // Query RCode
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_rcode) && gr.query_rcode) {
-            qrs.query_rcode = *gr.query_rcode;
-            qrs_filled = true;
-        }
-
-        // Query question type and class
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_classtype_index) && gr.query_classtype) {
-            qrs.query_classtype_index = add_classtype(*gr.query_classtype);
-            qrs_filled = true;
-        }
-
-        // Query question count
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_qdcount) && gr.query_qdcount) {
-            qrs.query_qdcount = *gr.query_qdcount;
-            qrs_filled = true;
-        }
-
-        // Query answer count
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_ancount) && gr.query_ancount) {
-            qrs.query_ancount = *gr.query_ancount;
-            qrs_filled = true;
-        }
-
-        // Query authority records count
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_nscount) && gr.query_nscount) {
-            qrs.query_nscount = *gr.query_nscount;
-            qrs_filled = true;
-        }
-
-        // Query additional records count
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_arcount) && gr.query_arcount) {
-            qrs.query_arcount = *gr.query_arcount;
-            qrs_filled = true;
-        }
-
-        // EDNS version
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_edns_version) && gr.query_edns_version) {
-            qrs.query_edns_version = *gr.query_edns_version;
-            qrs_filled = true;
-        }
-
-        // EDNS UDP size
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_udp_size) && gr.query_udp_size) {
-            qrs.query_udp_size = *gr.query_udp_size;
-            qrs_filled = true;
-        }
-
-        // EDNS record's rdata
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::query_opt_rdata_index) && gr.query_opt_rdata) {
-            qrs.query_opt_rdata_index = add_name_rdata(*gr.query_opt_rdata);
-            qrs_filled = true;
-        }
-
-        // Response RCode
-        if ((qr_sig_hints & QueryResponseSignatureHintsMask::response_rcode) && gr.response_rcode) {
-            qrs.response_rcode = *gr.response_rcode;
-            qrs_filled = true;
-        }
-
-        // Add Query Response Signature to Block table
-        if (qrs_filled) {
-            qr.qr_signature_index = add_qr_signature(qrs);
-            qr_filled = true;
-        }
-    }
-
-    // Client hoplimit (TTL)
-    if ((qr_hints & QueryResponseHintsMask::client_hoplimit) && gr.client_hoplimit) {
-        qr.client_hoplimit = *gr.client_hoplimit;
-        qr_filled = true;
-    }
-
-    // Response delay
-    if ((qr_hints & QueryResponseHintsMask::response_delay) && gr.response_delay) {
-        qr.response_delay = *gr.response_delay;
-        qr_filled = true;
-    }
-
-    // Question name
-    if ((qr_hints & QueryResponseHintsMask::query_name_index) && gr.query_name) {
-        qr.query_name_index = add_name_rdata(*gr.query_name);
-        qr_filled = true;
-    }
-
-    // Query DNS size
-    if ((qr_hints & QueryResponseHintsMask::query_size) && gr.query_size) {
-        qr.query_size = *gr.query_size;
-        qr_filled = true;
-    }
-
-    // Response DNS size
-    if ((qr_hints & QueryResponseHintsMask::response_size) && gr.response_size) {
-        qr.response_size = *gr.response_size;
-        qr_filled = true;
-    }
-
-    // Fill Response Processing Data
-    if (qr_hints & QueryResponseHintsMask::response_processing_data) {
-        ResponseProcessingData rpd;
-        bool rpd_filled = false;
-
-        // Response Bailiwick
-        if (gr.bailiwick) {
-            rpd.bailiwick_index = add_name_rdata(*gr.bailiwick);
-            rpd_filled = true;
-        }
-
-        // Response processing flags (Is response from cache?)
-        if (gr.processing_flags) {
-            rpd.processing_flags = *gr.processing_flags;
-            rpd_filled = true;
-        }
-
-        if (rpd_filled) {
-            qr.response_processing_data = rpd;
-            qr_filled = true;
-        }
-    }
-
-    // Fill Query Extended
-    QueryResponseExtended qe;
-    bool qe_filled = false;
-
-    if ((qr_hints & QueryResponseHintsMask::query_question_sections) && gr.query_questions
-        && (gr.query_questions->size() > 0)) {
-        qe.question_index = add_generic_qlist(*gr.query_questions);
-        qe_filled = true;
-    }
-
-    if ((qr_hints & QueryResponseHintsMask::query_answer_sections) && gr.query_answers
-        && (gr.query_answers->size() > 0)) {
-        qe.answer_index = add_generic_rrlist(*gr.query_answers);
-        qe_filled = true;
-    }
-
-    if ((qr_hints & QueryResponseHintsMask::query_authority_sections) && gr.query_authority
-        && (gr.query_authority->size() > 0)) {
-        qe.authority_index = add_generic_rrlist(*gr.query_authority);
-        qe_filled = true;
-    }
-
-    if ((qr_hints & QueryResponseHintsMask::query_additional_sections) && gr.query_additional
-        && (gr.query_additional->size() > 0)) {
-        qe.additional_index = add_generic_rrlist(*gr.query_additional);
-        qe_filled = true;
-    }
-
-    if (qe_filled) {
-        qr.query_extended = qe;
-        qr_filled = true;
-    }
-
-    // Fill Response Extended
-    QueryResponseExtended re;
-    bool re_filled = false;
-
-    if ((qr_hints & QueryResponseHintsMask::query_question_sections) && gr.response_questions
-        && (gr.response_questions->size() > 0)) {
-        re.question_index = add_generic_qlist(*gr.response_questions);
-        re_filled = true;
-    }
-
-    if ((qr_hints & QueryResponseHintsMask::response_answer_sections) && gr.response_answers
-        && (gr.response_answers->size() > 0)) {
-        re.answer_index = add_generic_rrlist(*gr.response_answers);
-        re_filled = true;
-    }
-
-    if ((qr_hints & QueryResponseHintsMask::response_authority_sections) && gr.response_authority
-        && (gr.response_authority->size() > 0)) {
-        re.authority_index = add_generic_rrlist(*gr.response_authority);
-        re_filled = true;
-    }
-
-    if ((qr_hints & QueryResponseHintsMask::response_additional_sections) && gr.response_additional
-        && (gr.response_additional->size() > 0)) {
-        re.additional_index = add_generic_rrlist(*gr.response_additional);
-        re_filled = true;
-    }
-
-    if (re_filled) {
-        qr.response_extended = re;
-        qr_filled = true;
-    }
-
-    // Fill implementation specific fields
-
-    // ASN
-    if (gr.asn) {
-        qr.asn = *gr.asn;
-        qr_filled = true;
-    }
-
-    // Country Code
-    if (gr.country_code) {
-        qr.country_code = *gr.country_code;
-        qr_filled = true;
-    }
-
-    // TCP Round Trip Time
-    if (gr.round_trip_time) {
-        qr.round_trip_time = *gr.round_trip_time;
-        qr_filled = true;
-    }
-
-    // User ID
-    if (gr.user_id) {
-        qr.user_id = *gr.user_id;
-        qr_filled = true;
-    }
-
-    // Policy action
-    if (gr.policy_action) {
-        qr.policy_action = *gr.policy_action;
-        qr_filled = true;
-    }
-
-    // Policy rule
-    if (gr.policy_rule) {
-        qr.policy_rule = *gr.policy_rule;
-        qr_filled = true;
+    QueryResponseBuilder builder(*this);
+
+    // Items are set in the order in which they were always inserted into Block tables
+    if (gr.ts)
+        builder.timestamp(*gr.ts);
+    if (gr.client_ip)
+        builder.client_address(gr.client_ip->data(), gr.client_ip->size());
+    if (gr.client_port)
+        builder.client_port(*gr.client_port);
+    if (gr.transaction_id)
+        builder.transaction_id(*gr.transaction_id);
+
+    // Query Response Signature
+    if (gr.server_ip)
+        builder.server_address(gr.server_ip->data(), gr.server_ip->size());
+    if (gr.server_port)
+        builder.server_port(*gr.server_port);
+    if (gr.qr_transport_flags)
+        builder.transport_flags(*gr.qr_transport_flags);
+    if (gr.qr_type)
+        builder.qr_type(*gr.qr_type);
+    if (gr.qr_sig_flags)
+        builder.qr_sig_flags(*gr.qr_sig_flags);
+    if (gr.query_opcode)
+        builder.query_opcode(*gr.query_opcode);
+    if (gr.qr_dns_flags)
+        builder.dns_flags(*gr.qr_dns_flags);
+    if (gr.query_rcode)
+        builder.query_rcode(*gr.query_rcode);
+    if (gr.query_classtype)
+        builder.query_classtype(*gr.query_classtype);
+    if (gr.query_qdcount)
+        builder.query_qdcount(*gr.query_qdcount);
+    if (gr.query_ancount)
+        builder.query_ancount(*gr.query_ancount);
+    if (gr.query_nscount)
+        builder.query_nscount(*gr.query_nscount);
+    if (gr.query_arcount)
+        builder.query_arcount(*gr.query_arcount);
+    if (gr.query_edns_version)
+        builder.query_edns_version(*gr.query_edns_version);
+    if (gr.query_udp_size)
+        builder.query_udp_size(*gr.query_udp_size);
+    if (gr.query_opt_rdata)
+        builder.query_opt_rdata(gr.query_opt_rdata->data(), gr.query_opt_rdata->size());
+    if (gr.response_rcode)
+        builder.response_rcode(*gr.response_rcode);
+
+    if (gr.client_hoplimit)
+        builder.client_hoplimit(*gr.client_hoplimit);
+    if (gr.response_delay)
+        builder.response_delay(*gr.response_delay);
+    if (gr.query_name)
+        builder.query_name(gr.query_name->data(), gr.query_name->size());
+    if (gr.query_size)
+        builder.query_size(*gr.query_size);
+    if (gr.response_size)
+        builder.response_size(*gr.response_size);
+
+    // Response Processing Data
+    if (gr.bailiwick)
+        builder.bailiwick(gr.bailiwick->data(), gr.bailiwick->size());
+    if (gr.processing_flags)
+        builder.processing_flags(*gr.processing_flags);
+
+    // Query and Response extended information
+    const boost::optional<std::vector<GenericResourceRecord>>* sections[] = {
+        &gr.query_questions, &gr.query_answers, &gr.query_authority, &gr.query_additional,
+        &gr.response_questions, &gr.response_answers, &gr.response_authority, &gr.response_additional
+    };
+
+    for (std::size_t i = 0; i < QueryResponseBuilder::SECTION_COUNT; i++) {
+        if (!*sections[i])
+            continue;
+
+        for (auto& grr : **sections[i]) {
+            builder.add_record(static_cast<QueryResponseSection>(i), grr.name.data(), grr.name.size(),
+                               grr.classtype, grr.ttl, grr.rdata ? grr.rdata->data() : nullptr,
+                               grr.rdata ? grr.rdata->size() : 0);
+        }
+    }
+
+    // Implementation specific fields
+    if (gr.asn)
+        builder.asn(gr.asn->data(), gr.asn->size());
+    if (gr.country_code)
+        builder.country_code(gr.country_code->data(), gr.country_code->size());
+    if (gr.round_trip_time)
+        builder.round_trip_time(*gr.round_trip_time);
+    if (gr.user_id)
+        builder.user_id(gr.user_id->data(), gr.user_id->size());
+    if (gr.policy_action)
+        builder.policy_action(*gr.policy_action);
+    if (gr.policy_rule)
+        builder.policy_rule(gr.policy_rule->data(), gr.policy_rule->size());
+
+    return builder.finish(stats);
+}
+
+bool CDNS::CdnsBlock::add_wire_query_response(const WireQueryResponse& wqr,
+                                              const boost::optional<BlockStatistics>& stats)
+{
+    QueryResponseBuilder builder(*this);
+
+    if (wqr.ts)
+        builder.timestamp(*wqr.ts);
+    if (wqr.client_ip)
+        builder.client_address(wqr.client_ip, wqr.client_ip_size);
+    if (wqr.client_port)
+        builder.client_port(*wqr.client_port);
+    if (wqr.server_ip)
+        builder.server_address(wqr.server_ip, wqr.server_ip_size);
+    if (wqr.server_port)
+        builder.server_port(*wqr.server_port);
+    if (wqr.qr_transport_flags)
+        builder.transport_flags(*wqr.qr_transport_flags);
+    if (wqr.qr_type)
+        builder.qr_type(*wqr.qr_type);
+    if (wqr.client_hoplimit)
+        builder.client_hoplimit(*wqr.client_hoplimit);
+    if (wqr.response_delay)
+        builder.response_delay(*wqr.response_delay);
+
+    bool query_valid = wqr.query && builder.query_wire(wqr.query, wqr.query_size);
+    bool response_valid = wqr.response && builder.response_wire(wqr.response, wqr.response_size);
+
+    if (query_valid || response_valid)
+        builder.finish();
+    else
+        builder.reset();
+
+    // Store malformed DNS messages
+    const uint8_t* malformed[] = {
+        wqr.query && !query_valid ? wqr.query : nullptr,
+        wqr.response && !response_valid ? wqr.response : nullptr
+    };
+    const std::size_t malformed_size[] = { wqr.query_size, wqr.response_size };
+
+    for (unsigned i = 0; i < 2; i++) {
+        if (!malformed[i])
+            continue;
+
+        GenericMalformedMessage gmm;
+        gmm.ts = wqr.ts;
+        if (wqr.client_ip)
+            gmm.client_ip = std::string(wqr.client_ip, wqr.client_ip_size);
+        gmm.client_port = wqr.client_port;
+        if (wqr.server_ip)
+            gmm.server_ip = std::string(wqr.server_ip, wqr.server_ip_size);
+        gmm.server_port = wqr.server_port;
+        gmm.mm_transport_flags = wqr.qr_transport_flags;
+        gmm.mm_payload = std::string(reinterpret_cast<const char*>(malformed[i]), malformed_size[i]);
+        add_malformed_message(gmm);
     }
 
-    /**
-     * Add Query Response to the Block
-     */
-    if (qr_filled)
-        m_query_responses.push_back(qr);
-
     // Update block statistics
     if (stats)
         m_block_statistics = stats;
@@ -2153,16 +2038,17 @@ bool CDNS::CdnsBlock::add_address_event_count(const GenericAddressEventCount& ga
         aec.ae_transport_flags = *gaec.ae_transport_flags;
 
     // IP address
-    aec.ae_address_index = add_ip_address(gaec.ip_address);
+    aec.ae_address_index = add_generic_ip_address(gaec.ip_address, true);
 
     /*
-     * Count Address Event to the Block
+     * Count Address Event to the Block (Address Event Count of 0 is counted as a single event)
      */
+    uint64_t count = gaec.ae_count ? gaec.ae_count : 1;
     auto found = m_address_event_counts.find(aec);
     if (found != m_address_event_counts.end())
-        found->second++;
+        found->second += count;
     else
-        m_address_event_counts[aec] = 1;
+        m_address_event_counts[aec] = count;
 
     // Update block statistics
     if (stats)
@@ -2217,7 +2103,7 @@ bool CDNS::CdnsBlock::add_malformed_message(const GenericMalformedMessage& gmm,
 
     // Client IP address
     if (gmm.client_ip) {
-        mm.client_address_index = add_ip_address(*gmm.client_ip);
+        mm.client_address_index = add_generic_ip_address(*gmm.client_ip, true);
         mm_filled = true;
     }
 
@@ -2233,7 +2119,7 @@ bool CDNS::CdnsBlock::add_malformed_message(const GenericMalformedMessage& gmm,
 
     // Server address
     if (gmm.server_ip) {
-        mmd.server_address_index = add_ip_address(*gmm.server_ip);
+        mmd.server_address_index = add_generic_ip_address(*gmm.server_ip, false);
         mmd_filled = true;
     }
 
@@ -2380,6 +2266,56 @@ void CDNS::CdnsBlockRead::read_blocktables(CdnsDecoder& dec)
     }
 }
 
+CDNS::CdnsBlockRead::FilterIndexes CDNS::CdnsBlockRead::find_filter_indexes(std::string& raw_tables,
+                                                                            const ItemFilter& filter)
+{
+    FilterIndexes indexes;
+    MemoryStreamBuffer buffer(raw_tables);
+    std::istream input(&buffer);
+    CdnsDecoder dec(input);
+
+    bool indef = false;
+    uint64_t length = dec.read_map_start(indef);
+
+    // Only tables with filtered values are decoded, their items are compared without storing them
+    auto find_index = [&dec](const std::string& value, boost::optional<index_t>& index) {
+        index_t i = 0;
+        dec.read_array([&value, &index, &i](CdnsDecoder& dec){
+            std::string item = dec.read_bytestring();
+            if (!index && item == value)
+                index = i;
+            i++;
+        });
+    };
+
+    while (length > 0 || indef) {
+        if (indef && dec.peek_type() == CborType::BREAK)
+            break;
+
+        switch (dec.read_integer()) {
+            case get_map_index(BlockTablesMapIndex::ip_address):
+                if (filter.client_ip)
+                    find_index(*filter.client_ip, indexes.client_ip);
+                else
+                    dec.skip_item();
+                break;
+            case get_map_index(BlockTablesMapIndex::name_rdata):
+                if (filter.query_name)
+                    find_index(*filter.query_name, indexes.query_name);
+                else
+                    dec.skip_item();
+                break;
+            default:
+                dec.skip_item();
+                break;
+        }
+
+        length--;
+    }
+
+    return indexes;
+}
+
 std::vector<CDNS::GenericResourceRecord> CDNS::CdnsBlockRead::fill_generic_q_list(std::vector<index_t>& list)
 {
     std::vector<GenericResourceRecord> gq_list;
@@ -2417,6 +2353,18 @@ std::vector<CDNS::GenericResourceRecord> CDNS::CdnsBlockRead::fill_generic_rr_li
 }
 
 void CDNS::CdnsBlockRead::read(CdnsDecoder& dec, std::vector<BlockParameters>& block_parameters)
+{
+    read_items(dec, block_parameters, nullptr);
+}
+
+bool CDNS::CdnsBlockRead::read(CdnsDecoder& dec, std::vector<BlockParameters>& block_parameters,
+                               const ItemFilter& filter)
+{
+    return read_items(dec, block_parameters, &filter);
+}
+
+bool CDNS::CdnsBlockRead::read_items(CdnsDecoder& dec, std::vector<BlockParameters>& block_parameters,
+                                     const ItemFilter* filter)
 {
     if (block_parameters.empty())
         throw CdnsDecoderException("Given Block parameters array is empty!");
@@ -2426,35 +2374,125 @@ void CDNS::CdnsBlockRead::read(CdnsDecoder& dec, std::vector<BlockParameters>& b
     bool indef = false;
     uint64_t length = dec.read_map_start(indef);
 
+    // Time offsets of the time range relative to Block's earliest time, known once Block preamble is read
+    bool time_filter = filter && filter->time_range;
+    bool range_known = false;
+    int64_t range_start = 0;
+    int64_t range_end = 0;
+    auto set_range_offsets = [this, filter, &range_start, &range_end]() {
+        uint64_t ticks = m_block_parameters.storage_parameters.ticks_per_second;
+        range_start = filter->time_range->start.get_time_offset(m_block_preamble.earliest_time, ticks);
+        range_end = filter->time_range->end.get_time_offset(m_block_preamble.earliest_time, ticks);
+    };
+
+    // Block table indexes of filtered values, known once Block tables are read
+    bool table_filter = filter && (filter->query_name || filter->client_ip);
+    bool indexes_known = false;
+    FilterIndexes indexes;
+
+    auto matches = [&](const boost::optional<Timestamp>& time_offset, const CompactOptional<index_t>& client_address_index,
+                       const CompactOptional<index_t>& query_name_index) {
+        if (time_filter && !(time_offset && static_cast<int64_t>(time_offset->m_secs) >= range_start &&
+                             static_cast<int64_t>(time_offset->m_secs) < range_end))
+            return false;
+
+        if (filter && filter->client_ip && !(client_address_index && indexes.client_ip &&
+                                             *client_address_index == *indexes.client_ip))
+            return false;
+
+        if (filter && filter->query_name && !(query_name_index && indexes.query_name &&
+                                              *query_name_index == *indexes.query_name))
+            return false;
+
+        return true;
+    };
+    auto qr_matches = [&matches](const QueryResponse& qr) {
+        return matches(qr.time_offset, qr.client_address_index, qr.query_name_index);
+    };
+    auto mm_matches = [&matches](const MalformedMessage& mm) {
+        // Malformed messages have no query name
+        return matches(mm.time_offset, mm.client_address_index, CompactOptional<index_t>());
+    };
+
+    // Block is skipped if it can't contain any item matching the filter
+    bool pruned = false;
+
+    // Block tables are kept raw until an item matching the filter is found
+    std::string raw_tables;
+    bool has_raw_tables = false;
+
+    auto read_block_preamble = [&]() {
+        m_block_preamble.read(dec);
+        if (m_block_preamble.block_parameters_index) {
+            if (*m_block_preamble.block_parameters_index < block_parameters.size())
+                m_block_parameters = block_parameters[*m_block_preamble.block_parameters_index];
+            else
+                throw CdnsDecoderException("Block parameters index for C-DNS block is too high");
+        }
+        else {
+            m_block_parameters = block_parameters[0];
+        }
+        is_m_block_preamble = true;
+
+        if (time_filter) {
+            set_range_offsets();
+            range_known = true;
+            if (range_end <= 0)
+                pruned = true;
+        }
+    };
+
     while (length > 0 || indef) {
         if (indef && dec.peek_type() == CborType::BREAK) {
             dec.read_break();
             break;
         }
 
+        // Block preamble is mandatory even in pruned Block and it can follow the pruning item
+        if (pruned) {
+            if (dec.read_integer() == get_map_index(BlockMapIndex::block_preamble))
+                read_block_preamble();
+            else
+                dec.skip_item();
+            length--;
+            continue;
+        }
+
+        // Filter is applied to items as they're read if everything needed for it is already known
+        bool filter_known = filter && (!time_filter || range_known) && (!table_filter || indexes_known);
+
         switch (dec.read_integer()) {
             case get_map_index(BlockMapIndex::block_preamble):
-                m_block_preamble.read(dec);
-                if (m_block_preamble.block_parameters_index) {
-                    if (*m_block_preamble.block_parameters_index < block_parameters.size())
-                        m_block_parameters = block_parameters[*m_block_preamble.block_parameters_index];
-                    else
-                        throw CdnsDecoderException("Block parameters index for C-DNS block is too high");
-                }
-                is_m_block_preamble = true;
+                read_block_preamble();
                 break;
             case get_map_index(BlockMapIndex::block_statistics):
                 m_block_statistics = BlockStatistics();
                 m_block_statistics->read(dec);
                 break;
             case get_map_index(BlockMapIndex::block_tables):
-                read_blocktables(dec);
+                if (filter) {
+                    dec.start_capture(raw_tables);
+                    dec.skip_item();
+                    dec.stop_capture();
+                    has_raw_tables = true;
+
+                    if (table_filter) {
+                        indexes = find_filter_indexes(raw_tables, *filter);
+                        indexes_known = true;
+                        pruned = (filter->client_ip && !indexes.client_ip) ||
+                                 (filter->query_name && !indexes.query_name);
+                    }
+                }
+                else {
+                    read_blocktables(dec);
+                }
                 break;
             case get_map_index(BlockMapIndex::query_responses):
-                dec.read_array([this](CdnsDecoder& dec){
+                dec.read_array([this, filter_known, &qr_matches](CdnsDecoder& dec){
                     QueryResponse tmp;
                     tmp.read(dec);
-                    m_query_responses.push_back(std::move(tmp));
+                    if (!filter_known || qr_matches(tmp))
+                        m_query_responses.push_back(std::move(tmp));
                 });
                 break;
             case get_map_index(BlockMapIndex::address_event_counts):
@@ -2465,10 +2503,11 @@ void CDNS::CdnsBlockRead::read(CdnsDecoder& dec, std::vector<BlockParameters>& b
                 });
                 break;
             case get_map_index(BlockMapIndex::malformed_messages):
-                dec.read_array([this](CdnsDecoder& dec){
+                dec.read_array([this, filter_known, &mm_matches](CdnsDecoder& dec){
                     MalformedMessage tmp;
                     tmp.read(dec);
-                    m_malformed_messages.push_back(std::move(tmp));
+                    if (!filter_known || mm_matches(tmp))
+                        m_malformed_messages.push_back(std::move(tmp));
                 });
                 break;
             default:
@@ -2482,8 +2521,32 @@ void CDNS::CdnsBlockRead::read(CdnsDecoder& dec, std::vector<BlockParameters>& b
     if (!is_m_block_preamble)
         throw CdnsDecoderException("CdnsBlock from input stream missing one of mandatory items");
 
-    if (!m_block_preamble.block_parameters_index)
-        m_block_parameters = block_parameters[0];
+    if (filter) {
+        // Items read before Block preamble or Block tables weren't filtered
+        if (!pruned && ((time_filter && !range_known) || (table_filter && !indexes_known))) {
+            if (time_filter)
+                set_range_offsets();
+
+            m_query_responses.erase(std::remove_if(m_query_responses.begin(), m_query_responses.end(),
+                [&qr_matches](const QueryResponse& qr) { return !qr_matches(qr); }),
+                m_query_responses.end());
+            m_malformed_messages.erase(std::remove_if(m_malformed_messages.begin(), m_malformed_messages.end(),
+                [&mm_matches](const MalformedMessage& mm) { return !mm_matches(mm); }),
+                m_malformed_messages.end());
+        }
+
+        if (pruned || (m_query_responses.empty() && m_malformed_messages.empty())) {
+            clear_items();
+            return false;
+        }
+
+        if (has_raw_tables) {
+            MemoryStreamBuffer buffer(raw_tables);
+            std::istream input(&buffer);
+            CdnsDecoder tables_dec(input);
+            read_blocktables(tables_dec);
+        }
+    }
 
     for (auto& qr : m_query_responses) {
         if (qr.time_offset) {
@@ -2504,6 +2567,8 @@ void CDNS::CdnsBlockRead::read(CdnsDecoder& dec, std::vector<BlockParameters>& b
     m_qr_read = 0;
     m_aec_read = m_address_event_counts.begin();
     m_mm_read = 0;
+
+    return true;
 }
 
 CDNS::GenericQueryResponse CDNS::CdnsBlockRead::read_generic_qr(bool& end)
@@ -2689,3 +2754,106 @@ CDNS::GenericMalformedMessage CDNS::CdnsBlockRead::read_generic_mm(bool& end)
     m_mm_read++;
     return gmm;
 }
+
+void CDNS::BlockItemCounts::read(CdnsDecoder& dec)
+{
+    qr_count = aec_count = mm_count = 0;
+    bool indef = false;
+    uint64_t length = dec.read_map_start(indef);
+
+    while (length > 0 || indef) {
+        if (indef && dec.peek_type() == CborType::BREAK) {
+            dec.read_break();
+            break;
+        }
+
+        switch (dec.read_integer()) {
+            case get_map_index(BlockMapIndex::query_responses):
+                qr_count = dec.skip_array();
+                break;
+            case get_map_index(BlockMapIndex::address_event_counts):
+                aec_count = dec.skip_array();
+                break;
+            case get_map_index(BlockMapIndex::malformed_messages):
+                mm_count = dec.skip_array();
+                break;
+            default:
+                dec.skip_item();
+                break;
+        }
+
+        length--;
+    }
+}
+
+void CDNS::CdnsRawBlock::read(CdnsDecoder& dec, std::size_t block_parameters_count)
+{
+    clear();
+    bool is_m_block_preamble = false;
+    bool indef = false;
+    uint64_t length = dec.read_map_start(indef);
+
+    while (length > 0 || indef) {
+        if (indef && dec.peek_type() == CborType::BREAK) {
+            dec.read_break();
+            break;
+        }
+
+        // Capture the whole key/value pair, Block preamble is decoded and the capture discarded
+        dec.start_capture(m_raw);
+        auto key = dec.read_integer();
+        uint64_t* count = nullptr;
+
+        switch (key) {
+            case get_map_index(BlockMapIndex::block_preamble):
+                dec.cancel_capture();
+                m_block_preamble.read(dec);
+                if (m_block_preamble.block_parameters_index &&
+                    *m_block_preamble.block_parameters_index >= block_parameters_count)
+                    throw CdnsDecoderException("Block parameters index for C-DNS block is too high");
+                is_m_block_preamble = true;
+                length--;
+                continue;
+            case get_map_index(BlockMapIndex::query_responses):
+                count = &m_qr_count;
+                break;
+            case get_map_index(BlockMapIndex::address_event_counts):
+                count = &m_aec_count;
+                break;
+            case get_map_index(BlockMapIndex::malformed_messages):
+                count = &m_mm_count;
+                break;
+            default:
+                break;
+        }
+
+        if (count)
+            *count = dec.skip_array();
+        else
+            dec.skip_item();
+
+        dec.stop_capture();
+        m_raw_items++;
+        length--;
+    }
+
+    if (!is_m_block_preamble)
+        throw CdnsDecoderException("CdnsBlock from input stream missing one of mandatory items");
+}
+
+std::size_t CDNS::CdnsRawBlock::write(CdnsEncoder& enc)
+{
+    std::size_t written = 0;
+
+    // Start Block map
+    written += enc.write_map_start(m_raw_items + 1);
+
+    // Write Block preamble
+    written += enc.write(get_map_index(BlockMapIndex::block_preamble));
+    written += m_block_preamble.write(enc);
+
+    // Copy the rest of the Block
+    written += enc.write_raw(m_raw);
+
+    return written;
+}
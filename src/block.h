@@ -9,11 +9,21 @@
 #pragma once
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
 #include <unordered_map>
 #include <deque>
 #include <vector>
+#include <memory>
+#include <cstring>
+#include <netinet/in.h>
 #include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+#include <boost/container/small_vector.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "format_specification.h"
 #include "block_table.h"
@@ -22,12 +32,16 @@
 #include "timestamp.h"
 #include "cdns_encoder.h"
 #include "cdns_decoder.h"
+#include "anonymizer.h"
+#include "compact_optional.h"
 
 namespace CDNS {
     struct GenericResourceRecord;
     struct GenericQueryResponse;
+    struct WireQueryResponse;
     struct GenericAddressEventCount;
     struct GenericMalformedMessage;
+    class QueryResponseBuilder;
 
     /**
      * @brief Block table's ClassType structure
@@ -91,6 +105,9 @@ namespace CDNS {
 
     /**
      * @brief Block table's Query Response Signature structure
+     *
+     * All items are CompactOptional, so the structure has no padding and is compared and hashed
+     * as one block of memory.
      */
     struct QueryResponseSignature {
 
@@ -100,19 +117,7 @@ namespace CDNS {
          * @return `true` if the items are equal
          */
         bool operator==(const QueryResponseSignature& rhs) const {
-            return (server_address_index == rhs.server_address_index) &&
-                   (server_port == rhs.server_port) &&
-                   (qr_transport_flags == rhs.qr_transport_flags) &&
-                   (qr_type == rhs.qr_type) && (qr_sig_flags == rhs.qr_sig_flags) &&
-                   (query_opcode == rhs.query_opcode) &&  (qr_dns_flags == rhs.qr_dns_flags) &&
-                   (query_rcode == rhs.query_rcode) &&
-                   (query_classtype_index == rhs.query_classtype_index) &&
-                   (query_qdcount == rhs.query_qdcount) && (query_ancount == rhs.query_ancount) &&
-                   (query_nscount == rhs.query_nscount) && (query_arcount == rhs.query_arcount) &&
-                   (query_edns_version == rhs.query_edns_version) &&
-                   (query_udp_size == rhs.query_udp_size) &&
-                   (query_opt_rdata_index == rhs.query_opt_rdata_index) &&
-                   (response_rcode == rhs.response_rcode);
+            return std::memcmp(this, &rhs, sizeof(QueryResponseSignature)) == 0;
         }
 
         /**
@@ -137,43 +142,7 @@ namespace CDNS {
          * @return Hash value for "qrs"
          */
         friend std::size_t hash_value(const QueryResponseSignature& qrs) {
-            std::size_t hash = ~0U;
-            if (qrs.server_address_index)
-                hash = hash_value(qrs.server_address_index.value());
-            if (qrs.server_port)
-                hash = hash_value(qrs.server_port.value(), hash);
-            if (qrs.qr_transport_flags)
-                hash = hash_value(qrs.qr_transport_flags.value(), hash);
-            if (qrs.qr_type)
-                hash = hash_value(qrs.qr_type.value(), hash);
-            if (qrs.qr_sig_flags)
-                hash = hash_value(qrs.qr_sig_flags.value(), hash);
-            if (qrs.query_opcode)
-                hash = hash_value(qrs.query_opcode.value(), hash);
-            if (qrs.qr_dns_flags)
-                hash = hash_value(qrs.qr_dns_flags.value(), hash);
-            if (qrs.query_rcode)
-                hash = hash_value(qrs.query_rcode.value(), hash);
-            if (qrs.query_classtype_index)
-                hash = hash_value(qrs.query_classtype_index.value(), hash);
-            if (qrs.query_qdcount)
-                hash = hash_value(qrs.query_qdcount.value(), hash);
-            if (qrs.query_ancount)
-                hash = hash_value(qrs.query_ancount.value(), hash);
-            if (qrs.query_nscount)
-                hash = hash_value(qrs.query_nscount.value(), hash);
-            if (qrs.query_arcount)
-                hash = hash_value(qrs.query_arcount.value(), hash);
-            if (qrs.query_edns_version)
-                hash = hash_value(qrs.query_edns_version.value(), hash);
-            if (qrs.query_udp_size)
-                hash = hash_value(qrs.query_udp_size.value(), hash);
-            if (qrs.query_opt_rdata_index)
-                hash = hash_value(qrs.query_opt_rdata_index.value(), hash);
-            if (qrs.response_rcode)
-                hash = hash_value(qrs.response_rcode.value(), hash);
-
-            return hash;
+            return hash_value(&qrs, sizeof(QueryResponseSignature));
         }
 
         /**
@@ -201,25 +170,27 @@ namespace CDNS {
          */
         void reset();
 
-        boost::optional<index_t> server_address_index;
-        boost::optional<uint16_t> server_port;
-        boost::optional<QueryResponseTransportFlagsMask> qr_transport_flags;
-        boost::optional<QueryResponseTypeValues> qr_type;
-        boost::optional<QueryResponseFlagsMask> qr_sig_flags;
-        boost::optional<uint8_t> query_opcode;
-        boost::optional<DNSFlagsMask> qr_dns_flags;
-        boost::optional<uint16_t> query_rcode;
-        boost::optional<index_t> query_classtype_index;
-        boost::optional<uint16_t> query_qdcount;
-        boost::optional<uint32_t> query_ancount;
-        boost::optional<uint16_t> query_nscount;
-        boost::optional<uint16_t> query_arcount;
-        boost::optional<uint8_t> query_edns_version;
-        boost::optional<uint16_t> query_udp_size;
-        boost::optional<index_t> query_opt_rdata_index;
-        boost::optional<uint16_t> response_rcode;
+        CompactOptional<index_t> server_address_index;
+        CompactOptional<uint16_t> server_port;
+        CompactOptional<QueryResponseTransportFlagsMask> qr_transport_flags;
+        CompactOptional<QueryResponseTypeValues> qr_type;
+        CompactOptional<QueryResponseFlagsMask> qr_sig_flags;
+        CompactOptional<uint8_t> query_opcode;
+        CompactOptional<DNSFlagsMask> qr_dns_flags;
+        CompactOptional<uint16_t> query_rcode;
+        CompactOptional<index_t> query_classtype_index;
+        CompactOptional<uint16_t> query_qdcount;
+        CompactOptional<uint32_t> query_ancount;
+        CompactOptional<uint16_t> query_nscount;
+        CompactOptional<uint16_t> query_arcount;
+        CompactOptional<uint8_t> query_edns_version;
+        CompactOptional<uint16_t> query_udp_size;
+        CompactOptional<index_t> query_opt_rdata_index;
+        CompactOptional<uint16_t> response_rcode;
     };
 
+    static_assert(alignof(QueryResponseSignature) == 1, "QueryResponseSignature mustn't contain padding");
+
     /**
      * @brief Block table's Question structure
      */
@@ -292,8 +263,7 @@ namespace CDNS {
          * @return `true` if the items are equal
          */
         bool operator==(const RR& rhs) const {
-            return (name_index == rhs.name_index) && (classtype_index == rhs.classtype_index) &&
-                   (ttl == rhs.ttl) && (rdata_index == rhs.rdata_index);
+            return std::memcmp(this, &rhs, packed_size()) == 0;
         }
 
         /**
@@ -311,14 +281,14 @@ namespace CDNS {
          * @return Hash value for "rr"
          */
         friend std::size_t hash_value(const RR& rr) {
-            std::size_t hash = hash_value(rr.name_index);
-            hash = hash_value(rr.classtype_index, hash);
-            if (rr.ttl)
-                hash = hash_value(rr.ttl.value(), hash);
-            if (rr.rdata_index)
-                hash = hash_value(rr.rdata_index.value(), hash);
+            return hash_value(&rr, packed_size());
+        }
 
-            return hash;
+        /**
+         * @brief Size of the RR's items without trailing padding
+         */
+        static constexpr std::size_t packed_size() {
+            return 2 * sizeof(index_t) + sizeof(CompactOptional<uint32_t>) + sizeof(CompactOptional<index_t>);
         }
 
         /**
@@ -355,10 +325,13 @@ namespace CDNS {
 
         index_t name_index;
         index_t classtype_index;
-        boost::optional<uint32_t> ttl;
-        boost::optional<index_t> rdata_index;
+        CompactOptional<uint32_t> ttl;
+        CompactOptional<index_t> rdata_index;
     };
 
+    static_assert(offsetof(RR, rdata_index) + sizeof(RR::rdata_index) == RR::packed_size(),
+                  "RR items mustn't contain padding");
+
     /**
      * @brief Block table's Malformed Message Data structure
      */
@@ -436,9 +409,9 @@ namespace CDNS {
          */
         void reset();
 
-        boost::optional<index_t> server_address_index;
-        boost::optional<uint16_t> server_port;
-        boost::optional<QueryResponseTransportFlagsMask> mm_transport_flags;
+        CompactOptional<index_t> server_address_index;
+        CompactOptional<uint16_t> server_port;
+        CompactOptional<QueryResponseTransportFlagsMask> mm_transport_flags;
         boost::optional<std::string> mm_payload;
     };
 
@@ -580,6 +553,7 @@ namespace CDNS {
         boost::optional<unsigned> unmatched_responses;
         boost::optional<unsigned> discarded_opcode;
         boost::optional<unsigned> malformed_items;
+        boost::optional<unsigned> dropped_items; //!< Items dropped by exporter's output queue (implementation specific)
     };
 
     /**
@@ -614,23 +588,23 @@ namespace CDNS {
         void reset();
 
         boost::optional<Timestamp> time_offset;
-        boost::optional<index_t> client_address_index;
-        boost::optional<uint16_t> client_port;
-        boost::optional<uint16_t> transaction_id;
-        boost::optional<index_t> qr_signature_index;
-        boost::optional<uint8_t> client_hoplimit;
-        boost::optional<int64_t> response_delay;
-        boost::optional<index_t> query_name_index;
-        boost::optional<std::size_t> query_size;
-        boost::optional<std::size_t> response_size;
+        CompactOptional<index_t> client_address_index;
+        CompactOptional<uint16_t> client_port;
+        CompactOptional<uint16_t> transaction_id;
+        CompactOptional<index_t> qr_signature_index;
+        CompactOptional<uint8_t> client_hoplimit;
+        CompactOptional<int64_t> response_delay;
+        CompactOptional<index_t> query_name_index;
+        CompactOptional<std::size_t> query_size;
+        CompactOptional<std::size_t> response_size;
         boost::optional<ResponseProcessingData> response_processing_data;
         boost::optional<QueryResponseExtended> query_extended;
         boost::optional<QueryResponseExtended> response_extended;
         boost::optional<std::string> asn; // ASN for client IP address, implementation specific item
         boost::optional<std::string> country_code; // Country code for client IP address, implementation specific item
-        boost::optional<int64_t> round_trip_time; //!< Estimated RTT of TCP connection in ticks, implementation specific item
+        CompactOptional<int64_t> round_trip_time; //!< Estimated RTT of TCP connection in ticks, implementation specific item
         boost::optional<std::string> user_id; //!< Unique user ID
-        boost::optional<PolicyActionValues> policy_action; //!<< Policy applied on query. Partially based on policy.action field from dnstap schema
+        CompactOptional<PolicyActionValues> policy_action; //!<< Policy applied on query. Partially based on policy.action field from dnstap schema
         boost::optional<std::string> policy_rule; //!<< Rule that triggered policy application on query. Based on policy.rule field from dnstap schema
     };
 
@@ -750,9 +724,9 @@ namespace CDNS {
         void reset();
 
         boost::optional<Timestamp> time_offset;
-        boost::optional<index_t> client_address_index;
-        boost::optional<uint16_t> client_port;
-        boost::optional<index_t> message_data_index;
+        CompactOptional<index_t> client_address_index;
+        CompactOptional<uint16_t> client_port;
+        CompactOptional<index_t> message_data_index;
     };
 
     /**
@@ -818,6 +792,356 @@ namespace CDNS {
         std::string data;
     };
 
+    /**
+     * @brief Block table of byte strings (IP addresses, NAMEs and RDATA)
+     *
+     * Specialization of BlockTable that indexes stored strings by non-owning views, so strings can be
+     * looked up by pointer and size without constructing std::string. Like the generic BlockTable it can
+     * encode strings at insert time (see set_pre_encode()).
+     */
+    template<>
+    class BlockTable<StringItem> {
+        public:
+        BlockTable() : items_(), indexes_(), encoded_(), lookups_(0) {}
+
+        /**
+         * @brief Copy constructor. Index is rebuilt to view the copied strings.
+         */
+        BlockTable(const BlockTable& copy)
+            : items_(copy.items_), indexes_(), encoded_(), lookups_(copy.lookups_) {
+            rebuild_indexes();
+            set_pre_encode(copy.pre_encoded());
+        }
+
+        /**
+         * @brief Move constructor. Items of std::deque aren't relocated by move, so the index stays valid.
+         */
+        BlockTable(BlockTable&& copy) = default;
+
+        /**
+         * @brief Assignment operator. Index is rebuilt to view the copied strings.
+         */
+        BlockTable& operator=(const BlockTable& rhs) {
+            if (this != &rhs) {
+                items_ = rhs.items_;
+                lookups_ = rhs.lookups_;
+                rebuild_indexes();
+                encoded_.reset();
+                set_pre_encode(rhs.pre_encoded());
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment operator
+         */
+        BlockTable& operator=(BlockTable&& rhs) = default;
+
+        /**
+         * @brief Find if a string is in the table
+         * @param data Start of the string
+         * @param size Size of the string in bytes
+         * @param index The index of the string, if found
+         * @return `true` if the string is found
+         */
+        bool find(const char* data, std::size_t size, index_t& index) const {
+            auto found = indexes_.find(boost::string_view(data, size));
+            if (found == indexes_.end())
+                return false;
+
+            index = found->second;
+            return true;
+        }
+
+        /**
+         * @brief Find if a string is in the table
+         * @param key The string to search for
+         * @param index The index of the string, if found
+         * @return `true` if the string is found
+         */
+        bool find(const StringItem& key, index_t& index) const {
+            return find(key.data.data(), key.data.size(), index);
+        }
+
+        /**
+         * @brief Add a new string to the table without checking for duplicates
+         * @param val The string to add
+         * @return Index of the string
+         */
+        index_t add_value(const StringItem& val) {
+            items_.push_back(val);
+            encode_last();
+            return record_last_key();
+        }
+
+        /**
+         * @brief Add a new string to the table without checking for duplicates
+         * @param val The string to add
+         * @return Index of the string
+         */
+        index_t add_value(StringItem&& val) {
+            items_.push_back(std::move(val));
+            encode_last();
+            return record_last_key();
+        }
+
+        /**
+         * @brief Add a string to the table if it isn't present already
+         * @param data Start of the string
+         * @param size Size of the string in bytes
+         * @return Index of the string
+         */
+        index_t add(const char* data, std::size_t size) {
+            lookups_++;
+            index_t ret;
+            if (!find(data, size, ret)) {
+                items_.emplace_back();
+                items_.back().data.assign(data, size);
+                encode_last();
+                ret = record_last_key();
+            }
+
+            return ret;
+        }
+
+        /**
+         * @brief Add a string to the table if it isn't present already
+         * @param val The string to add
+         * @return Index of the string
+         */
+        index_t add(const StringItem& val) {
+            return add(val.data.data(), val.data.size());
+        }
+
+        /**
+         * @brief Clear the table contents
+         */
+        void clear() {
+            items_.clear();
+            lookups_ = 0;
+            if (encoded_) {
+                encoded_->encoder.flush();
+                encoded_->bytes.clear();
+            }
+            indexes_.clear();
+        }
+
+        /**
+         * @brief Enable or disable encoding of strings to CBOR at insert time. Strings already
+         * in the table are encoded when pre-encoding is enabled.
+         * @param enable `true` to keep pre-encoded strings, `false` to encode them in write()
+         */
+        void set_pre_encode(bool enable) {
+            if (!enable) {
+                encoded_.reset();
+                return;
+            }
+
+            if (encoded_)
+                return;
+
+            encoded_ = std::make_unique<PreEncoded>();
+            for (auto& item : items_)
+                item.write(encoded_->encoder);
+        }
+
+        /**
+         * @brief Check if strings are encoded at insert time
+         */
+        bool pre_encoded() const {
+            return !!encoded_;
+        }
+
+        /**
+         * @brief Write the table as CBOR array of its strings
+         * @param enc C-DNS encoder
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write(CdnsEncoder& enc) {
+            std::size_t written = enc.write_array_start(items_.size());
+
+            if (encoded_) {
+                encoded_->encoder.flush();
+                return written + enc.write_raw(encoded_->bytes);
+            }
+
+            for (auto& item : items_)
+                written += item.write(enc);
+            return written;
+        }
+
+        /**
+         * @brief Get the indexed string
+         * @param pos The index
+         * @throw std::runtime_error if given index is out of range
+         */
+        const StringItem& operator[](index_t pos) const {
+            if (pos < items_.size())
+                return items_[pos];
+
+            throw std::runtime_error("Block index out of range");
+        }
+
+        /**
+         * @brief Get the number of strings stored
+         */
+        std::deque<StringItem>::size_type size() const {
+            return items_.size();
+        }
+
+        /**
+         * @brief Get the number of lookups by add() since the last clear(). Lookups that didn't
+         * insert a new string are deduplication hits.
+         */
+        uint64_t lookups() const {
+            return lookups_;
+        }
+
+        /**
+         * @brief Iterator begin
+         */
+        std::deque<StringItem>::iterator begin() {
+            return items_.begin();
+        }
+
+        /**
+         * @brief Iterator end
+         */
+        std::deque<StringItem>::iterator end() {
+            return items_.end();
+        }
+
+        private:
+        /**
+         * @brief CBOR encoded strings together with encoder appending to them.
+         * Encoder is declared last, so it's flushed before the bytes are destroyed.
+         */
+        struct PreEncoded {
+            PreEncoded() : bytes(), encoder(bytes) {}
+
+            std::string bytes;
+            CdnsEncoder encoder;
+        };
+
+        /**
+         * @brief Encode the latest string if pre-encoding is enabled
+         */
+        void encode_last() {
+            if (encoded_)
+                items_.back().write(encoded_->encoder);
+        }
+
+        /**
+         * @brief Hash of the string view
+         */
+        struct ViewHash {
+            std::size_t operator()(const boost::string_view& view) const {
+                return hash_value(view.data(), view.size());
+            }
+        };
+
+        /**
+         * @brief Record view of the latest string to the index
+         * @return Index of the latest string
+         */
+        index_t record_last_key() {
+            index_t res = items_.size() - 1;
+            const std::string& str = items_.back().data;
+            indexes_[boost::string_view(str.data(), str.size())] = res;
+            return res;
+        }
+
+        /**
+         * @brief Rebuild the index to view the current strings
+         */
+        void rebuild_indexes() {
+            indexes_.clear();
+            for (index_t i = 0; i < items_.size(); i++)
+                indexes_[boost::string_view(items_[i].data.data(), items_[i].data.size())] = i;
+        }
+
+        std::deque<StringItem> items_;
+        std::unordered_map<boost::string_view, index_t, ViewHash> indexes_;
+        std::unique_ptr<PreEncoded> encoded_; //!< Pre-encoded strings, if enabled
+        uint64_t lookups_;
+    };
+
+    /**
+     * @brief Fixed-size binary key of IPv4 or IPv6 address already truncated to its prefix length.
+     * Used for fast lookup of addresses in IP address Block table without string construction.
+     */
+    struct IpAddressKey {
+        IpAddressKey() : addr(), length(0), prefix(0) {}
+
+        /**
+         * @brief Construct a new IpAddressKey object from raw address truncated to given prefix
+         * @param address Raw address bytes in network byte order
+         * @param size Size of the raw address (4 for IPv4, 16 for IPv6)
+         * @param prefix Number of leading bits of the address to keep
+         * @param truncate If `false` the whole address is kept in the key and the prefix is only
+         * remembered (used for keys of addresses that are pseudonymized before truncation)
+         */
+        IpAddressKey(const uint8_t* address, uint8_t size, uint8_t prefix, bool truncate = true)
+            : addr(), length(0), prefix(prefix > size * 8 ? size * 8 : prefix) {
+            if (!truncate) {
+                length = size;
+                std::memcpy(addr, address, length);
+                return;
+            }
+
+            length = (this->prefix + 7) / 8;
+            std::memcpy(addr, address, length);
+
+            // Clear bits of the last byte that are beyond the prefix
+            if (this->prefix % 8)
+                addr[length - 1] &= static_cast<uint8_t>(0xFF << (8 - this->prefix % 8));
+        }
+
+        /**
+         * @brief Equality operator. Compares whole address with single SIMD compare if available.
+         * @param rhs Item to compare with
+         * @return `true` if the items are equal
+         */
+        bool operator==(const IpAddressKey& rhs) const {
+#ifdef __SSE2__
+            __m128i lhs_addr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(addr));
+            __m128i rhs_addr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs.addr));
+            return length == rhs.length && prefix == rhs.prefix &&
+                   _mm_movemask_epi8(_mm_cmpeq_epi8(lhs_addr, rhs_addr)) == 0xFFFF;
+#else
+            return length == rhs.length && prefix == rhs.prefix && std::memcmp(addr, rhs.addr, sizeof(addr)) == 0;
+#endif
+        }
+
+        /**
+         * @brief Inequality operator
+         * @param rhs Item to compare with
+         * @return `true` if the items aren't equal
+         */
+        bool operator!=(const IpAddressKey& rhs) const {
+            return !(*this == rhs);
+        }
+
+        /**
+         * @brief Calculate hash for IpAddressKey
+         * @param key Data to calculate hash on
+         * @return Hash value for "key"
+         */
+        friend std::size_t hash_value(const IpAddressKey& key) {
+            return hash_value(key.addr, sizeof(key.addr), key.length | key.prefix << 8);
+        }
+
+        uint8_t addr[16]; //!< Address bytes, bytes beyond length are always 0
+        uint8_t length; //!< Number of address bytes in the key
+        uint8_t prefix; //!< Prefix length the address is truncated to in C-DNS
+    };
+
+    /**
+     * @brief List of indexes to question or resource records. The lists rarely have more than
+     * a few items, so up to 4 indexes are stored inline without heap allocation.
+     */
+    using IndexList = boost::container::small_vector<index_t, 4>;
+
     /**
      * @brief Structure representing list of indexes to question or resource records
      */
@@ -878,13 +1202,49 @@ namespace CDNS {
          */
         void reset();
 
-        std::vector<index_t> list;
+        IndexList list;
+    };
+
+    /**
+     * @brief Size and deduplication statistics of one Block table
+     */
+    struct BlockTableMetrics {
+        BlockTableMetrics() : items(0), lookups(0) {}
+        BlockTableMetrics(uint64_t items_, uint64_t lookups_) : items(items_), lookups(lookups_) {}
+
+        /**
+         * @brief Get ratio of lookups that found the item already present in the table
+         * @return Deduplication hit ratio from interval [0, 1]
+         */
+        double hit_ratio() const {
+            return lookups > items ? static_cast<double>(lookups - items) / lookups : 0.0;
+        }
+
+        uint64_t items; //!< Number of items in the table
+        uint64_t lookups; //!< Number of lookups of items inserted into the table
+    };
+
+    /**
+     * @brief Size and deduplication statistics of all Block tables in one Block
+     */
+    struct BlockTablesMetrics {
+        BlockTableMetrics ip_address;
+        BlockTableMetrics classtype;
+        BlockTableMetrics name_rdata;
+        BlockTableMetrics qr_sig;
+        BlockTableMetrics qlist;
+        BlockTableMetrics qrr;
+        BlockTableMetrics rrlist;
+        BlockTableMetrics rr;
+        BlockTableMetrics malformed_message_data;
     };
 
     /**
      * @brief Class representing C-DNS block
      */
     class CdnsBlock {
+        friend class QueryResponseBuilder;
+
         public:
 
         /**
@@ -928,6 +1288,11 @@ namespace CDNS {
                 this->m_block_preamble = rhs.m_block_preamble;
                 this->m_block_statistics = rhs.m_block_statistics;
                 this->m_ip_address = rhs.m_ip_address;
+                this->m_ip_address_keys = rhs.m_ip_address_keys;
+                this->m_ip_address_key_hits = rhs.m_ip_address_key_hits;
+                this->m_generation = rhs.m_generation;
+                this->m_cache_limit = rhs.m_cache_limit;
+                this->m_anonymizer = rhs.m_anonymizer;
                 this->m_classtype = rhs.m_classtype;
                 this->m_name_rdata = rhs.m_name_rdata;
                 this->m_qr_sig = rhs.m_qr_sig;
@@ -984,15 +1349,91 @@ namespace CDNS {
          * @return Index of the IP address in Block table
          */
         index_t add_ip_address(const std::string& address) {
-            index_t ret;
+            return m_ip_address.add(address.data(), address.size());
+        }
 
-            if (!m_ip_address.find(reinterpret_cast<const StringItem&>(address), ret)) {
-                StringItem tmp;
-                tmp.data = address;
-                ret = m_ip_address.add_value(std::move(tmp));
-            }
+        /**
+         * @brief Add IP address to IP address Block table
+         * @param address Start of the IP address byte string
+         * @param size Size of the IP address byte string
+         * @return Index of the IP address in Block table
+         */
+        index_t add_ip_address(const char* address, std::size_t size) {
+            return m_ip_address.add(address, size);
+        }
 
-            return ret;
+        /**
+         * @brief Add raw IPv4 address to IP address Block table. The address is truncated to client
+         * or server IPv4 address prefix from Block parameters' Storage parameters.
+         * @param address IPv4 address to add to the Block table
+         * @param client `true` if the address is client address, `false` for server address
+         * @return Index of the IP address in Block table
+         */
+        index_t add_ip_address(const in_addr& address, bool client = true) {
+            return add_ip_address(reinterpret_cast<const uint8_t*>(&address), sizeof(address), client);
+        }
+
+        /**
+         * @brief Add raw IPv6 address to IP address Block table. The address is truncated to client
+         * or server IPv6 address prefix from Block parameters' Storage parameters.
+         * @param address IPv6 address to add to the Block table
+         * @param client `true` if the address is client address, `false` for server address
+         * @return Index of the IP address in Block table
+         */
+        index_t add_ip_address(const in6_addr& address, bool client = true) {
+            return add_ip_address(reinterpret_cast<const uint8_t*>(&address), sizeof(address), client);
+        }
+
+        /**
+         * @brief Add raw IPv4 or IPv6 address to IP address Block table. The address is truncated to client
+         * or server address prefix from Block parameters' Storage parameters.
+         * @param address Raw address bytes in network byte order
+         * @param size Size of the raw address (4 for IPv4, 16 for IPv6)
+         * @param client `true` if the address is client address, `false` for server address
+         * @throw std::runtime_error if the size isn't 4 or 16 bytes
+         * @return Index of the IP address in Block table
+         */
+        index_t add_ip_address(const uint8_t* address, uint8_t size, bool client = true);
+
+        /**
+         * @brief Set anonymizer applied to all IP addresses inserted to the Block. With anonymizer set,
+         * also addresses given as 4 or 16 byte strings are truncated to prefixes from Storage parameters
+         * (and pseudonymized if the anonymizer uses Crypto-PAn). Addresses already inserted into the Block
+         * aren't affected.
+         * @param anonymizer Anonymizer to use, `nullptr` disables anonymization
+         */
+        void set_anonymizer(const std::shared_ptr<const IpAnonymizer>& anonymizer) {
+            m_anonymizer = anonymizer;
+            m_ip_address_keys.clear();
+        }
+
+        /**
+         * @brief Keep raw IP addresses inserted by add_ip_address() between Blocks. When enabled, clear()
+         * keeps the binary index of raw IP addresses if it has at most `limit` addresses. Addresses
+         * reappearing in the next Block then don't have to be truncated and anonymized again.
+         * @param limit Maximum number of kept raw IP addresses, 0 disables the cache
+         */
+        void set_table_cache(std::size_t limit) {
+            m_cache_limit = limit;
+            m_ip_address_keys.clear();
+        }
+
+        /**
+         * @brief Encode items of all Block tables to CBOR right when they're inserted. Block tables are
+         * then written by copying their pre-encoded bytes, so encoding cost is moved from Block export
+         * to insertion of items.
+         * @param enable `true` to enable pre-encoding of Block table items
+         */
+        void set_pre_encode(bool enable) {
+            m_ip_address.set_pre_encode(enable);
+            m_classtype.set_pre_encode(enable);
+            m_name_rdata.set_pre_encode(enable);
+            m_qr_sig.set_pre_encode(enable);
+            m_qlist.set_pre_encode(enable);
+            m_qrr.set_pre_encode(enable);
+            m_rrlist.set_pre_encode(enable);
+            m_rr.set_pre_encode(enable);
+            m_malformed_message_data.set_pre_encode(enable);
         }
 
         /**
@@ -1036,15 +1477,17 @@ namespace CDNS {
          * @return Index of the NAME or RDATA in Block table
          */
         index_t add_name_rdata(const std::string& nrd) {
-            index_t ret;
-
-            if (!m_name_rdata.find(reinterpret_cast<const StringItem&>(nrd), ret)) {
-                StringItem tmp;
-                tmp.data = nrd;
-                ret = m_name_rdata.add_value(std::move(tmp));
-            }
+            return m_name_rdata.add(nrd.data(), nrd.size());
+        }
 
-            return ret;
+        /**
+         * @brief Add NAME or RDATA to name_rdata Block table
+         * @param nrd Start of the NAME or RDATA byte string
+         * @param size Size of the NAME or RDATA byte string
+         * @return Index of the NAME or RDATA in Block table
+         */
+        index_t add_name_rdata(const char* nrd, std::size_t size) {
+            return m_name_rdata.add(nrd, size);
         }
 
         /**
@@ -1088,15 +1531,17 @@ namespace CDNS {
          * @return Index of the Question list in Block table
          */
         index_t add_question_list(const std::vector<index_t>& qlist) {
-            index_t ret;
-
-            if (!m_qlist.find(reinterpret_cast<const IndexListItem&>(qlist), ret)) {
-                IndexListItem tmp;
-                tmp.list = qlist;
-                ret = m_qlist.add_value(std::move(tmp));
-            }
+            return add_question_list(qlist.data(), qlist.size());
+        }
 
-            return ret;
+        /**
+         * @brief Add Question list to Question list Block table
+         * @param qlist Start of the array of Question indexes
+         * @param size Number of Question indexes in the array
+         * @return Index of the Question list in Block table
+         */
+        index_t add_question_list(const index_t* qlist, std::size_t size) {
+            return add_index_list(m_qlist, qlist, size);
         }
 
         /**
@@ -1109,7 +1554,8 @@ namespace CDNS {
             if (index >= m_qlist.size())
                 throw std::runtime_error("QuestionList block table index out of bounds");
 
-            return m_qlist[index].list;
+            const IndexList& list = m_qlist[index].list;
+            return std::vector<index_t>(list.begin(), list.end());
         }
 
         /**
@@ -1140,15 +1586,17 @@ namespace CDNS {
          * @return Index of the Resource record list in Block table
          */
         index_t add_rr_list(const std::vector<index_t>& rrlist) {
-            index_t ret;
-
-            if (!m_rrlist.find(reinterpret_cast<const IndexListItem&>(rrlist), ret)) {
-                IndexListItem tmp;
-                tmp.list = rrlist;
-                ret = m_rrlist.add_value(std::move(tmp));
-            }
+            return add_rr_list(rrlist.data(), rrlist.size());
+        }
 
-            return ret;
+        /**
+         * @brief Add Resource record list to Resource record list Block table
+         * @param rrlist Start of the array of Resource record indexes
+         * @param size Number of Resource record indexes in the array
+         * @return Index of the Resource record list in Block table
+         */
+        index_t add_rr_list(const index_t* rrlist, std::size_t size) {
+            return add_index_list(m_rrlist, rrlist, size);
         }
 
         /**
@@ -1161,7 +1609,8 @@ namespace CDNS {
             if (index >= m_rrlist.size())
                 throw std::runtime_error("RRlist block table index out of bounds");
 
-            return m_rrlist[index].list;
+            const IndexList& list = m_rrlist[index].list;
+            return std::vector<index_t>(list.begin(), list.end());
         }
 
         /**
@@ -1236,6 +1685,20 @@ namespace CDNS {
         bool add_question_response_record(const GenericQueryResponse& qr,
                                           const boost::optional<BlockStatistics>& stats = boost::none);
 
+        /**
+         * @brief Add new DNS record to C-DNS block from raw DNS messages. Messages are parsed and stored
+         * directly into Block tables according to storage hints. Malformed messages are stored as
+         * Malformed messages (if enabled by storage hints) and the QueryResponse is added only if at least
+         * one of the messages is valid.
+         * @param wqr Raw DNS messages of new DNS record with their transport metadata
+         * @param stats Current Block statistics (It's user's responsibility to count statistics and update
+         * them in the Block. User also has to start counting statistics from 0 if Block is cleared)
+         * @throw std::exception if inserting DNS record to the Block fails
+         * @return `true` if the Block is full (DNS record is still inserted), `false` otherwise
+         */
+        bool add_wire_query_response(const WireQueryResponse& wqr,
+                                     const boost::optional<BlockStatistics>& stats = boost::none);
+
         /**
          * @brief Add new DNS record to C-DNS block
          * @param qr New DNS record to add to Block
@@ -1249,7 +1712,8 @@ namespace CDNS {
         /**
          * @brief Add new Address Event to C-DNS block. Uses generic structure to hold all Address Event's data
          * and adds it to the Block
-         * @param gaec Generic structure holding data of new Address Event
+         * @param gaec Generic structure holding data of new Address Event (its ae_count is added to the Block's
+         * count of this Address Event, ae_count 0 counts as a single occurrence)
          * @param stats Current Block statistics (It's user's responsibility to count statistics and update
          * them in the Block. User also has to start counting statistics from 0 if Block is cleared)
          * @throw std::exception if inserting Address Event to the Block fails
@@ -1302,6 +1766,25 @@ namespace CDNS {
             return m_query_responses.size() + m_address_event_counts.size() + m_malformed_messages.size();
         }
 
+        /**
+         * @brief Get sizes and deduplication statistics of all Block tables
+         * @return Statistics of Block tables
+         */
+        BlockTablesMetrics get_table_metrics() const {
+            BlockTablesMetrics ret;
+            ret.ip_address = BlockTableMetrics(m_ip_address.size(), m_ip_address.lookups() + m_ip_address_key_hits);
+            ret.classtype = BlockTableMetrics(m_classtype.size(), m_classtype.lookups());
+            ret.name_rdata = BlockTableMetrics(m_name_rdata.size(), m_name_rdata.lookups());
+            ret.qr_sig = BlockTableMetrics(m_qr_sig.size(), m_qr_sig.lookups());
+            ret.qlist = BlockTableMetrics(m_qlist.size(), m_qlist.lookups());
+            ret.qrr = BlockTableMetrics(m_qrr.size(), m_qrr.lookups());
+            ret.rrlist = BlockTableMetrics(m_rrlist.size(), m_rrlist.lookups());
+            ret.rr = BlockTableMetrics(m_rr.size(), m_rr.lookups());
+            ret.malformed_message_data = BlockTableMetrics(m_malformed_message_data.size(),
+                                                           m_malformed_message_data.lookups());
+            return ret;
+        }
+
         /**
          * @brief Get the number of QueryResponse items in Block
          * @return Current number of QueryResponse items in the Block
@@ -1361,6 +1844,10 @@ namespace CDNS {
                 m_block_statistics = boost::none;
 
             m_ip_address.clear();
+            m_ip_address_key_hits = 0;
+            m_generation++;
+            if (m_cache_limit == 0 || m_ip_address_keys.size() > m_cache_limit || m_generation == 0)
+                m_ip_address_keys.clear();
             m_classtype.clear();
             m_name_rdata.clear();
             m_qr_sig.clear();
@@ -1380,6 +1867,21 @@ namespace CDNS {
 
         // Block Tables
         BlockTable<StringItem> m_ip_address; //!< IP addresses Block table
+        /**
+         * @brief Index of raw IP address in IP addresses Block table
+         */
+        struct IpAddressSlot {
+            index_t index;
+            uint32_t generation; //!< Generation of the Block the index belongs to
+            IpAddressKey stored; //!< Address as stored in the Block table (truncated and anonymized)
+        };
+
+        std::unordered_map<IpAddressKey, IpAddressSlot, CDNS::hash<IpAddressKey>> m_ip_address_keys; //!< Binary index to IP addresses Block table
+        uint64_t m_ip_address_key_hits = 0; //!< Raw IP addresses found in the binary index since clear()
+        uint32_t m_generation = 0; //!< Incremented by every clear()
+        std::size_t m_cache_limit = 0; //!< Maximum number of raw IP addresses kept in the binary index by clear()
+        std::shared_ptr<const IpAnonymizer> m_anonymizer; //!< Anonymizer applied to inserted IP addresses
+        IndexListItem m_index_list_key; //!< Reused lookup key for Question and RR lists
         BlockTable<ClassType> m_classtype; //!< ClassTypes Block table
         BlockTable<StringItem> m_name_rdata; //!< NAME or RDATA Block table
         BlockTable<QueryResponseSignature> m_qr_sig; //!< QueryResponseSignatures Block table
@@ -1395,6 +1897,50 @@ namespace CDNS {
 
         protected:
 
+        /**
+         * @brief Add IP address given as string to IP address Block table. If anonymizer is set,
+         * 4 and 16 byte addresses are anonymized.
+         * @param address IP address to add to the Block table
+         * @param client `true` if the address is client address, `false` for server address
+         * @return Index of the IP address in Block table
+         */
+        index_t add_generic_ip_address(const std::string& address, bool client) {
+            return add_generic_ip_address(address.data(), address.size(), client);
+        }
+
+        /**
+         * @brief Add list of indexes to Question or RR list Block table if it isn't present already.
+         * Lookup reuses inline storage of m_index_list_key, so short lists don't allocate.
+         * @param table Question or RR list Block table
+         * @param list Start of the array of indexes
+         * @param size Number of indexes in the array
+         * @return Index of the list in Block table
+         */
+        index_t add_index_list(BlockTable<IndexListItem>& table, const index_t* list, std::size_t size) {
+            index_t ret;
+            m_index_list_key.list.assign(list, list + size);
+
+            if (!table.find(m_index_list_key, ret))
+                ret = table.add_value(m_index_list_key);
+
+            return ret;
+        }
+
+        /**
+         * @brief Add IP address given as byte string to IP address Block table. If anonymizer is set,
+         * 4 and 16 byte addresses are anonymized.
+         * @param address Start of the IP address byte string
+         * @param size Size of the IP address byte string
+         * @param client `true` if the address is client address, `false` for server address
+         * @return Index of the IP address in Block table
+         */
+        index_t add_generic_ip_address(const char* address, std::size_t size, bool client) {
+            if (m_anonymizer && (size == sizeof(in_addr) || size == sizeof(in6_addr)))
+                return add_ip_address(reinterpret_cast<const uint8_t*>(address), size, client);
+
+            return add_ip_address(address, size);
+        }
+
         /**
          * @brief Serialize Block tables to C-DNS CBOR representation
          * @param enc C-DNS encoder
@@ -1406,6 +1952,37 @@ namespace CDNS {
         BlockParameters m_block_parameters;
     };
 
+    /**
+     * @brief Time range of Query/Responses and Malformed messages to read from C-DNS Blocks
+     *
+     * Subsecond ticks of the timestamps are in resolution of Block parameters used by the Blocks
+     * (microseconds by default), the same as in timestamps of items read from the Blocks.
+     */
+    struct TimeRange {
+        TimeRange() : start(), end() {}
+        TimeRange(const Timestamp& range_start, const Timestamp& range_end) : start(range_start), end(range_end) {}
+
+        Timestamp start; //!< Start of the range (inclusive)
+        Timestamp end; //!< End of the range (exclusive)
+    };
+
+    /**
+     * @brief Filter of Query/Responses and Malformed messages to read from C-DNS Blocks
+     *
+     * Item matches the filter if it matches all of the set conditions. Malformed messages have
+     * no query name so they never match filter with query name set.
+     */
+    struct ItemFilter {
+        /**
+         * @brief Check if any condition of the filter is set
+         */
+        bool empty() const { return !time_range && !query_name && !client_ip; }
+
+        boost::optional<TimeRange> time_range; //!< Time range of the items
+        boost::optional<std::string> query_name; //!< Query name of the items in DNS wire format
+        boost::optional<std::string> client_ip; //!< Client IP address of the items (4 or 16 bytes)
+    };
+
     /**
      * @brief Class representing C-DNS block read from input stream.
      *
@@ -1474,6 +2051,26 @@ namespace CDNS {
          */
         void read(CdnsDecoder& dec, std::vector<BlockParameters>& block_parameters);
 
+        /**
+         * @brief Read the C-DNS block from C-DNS CBOR input stream, keeping only Query/Responses and
+         * Malformed messages matching given filter
+         *
+         * Items not matching the filter are dropped right after being decoded. Block tables are decoded
+         * only if the Block contains a matching item. If the Block starts at or after the end of filter's
+         * time range, the rest of the Block following its Block preamble is skipped without decoding.
+         * If query name or client IP address is filtered, only the `name-rdata` and `ip-address` Block
+         * tables are decoded first to find indexes of the filtered values. Items are then matched by
+         * comparing the indexes and the Block's items are skipped without decoding if a value isn't
+         * present in the Block tables at all.
+         * @param dec C-DNS decoder
+         * @param block_parameters Array of Block parameters retreived from C-DNS file preamble
+         * @param filter Filter of items to keep
+         * @return `true` if the Block contains at least one Query/Response or Malformed message matching
+         * the filter. Otherwise `false` and the Block is left empty except for its Block preamble
+         * (Address Event Counts of such Block are dropped too).
+         */
+        bool read(CdnsDecoder& dec, std::vector<BlockParameters>& block_parameters, const ItemFilter& filter);
+
         /**
          * @brief Read next generic QueryResponse from the block.
          *
@@ -1509,12 +2106,47 @@ namespace CDNS {
         GenericMalformedMessage read_generic_mm(bool& end);
 
         private:
+        /**
+         * @brief Read the C-DNS block from C-DNS CBOR input stream
+         * @param dec C-DNS decoder
+         * @param block_parameters Array of Block parameters retreived from C-DNS file preamble
+         * @param filter Filter of items to keep (nullptr to keep all items)
+         * @return `false` if filter is given and the Block contains no item matching it, `true` otherwise
+         */
+        bool read_items(CdnsDecoder& dec, std::vector<BlockParameters>& block_parameters, const ItemFilter* filter);
+
+        /**
+         * @brief Clear the Block except for its Block preamble
+         */
+        void clear_items() {
+            Timestamp earliest_time = m_block_preamble.earliest_time;
+            clear();
+            m_block_preamble.earliest_time = earliest_time;
+        }
+
         /**
          * @brief Read the Block tables from C-DNS CBOR input stream
          * @param dec C-DNS decoder
          */
         void read_blocktables(CdnsDecoder& dec);
 
+        /**
+         * @brief Indexes of values filtered by ItemFilter in Block tables
+         */
+        struct FilterIndexes {
+            boost::optional<index_t> query_name; //!< Index of query name in `name-rdata` table
+            boost::optional<index_t> client_ip; //!< Index of client IP address in `ip-address` table
+        };
+
+        /**
+         * @brief Find indexes of values filtered by given filter in raw CBOR Block tables. Only
+         * the needed Block tables are decoded and their items aren't stored.
+         * @param raw_tables Raw CBOR Block tables
+         * @param filter Filter of items
+         * @return Indexes of filtered values, unset if a value isn't in the Block tables
+         */
+        FilterIndexes find_filter_indexes(std::string& raw_tables, const ItemFilter& filter);
+
         /**
          * @brief Fill GenericResourceRecord list with questions from given list
          * @param list List with indexes to Question Block table
@@ -1533,4 +2165,103 @@ namespace CDNS {
         std::unordered_map<AddressEventCount, uint64_t, CDNS::hash<AddressEventCount>>::iterator m_aec_read;
         uint64_t m_mm_read;
     };
+
+    /**
+     * @brief Numbers of items in C-DNS Block
+     */
+    struct BlockItemCounts {
+        BlockItemCounts() : qr_count(0), aec_count(0), mm_count(0) {}
+
+        /**
+         * @brief Read the numbers of items of C-DNS block from C-DNS CBOR input stream. Only lengths
+         * of item arrays are read, everything else in the Block is skipped without decoding.
+         * @param dec C-DNS decoder
+         */
+        void read(CdnsDecoder& dec);
+
+        uint64_t qr_count; //!< Number of QueryResponses
+        uint64_t aec_count; //!< Number of AddressEventCounts
+        uint64_t mm_count; //!< Number of MalformedMessages
+    };
+
+    /**
+     * @brief C-DNS Block read from input stream without decoding its content.
+     *
+     * Only the Block preamble is decoded. All other items of the Block are kept as raw CBOR data,
+     * so the Block can be written to another C-DNS file with modified Block preamble (e.g. Block
+     * parameters index) by copying bytes instead of decoding and encoding the whole Block.
+     */
+    class CdnsRawBlock {
+        public:
+        CdnsRawBlock() : m_raw_items(0), m_qr_count(0), m_aec_count(0), m_mm_count(0) {}
+
+        /**
+         * @brief Read the C-DNS block from C-DNS CBOR input stream
+         * @param dec C-DNS decoder
+         * @param block_parameters_count Number of Block parameters in the File preamble
+         * @throw CdnsDecoderException if the Block is missing Block preamble or its Block parameters
+         * index is too high
+         */
+        void read(CdnsDecoder& dec, std::size_t block_parameters_count);
+
+        /**
+         * @brief Serialize the Block to C-DNS CBOR representation
+         * @param enc C-DNS encoder
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write(CdnsEncoder& enc);
+
+        /**
+         * @brief Reset the Block to empty state
+         */
+        void clear() {
+            m_block_preamble.reset();
+            m_raw.clear();
+            m_raw_items = 0;
+            m_qr_count = 0;
+            m_aec_count = 0;
+            m_mm_count = 0;
+        }
+
+        /**
+         * @brief Get index of Block parameters used by the Block
+         */
+        index_t get_block_parameters_index() const {
+            return m_block_preamble.block_parameters_index.value_or(0);
+        }
+
+        /**
+         * @brief Get number of QueryResponses in the Block
+         */
+        uint64_t get_qr_count() const { return m_qr_count; }
+
+        /**
+         * @brief Get number of AddressEventCounts in the Block
+         */
+        uint64_t get_aec_count() const { return m_aec_count; }
+
+        /**
+         * @brief Get number of MalformedMessages in the Block
+         */
+        uint64_t get_mm_count() const { return m_mm_count; }
+
+        /**
+         * @brief Get number of all items in the Block
+         */
+        uint64_t get_item_count() const { return m_qr_count + m_aec_count + m_mm_count; }
+
+        /**
+         * @brief Get size of raw CBOR data of the Block (without Block preamble)
+         */
+        std::size_t get_raw_size() const { return m_raw.size(); }
+
+        BlockPreamble m_block_preamble;
+
+        private:
+        std::string m_raw; //!< Raw CBOR key/value pairs of the Block map except Block preamble
+        uint64_t m_raw_items; //!< Number of key/value pairs in m_raw
+        uint64_t m_qr_count;
+        uint64_t m_aec_count;
+        uint64_t m_mm_count;
+    };
 }
\ No newline at end of file
@@ -0,0 +1,365 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "block_summary.h"
+#include "hash.h"
+
+namespace {
+    /**
+     * @brief Update time span with given timestamp
+     * @throw std::invalid_argument if the timestamp is earlier than Block's earliest time
+     */
+    void update_time_span(const CDNS::Timestamp& ts, const CDNS::Timestamp& earliest,
+                          boost::optional<CDNS::Timestamp>& min, boost::optional<CDNS::Timestamp>& max)
+    {
+        // Time offsets decoded without CdnsBlockRead are relative to earliest time and can't be summarized
+        if (ts < earliest)
+            throw std::invalid_argument("Can't summarize Block with unresolved time offsets of items");
+
+        if (!min || ts < *min)
+            min = ts;
+        if (!max || *max < ts)
+            max = ts;
+    }
+
+    /**
+     * @brief Write histogram as CBOR map
+     */
+    std::size_t write_histogram(CDNS::CdnsEncoder& enc, const std::map<uint16_t, uint64_t>& histogram)
+    {
+        std::size_t written = enc.write_map_start(histogram.size());
+        for (auto& bucket : histogram) {
+            written += enc.write(bucket.first);
+            written += enc.write(bucket.second);
+        }
+
+        return written;
+    }
+
+    /**
+     * @brief Read histogram from CBOR map
+     */
+    void read_histogram(CDNS::CdnsDecoder& dec, std::map<uint16_t, uint64_t>& histogram)
+    {
+        histogram.clear();
+        bool indef = false;
+        uint64_t length = dec.read_map_start(indef);
+
+        while (length > 0 || indef) {
+            if (indef && dec.peek_type() == CDNS::CborType::BREAK) {
+                dec.read_break();
+                break;
+            }
+
+            uint16_t key = static_cast<uint16_t>(dec.read_unsigned());
+            histogram[key] += dec.read_unsigned();
+            length--;
+        }
+    }
+}
+
+CDNS::BloomFilter::BloomFilter(std::size_t items, unsigned bits_per_item)
+    : m_hashes(0), m_bits()
+{
+    if (items == 0 || bits_per_item == 0)
+        return;
+
+    // Optimal number of hashes is bits_per_item * ln(2)
+    m_hashes = static_cast<uint8_t>(std::min(16L, std::max(1L, std::lround(bits_per_item * 0.693))));
+    m_bits.assign((items * bits_per_item + 63) / 64 * 8, '\0');
+}
+
+template<typename F>
+bool CDNS::BloomFilter::for_each_bit(const std::string& value, F cb) const
+{
+    uint64_t bits = size();
+    uint64_t h1 = crc32c_update(value.data(), value.size(), ~0U);
+    uint64_t h2 = ((h1 * 0x9E3779B97F4A7C15ULL) >> 32) | 1;
+
+    for (uint8_t i = 0; i < m_hashes; i++) {
+        if (!cb((h1 + i * h2) % bits))
+            return false;
+    }
+
+    return true;
+}
+
+void CDNS::BloomFilter::add(const std::string& value)
+{
+    if (m_bits.empty())
+        throw std::runtime_error("Can't insert value to empty Bloom filter");
+
+    for_each_bit(value, [this](uint64_t bit) {
+        m_bits[bit / 8] |= static_cast<char>(1 << (bit % 8));
+        return true;
+    });
+}
+
+bool CDNS::BloomFilter::may_contain(const std::string& value) const
+{
+    if (m_bits.empty())
+        return false;
+
+    return for_each_bit(value, [this](uint64_t bit) {
+        return (m_bits[bit / 8] & (1 << (bit % 8))) != 0;
+    });
+}
+
+std::size_t CDNS::BloomFilter::write(CdnsEncoder& enc)
+{
+    std::size_t written = 0;
+
+    written += enc.write_array_start(2);
+    written += enc.write(m_hashes);
+    written += enc.write_bytestring(m_bits);
+
+    return written;
+}
+
+void CDNS::BloomFilter::read(CdnsDecoder& dec)
+{
+    bool indef = false;
+    uint64_t length = dec.read_array_start(indef);
+    if (length != 2 || indef)
+        throw CdnsDecoderException("Invalid structure of Bloom filter");
+
+    uint64_t hashes = dec.read_unsigned();
+    if (hashes > 16)
+        throw CdnsDecoderException("Too many hashes of Bloom filter");
+
+    m_hashes = static_cast<uint8_t>(hashes);
+    m_bits = dec.read_bytestring();
+}
+
+CDNS::BlockSummary::BlockSummary(const CdnsBlock& block, uint64_t index, unsigned bits_per_item)
+    : block_index(index), earliest_time(block.m_block_preamble.earliest_time), min_time(), max_time(),
+      qr_count(block.m_query_responses.size()), mm_count(block.m_malformed_messages.size()),
+      query_names(block.m_name_rdata.size(), bits_per_item),
+      client_addresses(block.m_ip_address.size(), bits_per_item), rcodes(), qtypes()
+{
+    for (auto& qr : block.m_query_responses) {
+        if (qr.time_offset)
+            update_time_span(*qr.time_offset, earliest_time, min_time, max_time);
+
+        if (qr.query_name_index)
+            query_names.add(block.m_name_rdata[*qr.query_name_index].data);
+
+        if (qr.client_address_index)
+            client_addresses.add(block.m_ip_address[*qr.client_address_index].data);
+
+        if (!qr.qr_signature_index)
+            continue;
+
+        const QueryResponseSignature& sig = block.m_qr_sig[*qr.qr_signature_index];
+        if (sig.response_rcode)
+            rcodes[*sig.response_rcode]++;
+
+        if (sig.query_classtype_index)
+            qtypes[block.m_classtype[*sig.query_classtype_index].type]++;
+    }
+
+    for (auto& mm : block.m_malformed_messages) {
+        if (mm.time_offset)
+            update_time_span(*mm.time_offset, earliest_time, min_time, max_time);
+
+        if (mm.client_address_index)
+            client_addresses.add(block.m_ip_address[*mm.client_address_index].data);
+    }
+}
+
+bool CDNS::BlockSummary::may_match(const ItemFilter& filter) const
+{
+    if (filter.time_range && !(min_time && *min_time < filter.time_range->end &&
+                               filter.time_range->start <= *max_time))
+        return false;
+
+    // Malformed messages have no query name
+    if (filter.query_name && !query_names.may_contain(*filter.query_name))
+        return false;
+
+    if (filter.client_ip && !client_addresses.may_contain(*filter.client_ip))
+        return false;
+
+    return true;
+}
+
+std::size_t CDNS::BlockSummary::write(CdnsEncoder& enc)
+{
+    std::size_t fields = 8 + !!min_time + !!max_time;
+    std::size_t written = 0;
+
+    // Start Block summary map
+    written += enc.write_map_start(fields);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::block_index));
+    written += enc.write(block_index);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::earliest_time));
+    written += earliest_time.write(enc);
+
+    if (min_time) {
+        written += enc.write(get_map_index(BlockSummaryMapIndex::min_time));
+        written += min_time->write(enc);
+    }
+
+    if (max_time) {
+        written += enc.write(get_map_index(BlockSummaryMapIndex::max_time));
+        written += max_time->write(enc);
+    }
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::qr_count));
+    written += enc.write(qr_count);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::mm_count));
+    written += enc.write(mm_count);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::query_names));
+    written += query_names.write(enc);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::client_addresses));
+    written += client_addresses.write(enc);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::rcodes));
+    written += write_histogram(enc, rcodes);
+
+    written += enc.write(get_map_index(BlockSummaryMapIndex::qtypes));
+    written += write_histogram(enc, qtypes);
+
+    return written;
+}
+
+void CDNS::BlockSummary::read(CdnsDecoder& dec)
+{
+    *this = BlockSummary();
+    bool indef = false;
+    uint64_t length = dec.read_map_start(indef);
+
+    while (length > 0 || indef) {
+        if (indef && dec.peek_type() == CborType::BREAK) {
+            dec.read_break();
+            break;
+        }
+
+        switch (dec.read_integer()) {
+            case get_map_index(BlockSummaryMapIndex::block_index):
+                block_index = dec.read_unsigned();
+                break;
+            case get_map_index(BlockSummaryMapIndex::earliest_time):
+                earliest_time.read(dec);
+                break;
+            case get_map_index(BlockSummaryMapIndex::min_time):
+                min_time = Timestamp();
+                min_time->read(dec);
+                break;
+            case get_map_index(BlockSummaryMapIndex::max_time):
+                max_time = Timestamp();
+                max_time->read(dec);
+                break;
+            case get_map_index(BlockSummaryMapIndex::qr_count):
+                qr_count = dec.read_unsigned();
+                break;
+            case get_map_index(BlockSummaryMapIndex::mm_count):
+                mm_count = dec.read_unsigned();
+                break;
+            case get_map_index(BlockSummaryMapIndex::query_names):
+                query_names.read(dec);
+                break;
+            case get_map_index(BlockSummaryMapIndex::client_addresses):
+                client_addresses.read(dec);
+                break;
+            case get_map_index(BlockSummaryMapIndex::rcodes):
+                read_histogram(dec, rcodes);
+                break;
+            case get_map_index(BlockSummaryMapIndex::qtypes):
+                read_histogram(dec, qtypes);
+                break;
+            default:
+                dec.skip_item();
+                break;
+        }
+
+        length--;
+    }
+
+    if (!min_time != !max_time)
+        throw CdnsDecoderException("Block summary has only one end of its time span");
+}
+
+CDNS::BlockSummaryWriter::~BlockSummaryWriter()
+{
+    try {
+        m_encoder.write_break();
+    }
+    catch (std::exception& e) {
+        std::cerr << "Couldn't write end break to Block summary output: " << e.what() << std::endl;
+    }
+}
+
+void CDNS::BlockSummaryWriter::write_header()
+{
+    m_encoder.write_array_start(2);
+    m_encoder.write_textstring("C-DNS-SUMMARY");
+    m_encoder.write_indef_array_start();
+}
+
+CDNS::BlockSummaryReader::BlockSummaryReader(std::istream& input)
+    : m_decoder(input), m_summaries_count(0), m_summaries_read(0), m_indef_summaries(false)
+{
+    bool indef = false;
+    uint64_t length = m_decoder.read_array_start(indef);
+    if (length != 2 && !indef)
+        throw CdnsDecoderException("Invalid structure of Block summary file");
+
+    std::string file_start = m_decoder.read_textstring();
+    if (file_start != "C-DNS-SUMMARY")
+        throw CdnsDecoderException(("Invalid Block summary file type ID: " + file_start).c_str());
+
+    m_summaries_count = m_decoder.read_array_start(m_indef_summaries);
+}
+
+CDNS::BlockSummary CDNS::BlockSummaryReader::read_summary(bool& eof)
+{
+    BlockSummary summary;
+
+    if (m_indef_summaries) {
+        if (m_decoder.peek_type() == CborType::BREAK) {
+            m_decoder.read_break();
+            m_indef_summaries = false;
+            m_summaries_count = m_summaries_read;
+        }
+    }
+
+    eof = !m_indef_summaries && m_summaries_read >= m_summaries_count;
+    if (eof)
+        return summary;
+
+    summary.read(m_decoder);
+    m_summaries_read++;
+    return summary;
+}
+
+std::vector<CDNS::BlockSummary> CDNS::BlockSummaryReader::read_summaries()
+{
+    std::vector<BlockSummary> ret;
+    bool eof = false;
+
+    while (true) {
+        BlockSummary summary = read_summary(eof);
+        if (eof)
+            break;
+
+        ret.push_back(std::move(summary));
+    }
+
+    return ret;
+}
@@ -0,0 +1,245 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <map>
+#include <vector>
+#include <istream>
+#include <boost/optional.hpp>
+
+#include "timestamp.h"
+#include "block.h"
+#include "cdns_encoder.h"
+#include "cdns_decoder.h"
+
+namespace CDNS {
+
+    /**
+     * @brief Map indexes of BlockSummary structure in Block summary file
+     */
+    enum class BlockSummaryMapIndex : uint8_t {
+        block_index = 0,
+        earliest_time = 1,
+        min_time = 2,
+        max_time = 3,
+        qr_count = 4,
+        mm_count = 5,
+        query_names = 6,
+        client_addresses = 7,
+        rcodes = 8,
+        qtypes = 9,
+
+        block_summary_size
+    };
+
+    /**
+     * @brief Bloom filter of byte strings
+     *
+     * Bits for each value are selected by double hashing from CRC32C of the value, so the filter gives
+     * the same results on all CPUs and can be stored to file.
+     */
+    class BloomFilter {
+        public:
+        BloomFilter() : m_hashes(0), m_bits() {}
+
+        /**
+         * @brief Construct a new empty BloomFilter object
+         * @param items Expected number of values inserted to the filter
+         * @param bits_per_item Number of filter's bits per inserted value (10 bits give about 1 %
+         * of false positives)
+         */
+        BloomFilter(std::size_t items, unsigned bits_per_item);
+
+        /**
+         * @brief Insert value to the filter
+         * @param value Value to insert
+         */
+        void add(const std::string& value);
+
+        /**
+         * @brief Check if value may have been inserted to the filter
+         * @param value Value to check
+         * @return `false` if the value definitely wasn't inserted to the filter, `true` otherwise
+         */
+        bool may_contain(const std::string& value) const;
+
+        /**
+         * @brief Get size of the filter in bits
+         */
+        std::size_t size() const { return m_bits.size() * 8; }
+
+        /**
+         * @brief Serialize the filter to C-DNS CBOR representation
+         * @param enc C-DNS encoder
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write(CdnsEncoder& enc);
+
+        /**
+         * @brief Read the filter from C-DNS CBOR input stream
+         * @param dec C-DNS decoder
+         */
+        void read(CdnsDecoder& dec);
+
+        private:
+        /**
+         * @brief Call function for each bit selected for given value
+         * @param value Value to select the bits for
+         * @param cb Function called with index of each selected bit
+         * @return `false` if the function returned `false` for some bit, `true` otherwise
+         */
+        template<typename F>
+        bool for_each_bit(const std::string& value, F cb) const;
+
+        uint8_t m_hashes; //!< Number of bits set for each value
+        std::string m_bits; //!< Bits of the filter
+    };
+
+    /**
+     * @brief Summary of one C-DNS Block used to decide if the Block has to be read when searching
+     * for items matching ItemFilter
+     *
+     * Summary contains time span of the Block's items, Bloom filters of query names and client IP
+     * addresses and histograms of response RCODEs and query types of Query/Responses.
+     */
+    struct BlockSummary {
+        BlockSummary() : block_index(0), earliest_time(), min_time(), max_time(), qr_count(0), mm_count(0),
+                         query_names(), client_addresses(), rcodes(), qtypes() {}
+
+        /**
+         * @brief Construct a new BlockSummary object summarizing given Block
+         *
+         * Items' timestamps have to be absolute, as in a Block being built or a Block read by
+         * CdnsBlockRead::read() which resolves the time offsets. Block read with ItemFilter contains
+         * only the matching items, so its summary doesn't describe the Block in C-DNS file.
+         * @param block C-DNS Block to summarize
+         * @param index Index of the Block in C-DNS file
+         * @param bits_per_item Number of Bloom filters' bits per distinct value
+         * @throw std::invalid_argument if some item's timestamp is earlier than Block's earliest time
+         * (i.e. it is unresolved time offset)
+         */
+        BlockSummary(const CdnsBlock& block, uint64_t index, unsigned bits_per_item = 10);
+
+        /**
+         * @brief Check if the summarized Block may contain items matching given filter
+         * @param filter Filter of items
+         * @return `false` if the Block definitely doesn't contain any Query/Response or Malformed message
+         * matching the filter, `true` otherwise
+         */
+        bool may_match(const ItemFilter& filter) const;
+
+        /**
+         * @brief Serialize the BlockSummary to C-DNS CBOR representation
+         * @param enc C-DNS encoder
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write(CdnsEncoder& enc);
+
+        /**
+         * @brief Read the BlockSummary from C-DNS CBOR input stream
+         * @param dec C-DNS decoder
+         */
+        void read(CdnsDecoder& dec);
+
+        uint64_t block_index; //!< Index of the Block in C-DNS file
+        Timestamp earliest_time; //!< Earliest time from Block preamble
+        boost::optional<Timestamp> min_time; //!< Time of the earliest item with timestamp
+        boost::optional<Timestamp> max_time; //!< Time of the latest item with timestamp
+        uint64_t qr_count; //!< Number of Query/Responses in the Block
+        uint64_t mm_count; //!< Number of Malformed messages in the Block
+        BloomFilter query_names; //!< Query names of Query/Responses (in DNS wire format)
+        BloomFilter client_addresses; //!< Client IP addresses of Query/Responses and Malformed messages
+        std::map<uint16_t, uint64_t> rcodes; //!< Numbers of Query/Responses by response RCODE
+        std::map<uint16_t, uint64_t> qtypes; //!< Numbers of Query/Responses by query type
+    };
+
+    /**
+     * @brief Writer of Block summary file, a sidecar file with BlockSummary of each Block of one
+     * C-DNS file
+     *
+     * Block summary file is CBOR array of File type ID "C-DNS-SUMMARY" and indefinite length array
+     * of Block summaries.
+     */
+    class BlockSummaryWriter {
+        public:
+        /**
+         * @brief Construct a new BlockSummaryWriter object and write start of the Block summary file
+         * @param out Output to open (file name[std::string] or file descriptor[int])
+         * @throw CborOutputException if output initialization fails
+         */
+        template<typename T>
+        explicit BlockSummaryWriter(const T& out) : m_encoder(out, CborOutputCompression::NO_COMPRESSION) {
+            write_header();
+        }
+
+        /**
+         * @brief Destroy the BlockSummaryWriter object and write the end of Block summary file
+         */
+        ~BlockSummaryWriter();
+
+        /** Delete [move] copy constructors and assignment operators */
+        BlockSummaryWriter(BlockSummaryWriter& copy) = delete;
+        BlockSummaryWriter(BlockSummaryWriter&& copy) = delete;
+        BlockSummaryWriter& operator=(BlockSummaryWriter& rhs) = delete;
+        BlockSummaryWriter& operator=(BlockSummaryWriter&& rhs) = delete;
+
+        /**
+         * @brief Write Block summary to output
+         * @param summary Block summary to write
+         * @return Number of bytes written
+         */
+        std::size_t write(BlockSummary& summary) {
+            return summary.write(m_encoder);
+        }
+
+        private:
+        /**
+         * @brief Write start of Block summary file
+         */
+        void write_header();
+
+        CdnsEncoder m_encoder;
+    };
+
+    /**
+     * @brief Reader of Block summary file written by BlockSummaryWriter
+     */
+    class BlockSummaryReader {
+        public:
+        /**
+         * @brief Construct a new BlockSummaryReader object and read start of the Block summary file
+         * @param input Input stream with Block summary file
+         * @throw CdnsDecoderException if the input isn't Block summary file
+         */
+        explicit BlockSummaryReader(std::istream& input);
+
+        /**
+         * @brief Read next Block summary
+         * @param eof Set to `true` if the end of Block summary file was reached and returned summary
+         * is empty, `false` otherwise
+         * @return Next Block summary
+         */
+        BlockSummary read_summary(bool& eof);
+
+        /**
+         * @brief Read all remaining Block summaries
+         * @return Remaining Block summaries in the order they were written
+         */
+        std::vector<BlockSummary> read_summaries();
+
+        private:
+        CdnsDecoder m_decoder;
+        uint64_t m_summaries_count;
+        uint64_t m_summaries_read;
+        bool m_indef_summaries;
+    };
+}
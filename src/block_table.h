@@ -16,9 +16,12 @@
 #include <deque>
 #include <unordered_map>
 #include <stdexcept>
+#include <memory>
+#include <string>
 
 #include "hash.h"
 #include "format_specification.h"
+#include "cdns_encoder.h"
 
 namespace CDNS {
 
@@ -70,6 +73,14 @@ namespace CDNS {
             return hash_func(k.key_);
         }
 
+        /**
+         * @brief Get the referenced item.
+         */
+        const T& get() const
+        {
+            return key_;
+        }
+
     private:
         /**
          * @brief reference to the item
@@ -77,16 +88,76 @@ namespace CDNS {
         const T& key_;
     };
 
+    /**
+     * @brief Hash of KeyRef calculated by given hash function of the referenced item.
+     */
+    template<typename K, typename H>
+    struct KeyRefHash
+    {
+        std::size_t operator()(const KeyRef<K>& k) const
+        {
+            return H()(k.get());
+        }
+    };
+
     /**
      * @brief Representation of one block table's table
+     *
+     * Table can encode each item to CBOR right when it's inserted (see set_pre_encode()). Items
+     * are immutable once inserted, so write() then only copies the pre-encoded bytes to the output.
+     *
+     * Hash function of the keys can be selected by the H parameter. The default CDNS::hash uses CRC32C
+     * implementation selected according to the CPU.
      */
-    template<typename T, typename K = T>
+    template<typename T, typename K = T, typename H = CDNS::hash<K>>
     class BlockTable {
     public:
         /**
          * @brief Default constructor.
          */
-        explicit BlockTable() {}
+        explicit BlockTable()
+            : items_(), indexes_(), encoded_(), encode_(nullptr), lookups_(0) {}
+
+        /**
+         * @brief Copy constructor. Map of keys is rebuilt to reference the copied items.
+         *
+         * @param copy the table to copy.
+         */
+        BlockTable(const BlockTable& copy)
+            : items_(copy.items_), indexes_(), encoded_(), encode_(nullptr), lookups_(copy.lookups_)
+        {
+            rebuild_indexes();
+            set_pre_encode(copy.pre_encoded());
+        }
+
+        /**
+         * @brief Move constructor. Items of std::deque aren't relocated by move,
+         * so the map of keys stays valid.
+         */
+        BlockTable(BlockTable&& copy) = default;
+
+        /**
+         * @brief Assignment operator. Map of keys is rebuilt to reference the copied items.
+         *
+         * @param rhs the table to copy.
+         */
+        BlockTable& operator=(const BlockTable& rhs)
+        {
+            if ( this != &rhs )
+            {
+                items_ = rhs.items_;
+                lookups_ = rhs.lookups_;
+                rebuild_indexes();
+                encoded_.reset();
+                set_pre_encode(rhs.pre_encoded());
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment operator.
+         */
+        BlockTable& operator=(BlockTable&& rhs) = default;
 
         /**
          * @brief Find if a key value is in the list
@@ -97,6 +168,7 @@ namespace CDNS {
          */
         bool find(const K& key, index_t& index)
         {
+            lookups_++;
             auto find = indexes_.find(KeyRef<K>(key));
             if ( find != indexes_.end() )
             {
@@ -121,6 +193,7 @@ namespace CDNS {
         CDNS::index_t add_value(const T& val)
         {
             items_.push_back(val);
+            encode_last();
             return record_last_key();
         }
 
@@ -136,6 +209,7 @@ namespace CDNS {
         CDNS::index_t add_value(T&& val)
         {
             items_.push_back(val);
+            encode_last();
             return record_last_key();
         }
 
@@ -150,11 +224,12 @@ namespace CDNS {
          */
         CDNS::index_t add(const T& val)
         {
-            const K& key = val.key();
-            CDNS::index_t res;
-            if ( !find(key, res) )
-                res = add_value(val);
-            return res;
+            lookups_++;
+            auto find = indexes_.find(KeyRef<K>(val.key()));
+            if ( find != indexes_.end() )
+                return find->second;
+
+            return add_value(val);
         }
 
         /**
@@ -163,9 +238,68 @@ namespace CDNS {
         void clear()
         {
             items_.clear();
+            lookups_ = 0;
+            if ( encoded_ )
+            {
+                encoded_->encoder.flush();
+                encoded_->bytes.clear();
+            }
             indexes_.clear();
         }
 
+        /**
+         * @brief Enable or disable encoding of items to CBOR at insert time.
+         *
+         * Items already in the table are encoded when pre-encoding is enabled.
+         *
+         * @param enable `true` to keep pre-encoded items, `false` to encode them in write().
+         */
+        void set_pre_encode(bool enable)
+        {
+            if ( !enable )
+            {
+                encoded_.reset();
+                return;
+            }
+
+            if ( encoded_ )
+                return;
+
+            encode_ = &encode_item;
+            encoded_ = std::make_unique<PreEncoded>();
+            for ( auto& item : items_ )
+                encode_(item, encoded_->encoder);
+        }
+
+        /**
+         * @brief Check if items are encoded at insert time.
+         */
+        bool pre_encoded() const
+        {
+            return !!encoded_;
+        }
+
+        /**
+         * @brief Write the table as CBOR array of its items.
+         *
+         * @param enc C-DNS encoder.
+         * @returns number of uncompressed bytes written.
+         */
+        std::size_t write(CdnsEncoder& enc)
+        {
+            std::size_t written = enc.write_array_start(items_.size());
+
+            if ( encoded_ )
+            {
+                encoded_->encoder.flush();
+                return written + enc.write_raw(encoded_->bytes);
+            }
+
+            for ( auto& item : items_ )
+                written += item.write(enc);
+            return written;
+        }
+
         /**
          * @brief Get the indexed item.
          * 
@@ -188,6 +322,16 @@ namespace CDNS {
             return items_.size();
         }
 
+        /**
+         * @brief Get the number of key lookups by add() and find() since the last clear().
+         *
+         * Lookups that didn't insert a new item are deduplication hits.
+         */
+        uint64_t lookups() const
+        {
+            return lookups_;
+        }
+
         /**
          * @brief Iterator begin
          * 
@@ -209,6 +353,37 @@ namespace CDNS {
         }
 
     private:
+        /**
+         * @brief CBOR encoded items together with encoder appending to them.
+         *
+         * Encoder is declared last, so it's flushed before the bytes are destroyed.
+         */
+        struct PreEncoded
+        {
+            PreEncoded() : bytes(), encoder(bytes) {}
+
+            std::string bytes;
+            CdnsEncoder encoder;
+        };
+
+        /**
+         * @brief Encode item to CBOR. Instantiated only if pre-encoding is enabled,
+         * so items without write() can be stored in the table too.
+         */
+        static std::size_t encode_item(T& item, CdnsEncoder& enc)
+        {
+            return item.write(enc);
+        }
+
+        /**
+         * @brief Encode the latest item in the vector if pre-encoding is enabled.
+         */
+        void encode_last()
+        {
+            if ( encoded_ )
+                encode_(items_.back(), encoded_->encoder);
+        }
+
         /**
          * @brief Record the key to the latest item in the vector.
          * 
@@ -222,7 +397,20 @@ namespace CDNS {
             return res;
         }
 
+        /**
+         * @brief Rebuild the map of keys to reference the current items.
+         */
+        void rebuild_indexes()
+        {
+            indexes_.clear();
+            for ( CDNS::index_t i = 0; i < items_.size(); i++ )
+                indexes_[KeyRef<K>(items_[i].key())] = i;
+        }
+
         std::deque<T> items_;
-        std::unordered_map<KeyRef<K>, CDNS::index_t, CDNS::hash<KeyRef<K>>> indexes_;
+        std::unordered_map<KeyRef<K>, CDNS::index_t, KeyRefHash<K, H>> indexes_;
+        std::unique_ptr<PreEncoded> encoded_; //!< Pre-encoded items, if enabled
+        std::size_t (*encode_)(T&, CdnsEncoder&);
+        uint64_t lookups_;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,155 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+#include "cbor_scanner.h"
+#include "cdns_decoder.h"
+
+namespace {
+    constexpr uint64_t INDEF_ITEMS = UINT64_MAX;
+
+    /**
+     * @brief Get size of CBOR item head (including the following integer value) from its first byte
+     */
+    inline std::size_t head_size(uint8_t first)
+    {
+        uint8_t additional = first & 0x1F;
+        if (additional >= 24 && additional <= 27)
+            return 1 + (1 << (additional - 24));
+
+        return 1;
+    }
+}
+
+std::size_t CDNS::CborScanner::scan(const uint8_t* data, std::size_t size)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+
+    while (true) {
+        // Skip payload of string
+        if (m_pending > 0) {
+            std::size_t skip = std::min<uint64_t>(m_pending, end - p);
+            p += skip;
+            m_pending -= skip;
+            if (m_pending > 0)
+                break;
+        }
+
+        // Close finished containers
+        while (m_left == 0 && !m_enclosing.empty()) {
+            m_left = m_enclosing.back();
+            m_enclosing.pop_back();
+        }
+
+        if (m_left == 0 || p == end)
+            break;
+
+        // Finish item head split between input chunks
+        if (m_head_size > 0) {
+            std::size_t needed = head_size(m_head[0]) - m_head_size;
+            std::size_t available = std::min<std::size_t>(needed, end - p);
+            std::memcpy(m_head + m_head_size, p, available);
+            m_head_size += available;
+            p += available;
+            if (available < needed)
+                break;
+
+            m_head_size = 0;
+            process_head(m_head);
+            continue;
+        }
+
+        std::size_t head = head_size(*p);
+        if (static_cast<std::size_t>(end - p) < head) {
+            m_head_size = end - p;
+            std::memcpy(m_head, p, m_head_size);
+            p = end;
+            break;
+        }
+
+        process_head(p);
+        p += head;
+    }
+
+    return p - data;
+}
+
+void CDNS::CborScanner::process_head(const uint8_t* head)
+{
+    CborType cbor_type = static_cast<CborType>(head[0] & 0xE0);
+    uint8_t additional = head[0] & 0x1F;
+
+    if (static_cast<CborType>(head[0]) == CborType::BREAK) {
+        if (m_left != INDEF_ITEMS || m_enclosing.empty())
+            throw CdnsDecoderException("Unexpected CBOR break");
+
+        m_left = m_enclosing.back();
+        m_enclosing.pop_back();
+        return;
+    }
+    else if (additional >= 28 && (additional != 31 || cbor_type < CborType::BYTE_STRING ||
+                                  cbor_type > CborType::MAP)) {
+        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
+                                    std::to_string(additional)).c_str());
+    }
+
+    uint64_t value = additional;
+    if (additional >= 24 && additional <= 27) {
+        value = 0;
+        for (int i = 1; i <= 1 << (additional - 24); i++)
+            value = (value << 8) | head[i];
+    }
+
+    // Tag is followed by the tagged item, count that one instead
+    if (cbor_type == CborType::TAG)
+        return;
+
+    if (m_left != INDEF_ITEMS)
+        m_left--;
+
+    switch (cbor_type) {
+        case CborType::BYTE_STRING:
+        case CborType::TEXT_STRING:
+            if (additional == 31) {
+                // Chunks of indefinite length string are scanned as items until "break"
+                m_enclosing.push_back(m_left);
+                m_left = INDEF_ITEMS;
+            }
+            else {
+                m_pending = value;
+            }
+            break;
+
+        case CborType::ARRAY:
+        case CborType::MAP:
+            if (additional != 31) {
+                if (cbor_type == CborType::MAP) {
+                    if (value > (INDEF_ITEMS - 1) / 2)
+                        throw CdnsDecoderException("Too many items in CBOR map");
+                    value *= 2;
+                }
+                else if (value == INDEF_ITEMS) {
+                    throw CdnsDecoderException("Too many items in CBOR array");
+                }
+            }
+            else {
+                value = INDEF_ITEMS;
+            }
+
+            m_enclosing.push_back(m_left);
+            m_left = value;
+            break;
+
+        default:
+            break;
+    }
+}
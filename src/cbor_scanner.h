@@ -0,0 +1,102 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <boost/container/small_vector.hpp>
+
+namespace CDNS {
+
+    /**
+     * @brief Structural scanner finding boundaries of CBOR items without decoding their values
+     *
+     * The scanner walks only CBOR item heads, skips string payloads and tracks nesting of arrays
+     * and maps, so it can tell where given number of consecutive CBOR items end. It's resumable:
+     * input can be fed in arbitrarily split chunks, items and even item heads can span several chunks.
+     */
+    class CborScanner {
+        public:
+        /**
+         * @brief Construct a new CborScanner object
+         * @param items Number of consecutive CBOR items to scan
+         */
+        explicit CborScanner(uint64_t items = 1) { reset(items); }
+
+        /**
+         * @brief Start scanning of new consecutive CBOR items
+         * @param items Number of consecutive CBOR items to scan
+         */
+        void reset(uint64_t items = 1) {
+            m_left = items;
+            m_enclosing.clear();
+            m_pending = 0;
+            m_head_size = 0;
+        }
+
+        /**
+         * @brief Scan next chunk of input
+         * @param data Start of the chunk
+         * @param size Size of the chunk in bytes
+         * @throw CdnsDecoderException if malformed CBOR data are encountered
+         * @return Number of bytes of the chunk belonging to scanned items. It's less than `size` only
+         * if all items were scanned (i.e. done() returns `true`).
+         */
+        std::size_t scan(const uint8_t* data, std::size_t size);
+
+        /**
+         * @brief Check if all items were scanned
+         */
+        bool done() const {
+            return m_left == 0 && m_enclosing.empty() && m_pending == 0 && m_head_size == 0;
+        }
+
+        /**
+         * @brief Get number of string payload bytes the scanner is going to skip before the next item head
+         */
+        uint64_t pending_bytes() const { return m_pending; }
+
+        /**
+         * @brief Let the caller skip string payload bytes pending in the scanner by other means
+         * (e.g. by seeking in input stream). Input fed to scan() has to continue after the skipped bytes.
+         * @return Number of bytes the caller has to skip
+         */
+        uint64_t take_pending_bytes() {
+            uint64_t pending = m_pending;
+            m_pending = 0;
+            return pending;
+        }
+
+        /**
+         * @brief Get size of complete CBOR item at the start of given buffer
+         * @param data Start of the buffer
+         * @param size Size of the buffer in bytes
+         * @throw CdnsDecoderException if malformed CBOR data are encountered
+         * @return Size of the CBOR item in bytes or 0 if the item doesn't end within the buffer
+         */
+        static std::size_t item_size(const uint8_t* data, std::size_t size) {
+            CborScanner scanner;
+            std::size_t scanned = scanner.scan(data, size);
+            return scanner.done() ? scanned : 0;
+        }
+
+        private:
+        /**
+         * @brief Process complete item head
+         * @param head Start of the item head
+         */
+        void process_head(const uint8_t* head);
+
+        uint64_t m_left; //!< Items left in the innermost container (UINT64_MAX if of indefinite length)
+        boost::container::small_vector<uint64_t, 16> m_enclosing; //!< Items left in enclosing containers
+        uint64_t m_pending; //!< String payload bytes to skip before the next item head
+        uint8_t m_head[9]; //!< Item head split between input chunks
+        uint8_t m_head_size; //!< Number of bytes of the split item head in m_head
+    };
+}
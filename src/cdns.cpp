@@ -7,10 +7,11 @@
  */
 
 #include <algorithm>
+#include <climits>
 
 #include "cdns.h"
 
-std::size_t CDNS::CdnsExporter::write_block(CdnsBlock& block)
+std::size_t CDNS::CdnsExporter::write_block_to_output(CdnsBlock& block)
 {
     if (block.get_item_count() == 0)
         return 0;
@@ -18,16 +19,194 @@ std::size_t CDNS::CdnsExporter::write_block(CdnsBlock& block)
     std::size_t written = 0;
 
     // If it's the first Block in current output write start of the C-DNS file
-    if (m_blocks_written == 0)
+    if (m_blocks_written == 0) {
         written += write_file_header();
+        m_encoder.commit();
+    }
+
+    // Record items dropped by output queue since the last written Block
+    uint64_t dropped = m_encoder.take_dropped_items();
+    if (dropped > 0) {
+        if (!block.m_block_statistics)
+            block.m_block_statistics = BlockStatistics();
+
+        block.m_block_statistics->dropped_items = block.m_block_statistics->dropped_items.value_or(0) + dropped;
+    }
+
+    BlockMetrics metrics;
+    metrics.qr_count = block.get_qr_count();
+    metrics.aec_count = block.get_aec_count();
+    metrics.mm_count = block.get_mm_count();
+    metrics.tables = block.get_table_metrics();
+
+    // Synchronous output compresses and writes the Block while it's being encoded
+    std::chrono::nanoseconds output_before(0);
+    if (!m_encoder.is_async())
+        output_before = m_encoder.get_output_time();
+    std::chrono::nanoseconds blocked_before = m_encoder.get_blocked_time();
+    auto start = std::chrono::steady_clock::now();
 
     // Write the given C-DNS block to output
-    written += block.write(m_encoder);
+    std::size_t block_written = block.write(m_encoder);
     m_blocks_written++;
 
+    // If the Block gets dropped, the count of previously dropped items is carried over to the next Block
+    metrics.dropped = !m_encoder.commit(block.get_item_count(), true, dropped);
+    if (!metrics.dropped) {
+        written += block_written;
+        write_block_summary(block);
+        m_summary_block_index++;
+    }
+
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    if (!m_encoder.is_async())
+        metrics.output_time = m_encoder.get_output_time() - output_before;
+    metrics.blocked_time = m_encoder.get_blocked_time() - blocked_before;
+    metrics.encode_time = elapsed - metrics.output_time - metrics.blocked_time;
+    metrics.bytes = block_written;
+
+    m_metrics.blocks_written++;
+    m_metrics.uncompressed_bytes += written;
+    m_metrics.encode_time += metrics.encode_time;
+    m_metrics.last_block = metrics;
+
+    if (m_metrics_callback)
+        m_metrics_callback(metrics);
+
+    m_bytes_written += written;
     return written;
 }
 
+std::size_t CDNS::CdnsExporter::write_block(CdnsRawBlock& block)
+{
+    if (block.get_block_parameters_index() >= m_file_preamble.block_parameters_size())
+        throw CdnsEncoderException("Block parameters index of raw C-DNS block is too high");
+
+    // Raw Blocks (e.g. copied by CdnsMerger) don't go through buffer_*() methods, check time based rotation here
+    std::size_t written = check_rotation();
+
+    // If it's the first Block in current output write start of the C-DNS file
+    if (m_blocks_written == 0) {
+        written += write_file_header();
+        m_encoder.commit();
+    }
+
+    BlockMetrics metrics;
+    metrics.qr_count = block.get_qr_count();
+    metrics.aec_count = block.get_aec_count();
+    metrics.mm_count = block.get_mm_count();
+
+    std::chrono::nanoseconds output_before(0);
+    if (!m_encoder.is_async())
+        output_before = m_encoder.get_output_time();
+    std::chrono::nanoseconds blocked_before = m_encoder.get_blocked_time();
+    auto start = std::chrono::steady_clock::now();
+
+    // Copy the raw C-DNS block to output
+    std::size_t block_written = block.write(m_encoder);
+    m_blocks_written++;
+
+    metrics.dropped = !m_encoder.commit(block.get_item_count(), true);
+    if (!metrics.dropped) {
+        written += block_written;
+        m_summary_block_index++;
+    }
+
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    if (!m_encoder.is_async())
+        metrics.output_time = m_encoder.get_output_time() - output_before;
+    metrics.blocked_time = m_encoder.get_blocked_time() - blocked_before;
+    metrics.encode_time = elapsed - metrics.output_time - metrics.blocked_time;
+    metrics.bytes = block_written;
+
+    m_metrics.blocks_written++;
+    m_metrics.uncompressed_bytes += written;
+    m_metrics.encode_time += metrics.encode_time;
+    m_metrics.last_block = metrics;
+
+    if (m_metrics_callback)
+        m_metrics_callback(metrics);
+
+    m_bytes_written += written;
+    return written + check_size_rotation();
+}
+
+void CDNS::CdnsExporter::set_rotation_parameters(const RotationParameters& rp)
+{
+    if (rp.name_template.empty())
+        throw CdnsEncoderException("Name template for rotated output files is empty");
+
+    if (m_output_name.empty())
+        throw CdnsEncoderException("Output specified by file descriptor can't be rotated automatically");
+
+    m_rotation = rp;
+
+    // Align time based rotation to wall clock
+    if (rp.interval != 0) {
+        time_t now = ::time(nullptr);
+        m_next_rotation = now - now % rp.interval + rp.interval;
+    }
+    else
+        m_next_rotation = 0;
+}
+
+std::size_t CDNS::CdnsExporter::rotate_by_policy(bool export_current_block)
+{
+    time_t now = ::time(nullptr);
+    time_t ts = now;
+
+    // Name output files from time based rotation by the start of their interval
+    if (m_next_rotation != 0) {
+        if (now >= m_next_rotation)
+            m_next_rotation = now - now % m_rotation->interval + m_rotation->interval;
+
+        ts = m_next_rotation - m_rotation->interval;
+    }
+
+    return rotate_output(next_output_name(ts), export_current_block);
+}
+
+std::string CDNS::CdnsExporter::next_output_name(time_t ts)
+{
+    const std::string& tmpl = m_rotation->name_template;
+    std::string format;
+
+    // Replace "%N" with sequence number and keep other conversions for strftime()
+    for (std::size_t i = 0; i < tmpl.size(); i++) {
+        if (tmpl[i] == '%' && i + 1 < tmpl.size()) {
+            if (tmpl[i + 1] == 'N')
+                format += std::to_string(m_rotation_seq);
+            else
+                format += tmpl.substr(i, 2);
+
+            i++;
+        }
+        else
+            format += tmpl[i];
+    }
+
+    struct tm tm;
+    char name[PATH_MAX];
+    gmtime_r(&ts, &tm);
+    if (strftime(name, sizeof(name), format.c_str(), &tm) == 0)
+        throw CborOutputException("Couldn't create name of the rotated output file");
+
+    m_rotation_seq++;
+    return std::string(name);
+}
+
+void CDNS::CdnsExporter::write_block_summary(const CdnsBlock& block)
+{
+    if (m_summary_suffix.empty() || m_output_name.empty())
+        return;
+
+    if (!m_summary_writer)
+        m_summary_writer = std::make_unique<BlockSummaryWriter>(m_output_name + m_summary_suffix);
+
+    BlockSummary summary(block, m_summary_block_index, m_summary_bits);
+    m_summary_writer->write(summary);
+}
+
 std::size_t CDNS::CdnsExporter::write_file_header()
 {
     std::size_t written = 0;
@@ -71,22 +250,103 @@ void CDNS::CdnsReader::read_file_header()
 CDNS::CdnsBlockRead CDNS::CdnsReader::read_block(bool& eof)
 {
     CdnsBlockRead block;
-    eof = false;
+    read_block(block, eof);
+    return block;
+}
+
+void CDNS::CdnsReader::read_block(CdnsBlockRead& block, bool& eof)
+{
+    while (true) {
+        eof = blocks_end();
+        if (eof) {
+            block.clear();
+            return;
+        }
+
+        if (m_filter.empty()) {
+            block.read(m_decoder, m_file_preamble.m_block_parameters);
+            m_blocks_read++;
+            return;
+        }
+
+        const BlockSummary* summary = next_block_summary();
+        bool in_range = false;
+        if (summary && !summary->may_match(m_filter)) {
+            m_decoder.skip_item();
+            m_blocks_skipped++;
+            block.clear();
+            block.m_block_preamble.earliest_time = summary->earliest_time;
+        }
+        else {
+            in_range = block.read(m_decoder, m_file_preamble.m_block_parameters, m_filter);
+        }
+
+        m_blocks_read++;
+        if (in_range)
+            return;
+
+        // Following Blocks ordered by time can't contain any item within the range
+        if (m_time_ordered && m_filter.time_range && m_filter.time_range->end <= block.m_block_preamble.earliest_time) {
+            m_indef_blocks = false;
+            m_blocks_count = m_blocks_read;
+        }
+    }
+}
+
+const CDNS::BlockSummary* CDNS::CdnsReader::next_block_summary()
+{
+    while (m_next_summary < m_summaries.size() && m_summaries[m_next_summary].block_index < m_blocks_read)
+        m_next_summary++;
+
+    if (m_next_summary < m_summaries.size() && m_summaries[m_next_summary].block_index == m_blocks_read)
+        return &m_summaries[m_next_summary];
 
+    return nullptr;
+}
+
+CDNS::CdnsRawBlock CDNS::CdnsReader::read_raw_block(bool& eof)
+{
+    CdnsRawBlock block;
+    read_raw_block(block, eof);
+    return block;
+}
+
+void CDNS::CdnsReader::read_raw_block(CdnsRawBlock& block, bool& eof)
+{
+    eof = blocks_end();
+    if (eof) {
+        block.clear();
+        return;
+    }
+
+    block.read(m_decoder, m_file_preamble.m_block_parameters.size());
+    m_blocks_read++;
+}
+
+CDNS::BlockItemCounts CDNS::CdnsReader::read_block_counts(bool& eof)
+{
+    BlockItemCounts counts;
+    eof = blocks_end();
+    if (eof)
+        return counts;
+
+    counts.read(m_decoder);
+    m_blocks_read++;
+
+    return counts;
+}
+
+bool CDNS::CdnsReader::blocks_end()
+{
     if (m_indef_blocks && m_decoder.peek_type() == CborType::BREAK) {
         m_decoder.read_break();
-        eof = true;
         m_indef_blocks = false;
         m_blocks_count = m_blocks_read;
-        return block;
+        return true;
     }
     else if (!m_indef_blocks && m_blocks_read == m_blocks_count) {
-        eof = true;
-        return block;
+        return true;
     }
 
-    block.read(m_decoder, m_file_preamble.m_block_parameters);
-    m_blocks_read++;
-
-    return block;
+    return false;
 }
\ No newline at end of file
@@ -15,6 +15,8 @@
 #include <istream>
 #include <iostream>
 #include <sys/socket.h>
+#include <chrono>
+#include <functional>
 
 #include "format_specification.h"
 #include "dns.h"
@@ -22,14 +24,81 @@
 #include "file_preamble.h"
 #include "block.h"
 #include "hash.h"
+#include "compact_optional.h"
 #include "interface.h"
 #include "timestamp.h"
 #include "writer.h"
 #include "cdns_encoder.h"
 #include "cdns_decoder.h"
+#include "cbor_scanner.h"
+#include "block_summary.h"
+#include "anonymizer.h"
+#include "query_response_builder.h"
+#include "dns_parser.h"
+#include "query_response_matcher.h"
+#include "traffic_generator.h"
+#include "cdns_merger.h"
 
 namespace CDNS {
 
+    /**
+     * @brief Policies for automatic rotation of output files by CdnsExporter
+     *
+     * Output is rotated when any of the enabled conditions is met. Rotation is always done on Block
+     * boundary. Names of the new output files are created from name_template by strftime() (in UTC)
+     * with "%N" replaced by sequence number of the rotation.
+     */
+    struct RotationParameters {
+        RotationParameters() : interval(0), max_bytes(0), max_blocks(0), name_template() {}
+
+        uint64_t interval; //!< Rotate every N seconds aligned to wall clock (0 = disabled)
+        uint64_t max_bytes; //!< Rotate after N uncompressed bytes were written to current output (0 = disabled)
+        uint64_t max_blocks; //!< Rotate after N Blocks were written to current output (0 = disabled)
+        std::string name_template; //!< Template for names of new output files, e.g. "dns-%Y%m%d-%H%M%S-%N.cdns"
+    };
+
+    /**
+     * @brief Statistics of one Block written to output by CdnsExporter
+     */
+    struct BlockMetrics {
+        BlockMetrics() : qr_count(0), aec_count(0), mm_count(0), bytes(0), encode_time(0), output_time(0),
+                         blocked_time(0), dropped(false), tables() {}
+
+        std::size_t qr_count; //!< Number of Query/Response items in the Block
+        std::size_t aec_count; //!< Number of Address Event Count items in the Block
+        std::size_t mm_count; //!< Number of Malformed Message items in the Block
+        std::size_t bytes; //!< Uncompressed size of the Block in bytes
+        std::chrono::nanoseconds encode_time; //!< Time of encoding the Block to CBOR
+        std::chrono::nanoseconds output_time; //!< Time of compression and writing (0 for asynchronous output)
+        std::chrono::nanoseconds blocked_time; //!< Time spent waiting for room in asynchronous output queue
+        bool dropped; //!< `true` if the Block was dropped when inserted to asynchronous output queue (not later)
+        BlockTablesMetrics tables; //!< Sizes and deduplication statistics of Block tables
+    };
+
+    /**
+     * @brief Cumulative statistics of CdnsExporter since its construction
+     */
+    struct ExporterMetrics {
+        ExporterMetrics() : qr_items(0), aec_items(0), mm_items(0), blocks_written(0), blocks_dropped(0),
+                            dropped_items(0), uncompressed_bytes(0), output_bytes(0), encode_time(0),
+                            output_time(0), blocked_time(0), queued_blocks(0), queued_bytes(0), last_block() {}
+
+        uint64_t qr_items; //!< Number of Query/Response items given to buffer_qr() and buffer_wire_qr()
+        uint64_t aec_items; //!< Number of Address Event Count items given to buffer_aec()
+        uint64_t mm_items; //!< Number of Malformed Message items given to buffer_mm()
+        uint64_t blocks_written; //!< Number of Blocks encoded to output (including dropped Blocks)
+        uint64_t blocks_dropped; //!< Number of Blocks dropped by asynchronous output queue (new or already queued)
+        uint64_t dropped_items; //!< Number of items dropped by asynchronous output queue
+        uint64_t uncompressed_bytes; //!< Number of uncompressed bytes written to all outputs
+        uint64_t output_bytes; //!< Number of bytes written to all outputs after compression
+        std::chrono::nanoseconds encode_time; //!< Total time of encoding Blocks to CBOR
+        std::chrono::nanoseconds output_time; //!< Total time of compression and writing to output
+        std::chrono::nanoseconds blocked_time; //!< Total time spent waiting for room in output queue
+        std::size_t queued_blocks; //!< Current number of Blocks in asynchronous output queue
+        std::size_t queued_bytes; //!< Current number of uncompressed bytes in asynchronous output queue
+        BlockMetrics last_block; //!< Statistics of the last Block written to output
+    };
+
     /**
      * @brief Class serving as C-DNS library's main interface for writing C-DNS to output
      *
@@ -38,7 +107,8 @@ namespace CDNS {
      * buffer records, events and malformed messages to C-DNS block and when the block is full,
      * it automatically gets written to output.
      *
-     * To change the output file or file descriptor user can call rotate_output() method.
+     * To change the output file or file descriptor user can call rotate_output() method. Output files
+     * can also be rotated automatically based on time, size or number of Blocks (see set_rotation_parameters()).
      *
      * To enforce writing of not fully buffered block to output write_block() method is provided.
      * This method can also write to output an externally created C-DNS block. (WARNING: External
@@ -55,7 +125,31 @@ namespace CDNS {
         template<typename T>
         CdnsExporter(FilePreamble& fp, const T& out, CborOutputCompression compression)
             : m_file_preamble(fp), m_block(fp.get_block_parameters(0), 0), m_encoder(out, compression),
-              m_active_block_parameters(0), m_blocks_written(0) {}
+              m_active_block_parameters(0), m_blocks_written(0), m_bytes_written(0), m_rotation(),
+              m_rotation_seq(0), m_next_rotation(0), m_metrics(), m_metrics_callback(),
+              m_output_name(output_file_name(out)), m_summary_suffix(), m_summary_bits(0),
+              m_summary_writer(), m_summary_block_index(0) {}
+
+        /**
+         * @brief Construct a new CdnsExporter object to output C-DNS data asynchronously
+         *
+         * Compression and writing of Blocks to output is done in separate thread. Full Blocks wait
+         * for output in a bounded queue. If the queue is full, the caller is blocked or some Blocks are
+         * dropped according to the queue's policy. Number of items in dropped Blocks is recorded into
+         * Block statistics (dropped_items) of the next Block written to output.
+         * @param fp Filled C-DNS File preamble with file parameters
+         * @param out C-DNS output to open (file name[std::string] or file descriptor[int])
+         * @param compression Type of compression for the output C-DNS data
+         * @param queue Limits and overflow policy of the output queue
+         */
+        template<typename T>
+        CdnsExporter(FilePreamble& fp, const T& out, CborOutputCompression compression,
+                     const OutputQueueParameters& queue)
+            : m_file_preamble(fp), m_block(fp.get_block_parameters(0), 0), m_encoder(out, compression, queue),
+              m_active_block_parameters(0), m_blocks_written(0), m_bytes_written(0), m_rotation(),
+              m_rotation_seq(0), m_next_rotation(0), m_metrics(), m_metrics_callback(),
+              m_output_name(output_file_name(out)), m_summary_suffix(), m_summary_bits(0),
+              m_summary_writer(), m_summary_block_index(0) {}
 
         /**
          * @brief Destroy the CdnsExporter object and write the end of C-DNS output
@@ -87,9 +181,29 @@ namespace CDNS {
          * @return Number of uncompressed bytes written if full Block was written to output, 0 otherwise
          */
         std::size_t buffer_qr(const GenericQueryResponse& qr, const boost::optional<BlockStatistics>& stats = boost::none) {
-            std::size_t written = 0;
+            m_metrics.qr_items++;
+            std::size_t written = check_rotation();
             if (m_block.add_question_response_record(qr, stats))
-                written = write_block();
+                written += write_block();
+
+            return written;
+        }
+
+        /**
+         * @brief Buffer new DNS record given as raw DNS messages to C-DNS block
+         * @param qr Raw DNS messages of new DNS record with their transport metadata (malformed messages
+         * are buffered as Malformed messages)
+         * @param stats Current Block statistics (It's user's responsibility to count statistics and update them
+         * in the Block. User also has to start counting statistics from 0 again if new Block is started -> method
+         * returns non-0 value)
+         * @throw std::exception if inserting DNS record to the Block fails
+         * @return Number of uncompressed bytes written if full Block was written to output, 0 otherwise
+         */
+        std::size_t buffer_wire_qr(const WireQueryResponse& qr, const boost::optional<BlockStatistics>& stats = boost::none) {
+            m_metrics.qr_items++;
+            std::size_t written = check_rotation();
+            if (m_block.add_wire_query_response(qr, stats))
+                written += write_block();
 
             return written;
         }
@@ -104,9 +218,10 @@ namespace CDNS {
          * @return Number of uncompressed bytes written if full Block was written to output, 'false' otherwise
          */
         std::size_t buffer_aec(const GenericAddressEventCount& aec, const boost::optional<BlockStatistics>& stats = boost::none) {
-            std::size_t written = 0;
+            m_metrics.aec_items++;
+            std::size_t written = check_rotation();
             if (m_block.add_address_event_count(aec, stats))
-                written = write_block();
+                written += write_block();
 
             return written;
         }
@@ -121,21 +236,29 @@ namespace CDNS {
          * @return Number of uncompressed bytes written if full Block was written to output, 0 otherwise
          */
         std::size_t buffer_mm(const GenericMalformedMessage& mm, const boost::optional<BlockStatistics>& stats = boost::none) {
-            std::size_t written = 0;
+            m_metrics.mm_items++;
+            std::size_t written = check_rotation();
             if (m_block.add_malformed_message(mm, stats))
-                written = write_block();
+                written += write_block();
 
             return written;
         }
 
         /**
          * @brief Write the given C-DNS block to output
+         *
+         * If output is asynchronous, number of items dropped by the output queue since the last
+         * written Block is added to the given Block's statistics (dropped_items).
          * @param block C-DNS block to output
          * @throw std::exception if writing Block to output fails.
          * User should try to rotate output after this exception is thrown.
-         * @return Number of uncompressed bytes written
+         * @return Number of uncompressed bytes written (Block's bytes are not counted if it was dropped
+         * by output queue)
          */
-        std::size_t write_block(CdnsBlock& block);
+        std::size_t write_block(CdnsBlock& block) {
+            std::size_t written = write_block_to_output(block);
+            return written + check_size_rotation();
+        }
 
         /**
          * @brief Write the internally buffered C-DNS block to output
@@ -144,13 +267,25 @@ namespace CDNS {
          * @return Number of uncompressed bytes written
          */
         std::size_t write_block() {
-            std::size_t written = write_block(m_block);
-            m_block.clear();
-            m_block.set_block_parameters(m_file_preamble.get_block_parameters(m_active_block_parameters),
-                                         m_active_block_parameters);
-            return written;
+            std::size_t written = write_buffered_block();
+            return written + check_size_rotation();
         }
 
+        /**
+         * @brief Write the given raw C-DNS block (e.g. read by CdnsReader::read_raw_block()) to output
+         *
+         * The Block's content is copied as it is, so items dropped by asynchronous output queue are
+         * recorded in the statistics of the next Block written by other methods. Output is rotated
+         * before the Block is written if the time set in Rotation parameters has elapsed.
+         * @param block Raw C-DNS block to output. Its Block parameters index has to point to Block
+         * parameters of this exporter's File preamble.
+         * @throw std::exception if writing Block to output fails.
+         * User should try to rotate output after this exception is thrown.
+         * @return Number of uncompressed bytes written (Block's bytes are not counted if it was dropped
+         * by output queue)
+         */
+        std::size_t write_block(CdnsRawBlock& block);
+
         /**
          * @brief Close the current output and open a new one with given file name or file descriptor
          * @param out New output to open (file name[std::string] or file descriptor[int])
@@ -163,16 +298,100 @@ namespace CDNS {
         std::size_t rotate_output(const T& out, bool export_current_block) {
             std::size_t written = 0;
             if (export_current_block)
-                written += write_block();
+                written += write_buffered_block();
 
-            if (m_blocks_written > 0)
-                written += m_encoder.write_break();
+            if (m_blocks_written > 0) {
+                std::size_t end = m_encoder.write_break();
+                m_metrics.uncompressed_bytes += end;
+                written += end;
+            }
 
             m_encoder.rotate_output(out);
             m_blocks_written = 0;
+            m_bytes_written = 0;
+            m_output_name = output_file_name(out);
+            m_summary_writer.reset();
+            m_summary_block_index = 0;
             return written;
         }
 
+        /**
+         * @brief Set policies for automatic rotation of output files. Works only for outputs
+         * specified by file name.
+         * @param rp Rotation policies
+         * @throw CdnsEncoderException if name template of the new output files is empty or if
+         * the current output is specified by file descriptor
+         */
+        void set_rotation_parameters(const RotationParameters& rp);
+
+        /**
+         * @brief Rotate the output if the time set in Rotation parameters has elapsed.
+         *
+         * Called automatically by buffer_*() methods. If the input can be idle for a long time,
+         * user should call this method periodically to rotate the output in time.
+         * @throw CborOutputException if output rotation fails
+         * @return Number of uncompressed bytes written to close current output, 0 if no rotation was done
+         */
+        std::size_t check_rotation() {
+            if (m_next_rotation == 0 || ::time(nullptr) < m_next_rotation)
+                return 0;
+
+            return rotate_by_policy(true);
+        }
+
+        /**
+         * @brief Set anonymizer applied to IP addresses of all buffered items. Addresses are truncated to
+         * prefixes from active Block parameters' Storage parameters and optionally pseudonymized before
+         * they are inserted into the Block, so anonymized addresses are deduplicated in IP address table.
+         * @param anonymizer Anonymizer to use, `nullptr` disables anonymization
+         */
+        void set_anonymizer(const std::shared_ptr<const IpAnonymizer>& anonymizer) {
+            m_block.set_anonymizer(anonymizer);
+        }
+
+        /**
+         * @brief Keep raw IP addresses between exported Blocks (see CdnsBlock::set_table_cache())
+         * @param limit Maximum number of kept raw IP addresses, 0 disables the cache
+         */
+        void set_table_cache(std::size_t limit) {
+            m_block.set_table_cache(limit);
+        }
+
+        /**
+         * @brief Encode Block table items at insert time (see CdnsBlock::set_pre_encode())
+         * @param enable `true` to enable pre-encoding of Block table items
+         */
+        void set_pre_encode(bool enable) {
+            m_block.set_pre_encode(enable);
+        }
+
+        /**
+         * @brief Write summary of each Block written to output to a sidecar Block summary file
+         * (see BlockSummary and BlockSummaryWriter)
+         *
+         * Summary file of an output is named by the output's file name with given suffix appended.
+         * Blocks written to outputs specified by file descriptor and raw Blocks aren't summarized.
+         * Summaries are written only for Blocks written after this call.
+         *
+         * Blocks dropped by output queue with OutputQueuePolicy::DROP_NEWEST aren't summarized. With
+         * OutputQueuePolicy::DROP_OLDEST already summarized Blocks can be dropped later, so Block indexes
+         * in the summaries wouldn't match the Blocks in output.
+         * @param suffix Suffix of Block summary file names, empty string disables the summaries
+         * @param bits_per_item Number of Bloom filters' bits per distinct query name or client IP address
+         * in a Block
+         * @throw CdnsEncoderException if the summaries are enabled for output queue with
+         * OutputQueuePolicy::DROP_OLDEST
+         */
+        void set_block_summaries(const std::string& suffix, unsigned bits_per_item = 10) {
+            if (!suffix.empty() && m_encoder.drops_committed())
+                throw CdnsEncoderException("Block summaries can't be written with DROP_OLDEST output queue policy");
+
+            m_summary_suffix = suffix;
+            m_summary_bits = bits_per_item;
+            if (suffix.empty())
+                m_summary_writer.reset();
+        }
+
         /**
          * @brief Get the number of items in currently buffered Block
          *
@@ -217,6 +436,40 @@ namespace CDNS {
             return m_blocks_written;
         }
 
+        /**
+         * @brief Get the total number of items dropped by asynchronous output queue
+         * @return Total number of dropped items (always 0 if the output isn't asynchronous)
+         */
+        uint64_t get_dropped_items_count() {
+            return m_encoder.get_dropped_items_count();
+        }
+
+        /**
+         * @brief Get cumulative statistics of the exporter. Values from asynchronous output thread
+         * and compressed sizes can lag behind the Blocks written so far.
+         * @return Current statistics of the exporter
+         */
+        ExporterMetrics get_metrics() {
+            ExporterMetrics ret = m_metrics;
+            ret.blocks_dropped = m_encoder.get_dropped_blocks_count();
+            ret.dropped_items = m_encoder.get_dropped_items_count();
+            ret.output_bytes = m_encoder.get_output_bytes();
+            ret.output_time = m_encoder.get_output_time();
+            ret.blocked_time = m_encoder.get_blocked_time();
+            ret.queued_blocks = m_encoder.get_queued_blocks();
+            ret.queued_bytes = m_encoder.get_queued_bytes();
+            return ret;
+        }
+
+        /**
+         * @brief Set callback called with statistics of every Block written to output. The callback
+         * is called in the thread that writes the Block and should return quickly.
+         * @param callback Callback to call, empty function disables the callback
+         */
+        void set_metrics_callback(const std::function<void(const BlockMetrics&)>& callback) {
+            m_metrics_callback = callback;
+        }
+
         /**
          * @brief Add another Block parameters to File preamble
          *
@@ -268,12 +521,85 @@ namespace CDNS {
         }
 
         private:
+        /**
+         * @brief Write the given C-DNS block to output without checking rotation policies
+         * @param block C-DNS block to output
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write_block_to_output(CdnsBlock& block);
+
+        /**
+         * @brief Write the internally buffered C-DNS block to output without checking rotation
+         * policies and start a new one
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write_buffered_block() {
+            std::size_t written = write_block_to_output(m_block);
+            m_block.clear();
+            m_block.set_block_parameters(m_file_preamble.get_block_parameters(m_active_block_parameters),
+                                         m_active_block_parameters);
+            return written;
+        }
+
+        /**
+         * @brief Rotate the output if size or Block count limit from Rotation parameters was reached
+         * @throw CborOutputException if output rotation fails
+         * @return Number of uncompressed bytes written to close current output, 0 if no rotation was done
+         */
+        std::size_t check_size_rotation() {
+            if (m_rotation && ((m_rotation->max_blocks != 0 && m_blocks_written >= m_rotation->max_blocks) ||
+                (m_rotation->max_bytes != 0 && m_bytes_written >= m_rotation->max_bytes)))
+                return rotate_by_policy(false);
+
+            return 0;
+        }
+
         /**
          * @brief Writes beginning of C-DNS file (File type ID, File preamble and start of File blocks array)
          * @return Number of uncompressed bytes written
          */
         std::size_t write_file_header();
 
+        /**
+         * @brief Rotate the output to file with name created from Rotation parameters' template
+         * @param export_current_block If `true` currently internally buffered Block will be exported
+         * before current output is closed
+         * @throw CborOutputException if output rotation fails
+         * @return Number of uncompressed bytes written to close current output
+         */
+        std::size_t rotate_by_policy(bool export_current_block);
+
+        /**
+         * @brief Create name of the next output file from Rotation parameters' template
+         * @param ts Time used to fill the template
+         * @throw CborOutputException if the name can't be created
+         * @return Name of the next output file
+         */
+        std::string next_output_name(time_t ts);
+
+        /**
+         * @brief Get file name of output
+         * @param out Output file name
+         * @return Output file name
+         */
+        static std::string output_file_name(const std::string& out) {
+            return out;
+        }
+
+        /**
+         * @brief Get file name of output specified by file descriptor
+         * @return Empty string
+         */
+        static std::string output_file_name(int) {
+            return std::string();
+        }
+
+        /**
+         * @brief Write summary of the given Block to Block summary file of current output if enabled
+         * @param block C-DNS block written to output
+         */
+        void write_block_summary(const CdnsBlock& block);
+
         FilePreamble m_file_preamble;
         CdnsBlock m_block;
         CdnsEncoder m_encoder;
@@ -283,6 +609,28 @@ namespace CDNS {
          * @brief Number of Blocks written to the currently open output (gets reset on output rotation)
          */
         std::size_t m_blocks_written;
+
+        /**
+         * @brief Number of uncompressed bytes written to the currently open output (gets reset on output rotation)
+         */
+        std::size_t m_bytes_written;
+
+        boost::optional<RotationParameters> m_rotation;
+        uint64_t m_rotation_seq; //!< Sequence number for the next automatically rotated output
+        time_t m_next_rotation; //!< Time of the next time-based rotation (0 = disabled)
+
+        ExporterMetrics m_metrics; //!< Statistics counted in caller's thread
+        std::function<void(const BlockMetrics&)> m_metrics_callback;
+
+        std::string m_output_name; //!< File name of current output (empty for file descriptor)
+        std::string m_summary_suffix; //!< Suffix of Block summary file names (empty = disabled)
+        unsigned m_summary_bits; //!< Bloom filters' bits per item in Block summaries
+        std::unique_ptr<BlockSummaryWriter> m_summary_writer; //!< Block summary file of current output
+
+        /**
+         * @brief Index of the next Block in current output, Blocks dropped by output queue aren't counted
+         */
+        uint64_t m_summary_block_index;
     };
 
     /**
@@ -308,7 +656,12 @@ namespace CDNS {
                                           m_decoder(input),
                                           m_blocks_count(0),
                                           m_blocks_read(0),
-                                          m_indef_blocks(false) { read_file_header(); }
+                                          m_indef_blocks(false),
+                                          m_filter(),
+                                          m_time_ordered(false),
+                                          m_summaries(),
+                                          m_next_summary(0),
+                                          m_blocks_skipped(0) { read_file_header(); }
 
         /**
          * @brief Read whole C-DNS Block from input stream
@@ -318,6 +671,130 @@ namespace CDNS {
          */
         CdnsBlockRead read_block(bool& eof);
 
+        /**
+         * @brief Read whole C-DNS Block from input stream into existing Block object. Avoids copying
+         * of the Block and reuses memory already allocated by the Block.
+         * @param block Block to read the data into (its previous content is cleared)
+         * @param eof If set by this method to TRUE, then reader has reached the end
+         * of C-DNS file and the given C-DNS block is empty. Otherwise set to FALSE.
+         */
+        void read_block(CdnsBlockRead& block, bool& eof);
+
+        /**
+         * @brief Read C-DNS Block from input stream without decoding its content (except Block
+         * preamble). Useful for copying Blocks to another C-DNS file.
+         * @param eof If set by this method to TRUE, then reader has reached the end
+         * of C-DNS file and the returned C-DNS block is empty. Otherwise set to FALSE.
+         * @return New raw C-DNS Block read from input stream
+         */
+        CdnsRawBlock read_raw_block(bool& eof);
+
+        /**
+         * @brief Read C-DNS Block from input stream into existing raw Block object without decoding
+         * its content (except Block preamble)
+         * @param block Raw Block to read the data into (its previous content is cleared)
+         * @param eof If set by this method to TRUE, then reader has reached the end
+         * of C-DNS file and the given C-DNS block is empty. Otherwise set to FALSE.
+         */
+        void read_raw_block(CdnsRawBlock& block, bool& eof);
+
+        /**
+         * @brief Read only numbers of items of the next C-DNS Block from input stream. Rest of the Block
+         * is skipped without decoding, which is much faster than read_block().
+         * @param eof If set by this method to TRUE, then reader has reached the end
+         * of C-DNS file and the returned counts are 0. Otherwise set to FALSE.
+         * @return Numbers of items in the Block
+         */
+        BlockItemCounts read_block_counts(bool& eof);
+
+        /**
+         * @brief Read only Query/Responses and Malformed messages within given time range with read_block()
+         *
+         * Blocks starting at or after the end of the range are skipped right after their Block preamble
+         * is read. Other Blocks are decoded, but only items within the range are kept and Block tables
+         * are decoded only for Blocks containing such items. Blocks without any item within the range
+         * aren't returned by read_block() at all. Other reading methods aren't affected by the filter.
+         * @param start Start of the time range (inclusive)
+         * @param end End of the time range (exclusive)
+         * @param time_ordered If `true`, Blocks in input are expected to be ordered by their earliest
+         * time and reading ends at the first Block starting at or after the end of the range
+         */
+        void set_time_filter(const Timestamp& start, const Timestamp& end, bool time_ordered = false) {
+            m_filter.time_range = TimeRange(start, end);
+            m_time_ordered = time_ordered;
+        }
+
+        /**
+         * @brief Stop filtering items read with read_block() by time
+         */
+        void clear_time_filter() {
+            m_filter.time_range = boost::none;
+            m_time_ordered = false;
+        }
+
+        /**
+         * @brief Read only Query/Responses with given query name with read_block()
+         *
+         * Only the `name-rdata` Block table is decoded first to find index of the query name. Blocks
+         * not containing the name at all are skipped without decoding their items, Query/Responses of
+         * other Blocks are matched by the index. Malformed messages are never returned while the filter
+         * is set. Can be combined with other filters, items then have to match all of them.
+         * @param name Query name in DNS wire format (the same as GenericQueryResponse::query_name)
+         */
+        void set_query_name_filter(const std::string& name) {
+            m_filter.query_name = name;
+        }
+
+        /**
+         * @brief Stop filtering items read with read_block() by query name
+         */
+        void clear_query_name_filter() {
+            m_filter.query_name = boost::none;
+        }
+
+        /**
+         * @brief Read only Query/Responses and Malformed messages with given client IP address
+         * with read_block()
+         *
+         * Only the `ip-address` Block table is decoded first to find index of the address. Blocks
+         * not containing the address at all are skipped without decoding their items, items of other
+         * Blocks are matched by the index. Can be combined with other filters, items then have to match
+         * all of them.
+         * @param address Client IP address as stored in Block tables (the same as
+         * GenericQueryResponse::client_ip)
+         */
+        void set_client_ip_filter(const std::string& address) {
+            m_filter.client_ip = address;
+        }
+
+        /**
+         * @brief Stop filtering items read with read_block() by client IP address
+         */
+        void clear_client_ip_filter() {
+            m_filter.client_ip = boost::none;
+        }
+
+        /**
+         * @brief Set Block summaries of the input (e.g. read by BlockSummaryReader from Block summary
+         * file written by CdnsExporter) consulted by read_block() while a filter is set
+         *
+         * Blocks whose summary shows they can't contain any item matching the filter are skipped
+         * without decoding. Blocks without summary are read as usual.
+         * @param summaries Block summaries ordered by Block index
+         */
+        void set_block_summaries(std::vector<BlockSummary> summaries) {
+            m_summaries = std::move(summaries);
+            m_next_summary = 0;
+        }
+
+        /**
+         * @brief Get the number of Blocks skipped by read_block() according to Block summaries
+         * @return Number of skipped Blocks
+         */
+        uint64_t get_blocks_skipped_count() const {
+            return m_blocks_skipped;
+        }
+
         FilePreamble m_file_preamble; //!< C-DNS file preamble
 
         private:
@@ -327,9 +804,27 @@ namespace CDNS {
          */
         void read_file_header();
 
+        /**
+         * @brief Check if all Blocks were read from input stream. Reads the end of indefinite
+         * length Block array if it's reached.
+         * @return `true` if there are no more Blocks to read, `false` otherwise
+         */
+        bool blocks_end();
+
+        /**
+         * @brief Find Block summary of the next Block in input
+         * @return Block summary of the next Block or `nullptr` if it has no summary
+         */
+        const BlockSummary* next_block_summary();
+
         CdnsDecoder m_decoder;
         uint64_t m_blocks_count;
         uint64_t m_blocks_read;
         bool m_indef_blocks;
+        ItemFilter m_filter;
+        bool m_time_ordered;
+        std::vector<BlockSummary> m_summaries;
+        std::size_t m_next_summary; //!< Position of the next Block's summary in m_summaries
+        uint64_t m_blocks_skipped;
     };
 }
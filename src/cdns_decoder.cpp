@@ -6,251 +6,281 @@
  * file, you can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
+
 #include "cdns_decoder.h"
+#include "cbor_scanner.h"
 
 CDNS::CborType CDNS::CdnsDecoder::peek_type()
 {
-    read_to_buffer();
+    CborType cbor_type;
+    CdnsDecoderStatus status = try_peek_type(cbor_type);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "peek_type");
+
+    return cbor_type;
+}
+
+uint64_t CDNS::CdnsDecoder::read_unsigned()
+{
+    uint64_t value;
+    CdnsDecoderStatus status = try_read_unsigned(value);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_unsigned");
+
+    return value;
+}
+
+int64_t CDNS::CdnsDecoder::read_negative()
+{
+    int64_t value;
+    CdnsDecoderStatus status = try_read_negative(value);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_negative");
+
+    return value;
+}
+
+int64_t CDNS::CdnsDecoder::read_integer()
+{
+    int64_t value;
+    CdnsDecoderStatus status = try_read_integer(value);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_integer");
+
+    return value;
+}
+
+bool CDNS::CdnsDecoder::read_bool()
+{
+    bool value;
+    CdnsDecoderStatus status = try_read_bool(value);
+    if (status == CdnsDecoderStatus::INVALID_VALUE && static_cast<CborType>(m_p[0] & 0xE0) == CborType::SIMPLE)
+        throw CdnsDecoderException("CBOR additional information value isn't bool");
+    else if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_bool");
+
+    return value;
+}
+
+std::string CDNS::CdnsDecoder::read_bytestring()
+{
+    std::string value;
+    CdnsDecoderStatus status = try_read_bytestring(value);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_bytestring");
+
+    return value;
+}
+
+std::string CDNS::CdnsDecoder::read_textstring()
+{
+    std::string value;
+    CdnsDecoderStatus status = try_read_textstring(value);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_textstring");
+
+    return value;
+}
+
+uint64_t CDNS::CdnsDecoder::read_array_start(bool& indef)
+{
+    uint64_t length;
+    CdnsDecoderStatus status = try_read_array_start(length, indef);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_array_start");
+
+    return length;
+}
+
+uint64_t CDNS::CdnsDecoder::read_map_start(bool& indef)
+{
+    uint64_t length;
+    CdnsDecoderStatus status = try_read_map_start(length, indef);
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_map_start");
+
+    return length;
+}
+
+void CDNS::CdnsDecoder::read_break()
+{
+    CdnsDecoderStatus status = try_read_break();
+    if (status != CdnsDecoderStatus::OK)
+        throw_error(status, "read_break");
+}
+
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_peek_type(CborType& cbor_type)
+{
+    if (m_p == m_end && !fill_buffer())
+        return CdnsDecoderStatus::END;
+
     if (static_cast<CborType>(m_p[0]) == CborType::BREAK)
-        return CborType::BREAK;
+        cbor_type = CborType::BREAK;
     else
-        return static_cast<CborType>(m_p[0] & 0xE0);
+        cbor_type = static_cast<CborType>(m_p[0] & 0xE0);
+
+    return CdnsDecoderStatus::OK;
 }
 
-uint64_t CDNS::CdnsDecoder::read_unsigned()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_unsigned(uint64_t& value)
 {
-    CborType cbor_type;
     uint8_t item_length;
-    read_cbor_type(cbor_type, item_length);
-    if (cbor_type != CborType::UNSIGNED) {
-        throw CdnsDecoderException(("read_unsigned() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (item_length >= 28) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(item_length)).c_str());
-    }
+    CdnsDecoderStatus status = try_read_head(CborType::UNSIGNED, false, item_length);
+    if (status != CdnsDecoderStatus::OK)
+        return status;
 
-    return read_int(item_length);
+    return try_read_int(item_length, value);
 }
 
-int64_t CDNS::CdnsDecoder::read_negative()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_negative(int64_t& value)
 {
-    CborType cbor_type;
     uint8_t item_length;
-    read_cbor_type(cbor_type, item_length);
-    if (cbor_type != CborType::NEGATIVE) {
-        throw CdnsDecoderException(("read_negative() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (item_length >= 28) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(item_length)).c_str());
-    }
+    CdnsDecoderStatus status = try_read_head(CborType::NEGATIVE, false, item_length);
+    if (status != CdnsDecoderStatus::OK)
+        return status;
+
+    uint64_t abs_value;
+    status = try_read_int(item_length, abs_value);
+    if (status == CdnsDecoderStatus::OK)
+        value = -1 - abs_value;
 
-    return -1 - read_int(item_length);
+    return status;
 }
 
-int64_t CDNS::CdnsDecoder::read_integer()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_integer(int64_t& value)
 {
-    CborType peek = peek_type();
-    switch (peek) {
-        case CborType::UNSIGNED:
-            return read_unsigned();
-            break;
+    if (m_p == m_end && !fill_buffer())
+        return CdnsDecoderStatus::END;
+
+    switch (static_cast<CborType>(m_p[0] & 0xE0)) {
+        case CborType::UNSIGNED: {
+            uint64_t unsigned_value;
+            CdnsDecoderStatus status = try_read_unsigned(unsigned_value);
+            if (status == CdnsDecoderStatus::OK)
+                value = unsigned_value;
+            return status;
+        }
         case CborType::NEGATIVE:
-            return read_negative();
-            break;
+            return try_read_negative(value);
         default:
-            throw CdnsDecoderException(("read_integer() called on wrong major type " +
-                                        std::to_string(static_cast<uint8_t>(peek) >> 5)).c_str());
-            break;
+            return CdnsDecoderStatus::WRONG_TYPE;
     }
 }
 
-bool CDNS::CdnsDecoder::read_bool()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_bool(bool& value)
 {
-    CborType cbor_type;
-    uint8_t bool_value;
-    read_cbor_type(cbor_type, bool_value);
-    if (cbor_type != CborType::SIMPLE && cbor_type != CborType::UNSIGNED) {
-        throw CdnsDecoderException(("read_bool() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (cbor_type == CborType::SIMPLE && (bool_value != 20 && bool_value != 21)) {
-        throw CdnsDecoderException("CBOR additional information value isn't bool");
-    }
-    else if (cbor_type == CborType::UNSIGNED && bool_value >= 28) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(bool_value)).c_str());
-    }
+    if (m_p == m_end && !fill_buffer())
+        return CdnsDecoderStatus::END;
+
+    CborType cbor_type = static_cast<CborType>(m_p[0] & 0xE0);
+    uint8_t bool_value = m_p[0] & 0x1F;
 
     if (cbor_type == CborType::SIMPLE) {
-        return bool_value == 21;
+        if (bool_value != 20 && bool_value != 21)
+            return CdnsDecoderStatus::INVALID_VALUE;
+
+        m_p++;
+        value = bool_value == 21;
+        return CdnsDecoderStatus::OK;
     }
-    else {
-        return read_int(bool_value) != 0;
+    else if (cbor_type == CborType::UNSIGNED) {
+        uint64_t unsigned_value;
+        CdnsDecoderStatus status = try_read_unsigned(unsigned_value);
+        if (status == CdnsDecoderStatus::OK)
+            value = unsigned_value != 0;
+        return status;
     }
+
+    return CdnsDecoderStatus::WRONG_TYPE;
 }
 
-std::string CDNS::CdnsDecoder::read_bytestring()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_bytestring(std::string& value)
 {
-    CborType cbor_type;
     uint8_t item_length;
-    read_cbor_type(cbor_type, item_length);
-    if (cbor_type != CborType::BYTE_STRING) {
-        throw CdnsDecoderException(("read_bytestring() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (item_length >= 28 && item_length <= 30) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(item_length)).c_str());
-    }
-
-    return read_string(CborType::BYTE_STRING, read_int(item_length), item_length == 31 ? true : false);
+    CdnsDecoderStatus status = try_read_head(CborType::BYTE_STRING, true, item_length);
+    if (status != CdnsDecoderStatus::OK)
+        return status;
 
+    return try_read_string(CborType::BYTE_STRING, item_length, value);
 }
 
-std::string CDNS::CdnsDecoder::read_textstring()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_textstring(std::string& value)
 {
-    CborType cbor_type;
     uint8_t item_length;
-    read_cbor_type(cbor_type, item_length);
-    if (cbor_type != CborType::TEXT_STRING) {
-        throw CdnsDecoderException(("read_textstring() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (item_length >= 28 && item_length <= 30) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(item_length)).c_str());
-    }
+    CdnsDecoderStatus status = try_read_head(CborType::TEXT_STRING, true, item_length);
+    if (status != CdnsDecoderStatus::OK)
+        return status;
 
-    return read_string(CborType::TEXT_STRING, read_int(item_length), item_length == 31 ? true : false);
+    return try_read_string(CborType::TEXT_STRING, item_length, value);
 }
 
-uint64_t CDNS::CdnsDecoder::read_array_start(bool& indef)
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_array_start(uint64_t& length, bool& indef)
 {
-    CborType cbor_type;
     uint8_t array_length_value;
-    read_cbor_type(cbor_type, array_length_value);
-    if (cbor_type != CborType::ARRAY) {
-        throw CdnsDecoderException(("read_array_start() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (array_length_value >= 28 && array_length_value <= 30) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(array_length_value)).c_str());
+    CdnsDecoderStatus status = try_read_head(CborType::ARRAY, true, array_length_value);
+    if (status != CdnsDecoderStatus::OK)
+        return status;
+
+    indef = array_length_value == 31;
+    if (indef) {
+        length = 0;
+        return CdnsDecoderStatus::OK;
     }
 
-    if (array_length_value == 31) {
-        indef = true;
-        return 0;
-    }
-
-    indef = false;
-    return read_int(array_length_value);
+    return try_read_int(array_length_value, length);
 }
 
-uint64_t CDNS::CdnsDecoder::read_map_start(bool& indef)
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_map_start(uint64_t& length, bool& indef)
 {
-    CborType cbor_type;
     uint8_t map_length_value;
-    read_cbor_type(cbor_type, map_length_value);
-    if (cbor_type != CborType::MAP) {
-        throw CdnsDecoderException(("read_map_start() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
-    else if (map_length_value >= 28 && map_length_value <= 30) {
-        throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                    std::to_string(map_length_value)).c_str());
+    CdnsDecoderStatus status = try_read_head(CborType::MAP, true, map_length_value);
+    if (status != CdnsDecoderStatus::OK)
+        return status;
+
+    indef = map_length_value == 31;
+    if (indef) {
+        length = 0;
+        return CdnsDecoderStatus::OK;
     }
 
-    if (map_length_value == 31) {
-        indef = true;
-        return 0;
-    }
-
-    indef = false;
-    return read_int(map_length_value);
+    return try_read_int(map_length_value, length);
 }
 
-void CDNS::CdnsDecoder::read_break()
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_break()
 {
-    CborType cbor_type;
-    uint8_t break_code;
-    read_cbor_type(cbor_type, break_code);
-    if (cbor_type != CborType::SIMPLE || break_code != 31) {
-        throw CdnsDecoderException(("read_break() called on wrong major type " +
-                                    std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-    }
+    if (m_p == m_end && !fill_buffer())
+        return CdnsDecoderStatus::END;
+
+    if (static_cast<CborType>(m_p[0]) != CborType::BREAK)
+        return CdnsDecoderStatus::WRONG_TYPE;
+
+    m_p++;
+    return CdnsDecoderStatus::OK;
 }
 
 void CDNS::CdnsDecoder::skip_item()
 {
-    CborType cbor_type;
-    uint8_t item_length;
-    read_cbor_type(cbor_type, item_length);
+    skip_items(1);
+}
 
-    switch (cbor_type) {
-        case CborType::UNSIGNED:
-        case CborType::NEGATIVE:
-        case CborType::TAG:
-            if (item_length >= 28) {
-                throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                            std::to_string(item_length)).c_str());
-            }
-            read_int(item_length);
-            break;
+uint64_t CDNS::CdnsDecoder::skip_array()
+{
+    bool indef = false;
+    uint64_t length = read_array_start(indef);
 
-        case CborType::SIMPLE:
-            if (item_length >= 28 && item_length <= 30) {
-                throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                            std::to_string(item_length)).c_str());
-            }
-            read_int(item_length);
-            break;
-
-        case CborType::BYTE_STRING:
-        case CborType::TEXT_STRING:
-            if (item_length >= 28 && item_length <= 30) {
-                throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                            std::to_string(item_length)).c_str());
-            }
-            read_string(cbor_type, read_int(item_length), item_length == 31 ? true : false);
-            break;
-
-        case CborType::ARRAY:
-        case CborType::MAP:
-            if (item_length >= 28 && item_length <= 30) {
-                throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
-                                            std::to_string(item_length)).c_str());
-            }
-            if (item_length == 31) {
-                while(true) {
-                    if (peek_type() == CborType::SIMPLE && (m_p[0] & 0x1F) == 31) {
-                        m_p++;
-                        break;
-                    }
-                    skip_item();
-                    if (cbor_type == CborType::MAP)
-                        skip_item();
-                }
-            }
-            else {
-                uint64_t item_count = read_int(item_length);
-                for (unsigned i = 0; i < item_count; i++) {
-                    skip_item();
-                    if (cbor_type == CborType::MAP)
-                        skip_item();
-                }
-            }
-            break;
+    if (!indef) {
+        skip_items(length);
+        return length;
+    }
 
-        default:
-            throw CdnsDecoderException(("Unknown CBOR major type " +
-                                        std::to_string(static_cast<uint8_t>(cbor_type) >> 5)).c_str());
-            break;
+    while (peek_type() != CborType::BREAK) {
+        skip_item();
+        length++;
     }
+    read_break();
+
+    return length;
 }
 
 void CDNS::CdnsDecoder::read_cbor_type(CborType& cbor_type, uint8_t& additional)
@@ -263,70 +293,196 @@ void CDNS::CdnsDecoder::read_cbor_type(CborType& cbor_type, uint8_t& additional)
 
 uint64_t CDNS::CdnsDecoder::read_int(uint8_t item_length)
 {
-    uint64_t value = 0;
+    uint64_t value;
+    if (try_read_int(item_length, value) != CdnsDecoderStatus::OK)
+        throw CdnsDecoderEnd("End of input stream");
+
+    return value;
+}
+
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_head(CborType cbor_type, bool allow_indef,
+                                                         uint8_t& additional)
+{
+    if (m_p == m_end && !fill_buffer())
+        return CdnsDecoderStatus::END;
+
+    if (static_cast<CborType>(m_p[0] & 0xE0) != cbor_type)
+        return CdnsDecoderStatus::WRONG_TYPE;
+
+    additional = m_p[0] & 0x1F;
+    if (additional >= 28 && (additional != 31 || !allow_indef))
+        return CdnsDecoderStatus::INVALID_VALUE;
+
+    m_p++;
+    return CdnsDecoderStatus::OK;
+}
 
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_int(uint8_t item_length, uint64_t& value)
+{
     if (item_length <= 23) {
-        return item_length;
+        value = item_length;
+        return CdnsDecoderStatus::OK;
     }
-    else if (item_length >= 24 && item_length <= 27) {
+
+    value = 0;
+    if (item_length <= 27) {
         for (int i = 1 << (item_length - 24); i > 0; i--) {
-            read_to_buffer();
-            value += (static_cast<uint64_t>(m_p[0]) << ((i - 1) * 8));
+            if (m_p == m_end && !fill_buffer())
+                return CdnsDecoderStatus::END;
+
+            value = (value << 8) | m_p[0];
             m_p++;
         }
     }
 
-    return value;
+    return CdnsDecoderStatus::OK;
 }
 
-std::string CDNS::CdnsDecoder::read_string(CborType cbor_type, uint64_t length, bool indef)
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_string(CborType cbor_type, uint8_t item_length,
+                                                           std::string& value)
 {
-    std::string ret;
+    value.clear();
 
-    if (!indef) {
-        ret.reserve(length);
-        for (unsigned i = 0; i < length; i++) {
-            read_to_buffer();
-            ret.push_back(m_p[0]);
+    if (item_length != 31) {
+        uint64_t length;
+        CdnsDecoderStatus status = try_read_int(item_length, length);
+        if (status != CdnsDecoderStatus::OK)
+            return status;
+
+        return try_read_bytes(value, length);
+    }
+
+    while (true) {
+        if (m_p == m_end && !fill_buffer())
+            return CdnsDecoderStatus::END;
+
+        if (static_cast<CborType>(m_p[0]) == CborType::BREAK) {
             m_p++;
+            return CdnsDecoderStatus::OK;
         }
+
+        // Chunks have to be definite length strings of the same major type
+        uint8_t chunk_length_value = m_p[0] & 0x1F;
+        if (static_cast<CborType>(m_p[0] & 0xE0) != cbor_type || chunk_length_value >= 28)
+            return CdnsDecoderStatus::MALFORMED;
+        m_p++;
+
+        uint64_t chunk_length;
+        CdnsDecoderStatus status = try_read_int(chunk_length_value, chunk_length);
+        if (status == CdnsDecoderStatus::OK)
+            status = try_read_bytes(value, chunk_length);
+
+        if (status != CdnsDecoderStatus::OK)
+            return status;
     }
-    else {
-        while (peek_type() != CborType::SIMPLE) {
-            CborType chunk_type;
-            uint8_t chunk_length_value;
-            read_cbor_type(chunk_type, chunk_length_value);
-            if (chunk_type != cbor_type) {
-                throw CdnsDecoderException(("Different chunk major type inside indefinite length string: " +
-                                            std::to_string(static_cast<uint8_t>(chunk_type) >> 5)).c_str());
-            }
-            else if (chunk_length_value == 31) {
-                throw CdnsDecoderException("Indefinite length chunk inside indefinite length string");
-            }
+}
+
+CDNS::CdnsDecoderStatus CDNS::CdnsDecoder::try_read_bytes(std::string& out, uint64_t length)
+{
+    // Don't trust the length from input too much when allocating memory
+    if (out.empty())
+        out.reserve(std::min(length, static_cast<uint64_t>(BUFFER_SIZE)));
+
+    while (length > 0) {
+        if (m_p == m_end && !fill_buffer())
+            return CdnsDecoderStatus::END;
+
+        std::size_t chunk = std::min<uint64_t>(length, m_end - m_p);
+        out.append(reinterpret_cast<const char*>(m_p), chunk);
+        m_p += chunk;
+        length -= chunk;
+    }
+
+    return CdnsDecoderStatus::OK;
+}
 
-            uint64_t chunk_length = read_int(chunk_length_value);
-            ret.reserve(ret.size() + chunk_length);
-            for (unsigned i = 0; i < chunk_length; i++) {
-                read_to_buffer();
-                ret.push_back(m_p[0]);
-                m_p++;
+void CDNS::CdnsDecoder::skip_bytes(uint64_t length)
+{
+    while (length > 0) {
+        std::size_t avail = m_end - m_p;
+        if (length <= avail) {
+            m_p += length;
+            return;
+        }
+
+        length -= avail;
+        m_p = m_end;
+
+        // Seek over data that wouldn't fit in the buffer anyway (captured data have to be read)
+        if (!m_capture && length > BUFFER_SIZE) {
+            std::istream::pos_type pos = m_input.tellg();
+            if (pos != std::istream::pos_type(-1)) {
+                m_input.seekg(0, std::ios_base::end);
+                std::istream::pos_type end = m_input.tellg();
+                if (end != std::istream::pos_type(-1) && static_cast<uint64_t>(end - pos) >= length) {
+                    m_input.seekg(pos + static_cast<std::streamoff>(length));
+                    return;
+                }
+
+                // Skipped data go beyond the end of input, read it to report the end properly
+                m_input.clear();
+                m_input.seekg(pos);
             }
+            m_input.clear(m_input.rdstate() & ~std::ios_base::failbit);
         }
 
-        read_break();
+        read_to_buffer();
     }
+}
 
-    return ret;
+void CDNS::CdnsDecoder::skip_items(uint64_t count)
+{
+    CborScanner scanner(count);
+
+    while (true) {
+        // Scan even empty buffer, enclosing containers may end right after skipped string
+        m_p += scanner.scan(m_p, m_end - m_p);
+        if (scanner.done())
+            return;
+
+        // Buffer is exhausted, skip the rest of long string without scanning it
+        if (scanner.pending_bytes() > 0)
+            skip_bytes(scanner.take_pending_bytes());
+        else
+            read_to_buffer();
+    }
 }
 
 void CDNS::CdnsDecoder::read_to_buffer()
 {
-    if (m_p == m_end) {
-        if (m_input.eof())
-            throw CdnsDecoderEnd("End of input stream");
+    if (m_p == m_end && !fill_buffer())
+        throw CdnsDecoderEnd("End of input stream");
+}
 
-        m_input.read(reinterpret_cast<char*>(m_buffer), BUFFER_SIZE);
-        m_p = m_buffer;
-        m_end = m_buffer + m_input.gcount();
+bool CDNS::CdnsDecoder::fill_buffer()
+{
+    if (m_input.eof())
+        return false;
+
+    if (m_capture) {
+        m_capture->append(reinterpret_cast<const char*>(m_capture_start), m_end - m_capture_start);
+        m_capture_start = m_buffer;
     }
-}
\ No newline at end of file
+
+    m_input.read(reinterpret_cast<char*>(m_buffer), BUFFER_SIZE);
+    m_p = m_buffer;
+    m_end = m_buffer + m_input.gcount();
+
+    return m_p != m_end;
+}
+
+void CDNS::CdnsDecoder::throw_error(CdnsDecoderStatus status, const char* method) const
+{
+    switch (status) {
+        case CdnsDecoderStatus::END:
+            throw CdnsDecoderEnd("End of input stream");
+        case CdnsDecoderStatus::WRONG_TYPE:
+            throw CdnsDecoderException((std::string(method) + "() called on wrong major type " +
+                                        std::to_string(m_p[0] >> 5)).c_str());
+        case CdnsDecoderStatus::INVALID_VALUE:
+            throw CdnsDecoderException(("Unsupported CBOR additional information value: " +
+                                        std::to_string(m_p[0] & 0x1F)).c_str());
+        default:
+            throw CdnsDecoderException((std::string(method) + "() encountered malformed CBOR data").c_str());
+    }
+}
@@ -35,6 +35,18 @@ namespace CDNS {
         explicit CdnsDecoderEnd(std::string& msg) : std::runtime_error(msg) {}
     };
 
+    /**
+     * @enum CdnsDecoderStatus
+     * @brief Result of CdnsDecoder's non-throwing decoding methods
+     */
+    enum class CdnsDecoderStatus : uint8_t {
+        OK = 0, //!< Item was decoded
+        END, //!< The end of input stream was reached
+        WRONG_TYPE, //!< Next item is of different CBOR major type, nothing was consumed
+        INVALID_VALUE, //!< Next item has unsupported additional information value, nothing was consumed
+        MALFORMED //!< Malformed CBOR data were encountered in the middle of an item
+    };
+
     /**
      * @brief Decodes input stream of CBOR data.
      */
@@ -48,7 +60,8 @@ namespace CDNS {
          * @param input Valid input stream to read C-DNS data from
          * @throw CdnsDecoderException if the input stream isn't valid
          */
-        CdnsDecoder(std::istream& input) : m_input(input) {
+        CdnsDecoder(std::istream& input) : m_input(input), m_capture(nullptr), m_capture_start(nullptr),
+                                           m_capture_mark(0) {
             m_p = m_end = m_buffer;
             if (input.bad())
                 throw CdnsDecoderException("Bad input stream");
@@ -160,6 +173,86 @@ namespace CDNS {
          */
         void read_break();
 
+        // Non-throwing variants of the methods above. They return status of the decoding instead of
+        // throwing exceptions, so the caller can cheaply probe the type of the next item or check for
+        // the end of input. If the next item is of a different type (CdnsDecoderStatus::WRONG_TYPE)
+        // or has unsupported additional information (CdnsDecoderStatus::INVALID_VALUE), nothing is
+        // consumed from input stream. The output parameters are valid only if CdnsDecoderStatus::OK
+        // is returned.
+
+        /**
+         * @brief Look up CBOR major type of the next item in input stream
+         * @param cbor_type Set by this method to CBOR major type of the next item
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_peek_type(CborType& cbor_type);
+
+        /**
+         * @brief Read an unsigned integer item from input stream
+         * @param value Set by this method to unsigned integer read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_unsigned(uint64_t& value);
+
+        /**
+         * @brief Read a negative integer item from input stream
+         * @param value Set by this method to negative integer read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_negative(int64_t& value);
+
+        /**
+         * @brief Read unsigned or negative integer from input stream
+         * @param value Set by this method to integer read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_integer(int64_t& value);
+
+        /**
+         * @brief Read a bool item from input stream
+         * @param value Set by this method to bool value read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_bool(bool& value);
+
+        /**
+         * @brief Read a byte string item from input stream
+         * @param value Set by this method to byte string read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_bytestring(std::string& value);
+
+        /**
+         * @brief Read a text string item from input stream
+         * @param value Set by this method to text string read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_textstring(std::string& value);
+
+        /**
+         * @brief Read a start of an array from input stream
+         * @param length Set by this method to number of items in the array (0 if array is of
+         * indefinite length)
+         * @param indef Set by this method to TRUE if the array is of indefinite length, FALSE otherwise
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_array_start(uint64_t& length, bool& indef);
+
+        /**
+         * @brief Read a start of a map from input stream
+         * @param length Set by this method to number of key/value pairs in the map (0 if map is of
+         * indefinite length)
+         * @param indef Set by this method to TRUE if the map is of indefinite length, FALSE otherwise
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_map_start(uint64_t& length, bool& indef);
+
+        /**
+         * @brief Read a "break" stop code from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_break();
+
         /**
          * @brief Skip over the next item in input stream no matter what it is (skips over entire
          * array or map if that is the next item in input stream)
@@ -168,6 +261,47 @@ namespace CDNS {
          */
         void skip_item();
 
+        /**
+         * @brief Skip over the next item in input stream, which has to be an array, without
+         * decoding its items
+         * @throw CdnsDecoderEnd if the end of input stream is reached
+         * @throw CdnsDecoderException if the next item isn't an array or an error is encountered
+         * decoding CBOR data
+         * @return Number of items in the skipped array
+         */
+        uint64_t skip_array();
+
+        /**
+         * @brief Start copying raw CBOR data consumed from input stream into given string. Data is
+         * appended to the string until stop_capture() or cancel_capture() is called.
+         * @param out String to append the consumed CBOR data to
+         */
+        void start_capture(std::string& out) {
+            m_capture = &out;
+            m_capture_start = m_p;
+            m_capture_mark = out.size();
+        }
+
+        /**
+         * @brief Stop copying raw CBOR data started by start_capture() and keep the data consumed
+         * since then in the output string
+         */
+        void stop_capture() {
+            if (m_capture)
+                m_capture->append(reinterpret_cast<const char*>(m_capture_start), m_p - m_capture_start);
+            m_capture = nullptr;
+        }
+
+        /**
+         * @brief Stop copying raw CBOR data started by start_capture() and discard the data consumed
+         * since then from the output string
+         */
+        void cancel_capture() {
+            if (m_capture)
+                m_capture->resize(m_capture_mark);
+            m_capture = nullptr;
+        }
+
         private:
 
         /**
@@ -188,16 +322,58 @@ namespace CDNS {
          */
         uint64_t read_int(uint8_t item_length);
 
+        /**
+         * @brief Read the first byte of the next item in input stream if it's of given CBOR major type
+         * and has supported additional information. Otherwise the byte stays in input stream.
+         * @param cbor_type Expected CBOR major type of the item
+         * @param allow_indef TRUE if the item can be of indefinite length, FALSE otherwise
+         * @param additional Set by this method to item's additional information
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_head(CborType cbor_type, bool allow_indef, uint8_t& additional);
+
+        /**
+         * @brief Read an unsigned integer from input stream
+         * @param item_length Length of the integer (low-order 5 bits of additional information from
+         * item's first byte)
+         * @param value Set by this method to the unsigned integer read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_int(uint8_t item_length, uint64_t& value);
+
         /**
          * @brief Read string from the input stream
          * @param cbor_type CborType::BYTE_STRING or CborType::TEXT_STRING
-         * @param length Length of the string to read
-         * @param indef TRUE if it's indefinite length string, FALSE otherwise
+         * @param item_length Length of the string (low-order 5 bits of additional information from
+         * item's first byte, 31 for indefinite length string)
+         * @param value Set by this method to the string read from input stream
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_string(CborType cbor_type, uint8_t item_length, std::string& value);
+
+        /**
+         * @brief Append given number of bytes from input stream to a string
+         * @param out String to append the bytes to
+         * @param length Number of bytes to read
+         * @return Status of the decoding
+         */
+        CdnsDecoderStatus try_read_bytes(std::string& out, uint64_t length);
+
+        /**
+         * @brief Skip given number of bytes in input stream. Skips larger than decoder's buffer
+         * seek in the input stream if it's seekable and no raw CBOR data capture is active.
+         * @param length Number of bytes to skip
+         * @throw CdnsDecoderEnd if the end of input stream is reached
+         */
+        void skip_bytes(uint64_t length);
+
+        /**
+         * @brief Skip over given number of consecutive items in input stream
+         * @param count Number of items to skip
          * @throw CdnsDecoderEnd if the end of input stream is reached
          * @throw CdnsDecoderException if an error is encountered decoding CBOR data
-         * @return String read from the input stream
          */
-        std::string read_string(CborType cbor_type, uint64_t length, bool indef);
+        void skip_items(uint64_t count);
 
         /**
          * @brief Read more data from input stream to decoder's buffer
@@ -205,9 +381,29 @@ namespace CDNS {
          */
         void read_to_buffer();
 
+        /**
+         * @brief Refill decoder's empty buffer from input stream
+         * @return FALSE if the end of input stream is reached, TRUE otherwise
+         */
+        bool fill_buffer();
+
+        /**
+         * @brief Throw exception describing failed decoding. Expects the first byte of the failed
+         * item to stay in decoder's buffer unless the input stream ended.
+         * @param status Status of the failed decoding
+         * @param method Name of the decoding method that failed
+         * @throw CdnsDecoderEnd if the status is CdnsDecoderStatus::END
+         * @throw CdnsDecoderException otherwise
+         */
+        [[noreturn]] void throw_error(CdnsDecoderStatus status, const char* method) const;
+
         std::istream& m_input;
         unsigned char m_buffer[BUFFER_SIZE];
         unsigned char* m_p;
         unsigned char* m_end;
+
+        std::string* m_capture; //!< Output of raw CBOR data capture (nullptr if not capturing)
+        unsigned char* m_capture_start; //!< Start of data in the buffer not yet appended to m_capture
+        std::size_t m_capture_mark; //!< Size of m_capture when the capture started
     };
 }
\ No newline at end of file
@@ -273,7 +273,14 @@ std::size_t CDNS::CdnsEncoder::write(int64_t value)
 void CDNS::CdnsEncoder::flush_buffer()
 {
     if (m_p != m_buffer) {
-        m_cos->write(reinterpret_cast<const char*>(m_buffer), m_p - m_buffer);
+        if (m_async) {
+            m_cos->write(reinterpret_cast<const char*>(m_buffer), m_p - m_buffer);
+        }
+        else {
+            auto start = std::chrono::steady_clock::now();
+            m_cos->write(reinterpret_cast<const char*>(m_buffer), m_p - m_buffer);
+            m_output_time += std::chrono::steady_clock::now() - start;
+        }
         m_p = m_buffer;
         m_avail = BUFFER_SIZE;
     }
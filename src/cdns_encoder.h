@@ -13,6 +13,8 @@
 #include <cstdint>
 #include <stdexcept>
 #include <memory>
+#include <chrono>
+#include <boost/optional.hpp>
 
 #include "format_specification.h"
 #include "writer.h"
@@ -40,12 +42,15 @@ namespace CDNS {
          * @brief Construct a new CdnsEncoder object
          * @param output File name or valid file descriptor to output C-DNS data
          * @param compression Type of compression for the output C-DNS data
+         * @param queue If set, compression and writing to output are done asynchronously in separate
+         * thread through output queue with given parameters
          * @throw CborEncoderException if constructor fails
          * @throw CborOutputException if output initialization fails
          */
         template<typename T>
-        CdnsEncoder(const T& output, CborOutputCompression compression) : m_p(m_buffer),
-                                                                          m_avail(BUFFER_SIZE) {
+        CdnsEncoder(const T& output, CborOutputCompression compression,
+                    const boost::optional<OutputQueueParameters>& queue = boost::none)
+            : m_async(nullptr), m_p(m_buffer), m_avail(BUFFER_SIZE), m_output_time(0) {
             switch (compression) {
                 case CborOutputCompression::NO_COMPRESSION:
                     m_cos = std::make_unique<CborOutputWriter>(output);
@@ -61,6 +66,23 @@ namespace CDNS {
                     break;
             }
 
+            if (queue) {
+                auto async = std::make_unique<AsyncCborOutputWriter>(std::move(m_cos), queue.value());
+                m_async = async.get();
+                m_cos = std::move(async);
+            }
+
+            std::memset(m_buffer, 0, sizeof(m_buffer));
+        }
+
+        /**
+         * @brief Construct a new CdnsEncoder object writing CBOR data to a string in memory
+         * @param output String to append the CBOR data to, has to outlive the encoder. The data are
+         * appended when the internal buffer fills up or on flush().
+         */
+        explicit CdnsEncoder(std::string& output)
+            : m_cos(std::make_unique<MemoryCborOutputWriter>(output)), m_async(nullptr), m_p(m_buffer),
+              m_avail(BUFFER_SIZE), m_output_time(0) {
             std::memset(m_buffer, 0, sizeof(m_buffer));
         }
 
@@ -211,6 +233,33 @@ namespace CDNS {
          */
         std::size_t write(int64_t value);
 
+        /**
+         * @brief Write already encoded CBOR data as they are
+         * @param data Start of the CBOR data
+         * @param size Size of the CBOR data in bytes
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write_raw(const unsigned char* data, std::size_t size) {
+            write_string(data, size);
+            return size;
+        }
+
+        /**
+         * @brief Write already encoded CBOR data as they are
+         * @param data CBOR data
+         * @return Number of uncompressed bytes written
+         */
+        std::size_t write_raw(const std::string& data) {
+            return write_raw(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+        }
+
+        /**
+         * @brief Write contents of internal buffer to the output
+         */
+        void flush() {
+            flush_buffer();
+        }
+
         /**
          * @brief Close the current output and open a new one with given file name or file descriptor
          * @param out New output to open (file name[std::string] or file descriptor[int])
@@ -221,6 +270,104 @@ namespace CDNS {
             m_cos->rotate_output(out);
         }
 
+        /**
+         * @brief Hand over all data written since the last commit to the output queue.
+         * Does nothing if the encoder isn't asynchronous.
+         * @param items Number of items (records, events...) contained in the committed data
+         * @param droppable If `true` the committed data can be dropped if the output queue is full
+         * @param carried Number of previously dropped items recorded in the committed data
+         * @throw std::exception if asynchronous writing of previous data to output failed
+         * @return `false` if the committed data were dropped, `true` otherwise
+         */
+        bool commit(uint64_t items = 0, bool droppable = false, uint64_t carried = 0) {
+            if (!m_async)
+                return true;
+
+            flush_buffer();
+            return m_async->commit(items, droppable, carried);
+        }
+
+        /**
+         * @brief Get number of items dropped by output queue since the last call of this method
+         * @return Number of dropped items (always 0 if the encoder isn't asynchronous)
+         */
+        uint64_t take_dropped_items() {
+            return m_async ? m_async->take_dropped_items() : 0;
+        }
+
+        /**
+         * @brief Get total number of items dropped by output queue
+         * @return Total number of dropped items (always 0 if the encoder isn't asynchronous)
+         */
+        uint64_t get_dropped_items_count() {
+            return m_async ? m_async->get_dropped_items_count() : 0;
+        }
+
+        /**
+         * @brief Get total number of Blocks dropped by output queue
+         * @return Total number of dropped Blocks (always 0 if the encoder isn't asynchronous)
+         */
+        uint64_t get_dropped_blocks_count() {
+            return m_async ? m_async->get_dropped_blocks_count() : 0;
+        }
+
+        /**
+         * @brief Check if compression and writing to output are done in separate thread
+         */
+        bool is_async() const {
+            return m_async != nullptr;
+        }
+
+        /**
+         * @brief Check if output queue can drop Blocks that were already successfully committed
+         * (OutputQueuePolicy::DROP_OLDEST)
+         */
+        bool drops_committed() const {
+            return m_async && m_async->get_parameters().policy == OutputQueuePolicy::DROP_OLDEST;
+        }
+
+        /**
+         * @brief Get total number of bytes written to the final output (after compression). Compressors
+         * and asynchronous output buffer data, so this value lags behind the uncompressed bytes.
+         * @return Number of bytes written to output
+         */
+        uint64_t get_output_bytes() const {
+            return m_cos->get_output_bytes();
+        }
+
+        /**
+         * @brief Get total time spent by compressing and writing data to output. If the encoder is
+         * asynchronous this time is spent in the output thread.
+         * @return Total output time
+         */
+        std::chrono::nanoseconds get_output_time() {
+            return m_async ? m_async->get_output_time() : m_output_time;
+        }
+
+        /**
+         * @brief Get total time spent waiting for room in full output queue
+         * @return Total blocked time (always 0 if the encoder isn't asynchronous)
+         */
+        std::chrono::nanoseconds get_blocked_time() {
+            return m_async ? m_async->get_blocked_time() : std::chrono::nanoseconds(0);
+        }
+
+        /**
+         * @brief Get number of Blocks waiting in output queue or being written
+         * @return Number of Blocks in flight (always 0 if the encoder isn't asynchronous)
+         */
+        std::size_t get_queued_blocks() {
+            return m_async ? m_async->get_queued_blocks() : 0;
+        }
+
+        /**
+         * @brief Get number of uncompressed bytes waiting in output queue or being written
+         * @return Number of bytes in flight (always 0 if the encoder isn't asynchronous)
+         */
+        std::size_t get_queued_bytes() {
+            return m_async ? m_async->get_queued_bytes() : 0;
+        }
+
         private:
         /**
          * @brief Write contents of internal buffer to ouptut C-DNS file
@@ -253,8 +400,10 @@ namespace CDNS {
         }
 
         std::unique_ptr<BaseCborOutputWriter> m_cos;
+        AsyncCborOutputWriter* m_async; //!< Points to m_cos if output is asynchronous
         unsigned char m_buffer[BUFFER_SIZE];
         unsigned char *m_p;
         std::size_t m_avail;
+        std::chrono::nanoseconds m_output_time; //!< Time spent in synchronous output writer
     };
 }
\ No newline at end of file
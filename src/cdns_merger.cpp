@@ -0,0 +1,394 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <queue>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <utility>
+#include <functional>
+
+#include "cdns_merger.h"
+#include "cdns.h"
+
+namespace {
+
+    /**
+     * @brief Read next Block of the given type from C-DNS reader
+     */
+    void read_next(CDNS::CdnsReader& reader, CDNS::CdnsBlockRead& block, bool& eof)
+    {
+        reader.read_block(block, eof);
+    }
+
+    void read_next(CDNS::CdnsReader& reader, CDNS::CdnsRawBlock& block, bool& eof)
+    {
+        reader.read_raw_block(block, eof);
+    }
+
+    /**
+     * @brief Reads Blocks of multiple inputs ahead in a pool of worker threads
+     *
+     * Each input is read by at most one thread at a time, so its Blocks are queued in the order
+     * they appear in the input. Workers always read ahead the input with the lowest index that has
+     * room in its queue, so inputs consumed in the order of their indexes are read in that order too.
+     */
+    template<typename T>
+    class BlockPrefetcher {
+        public:
+        using ErrorCallback = std::function<void(std::size_t, const std::exception&)>;
+
+        /**
+         * @brief Construct a new BlockPrefetcher object and start its worker threads
+         * @param readers Readers of the inputs
+         * @param threads Number of worker threads (0 = Blocks are read in the caller's thread)
+         * @param input_ahead Maximum number of Blocks read ahead for one input
+         * @param total_ahead Maximum number of Blocks read ahead for all inputs together
+         * @param on_error Callback reporting errors of reading inputs (errors are thrown if empty)
+         */
+        BlockPrefetcher(const std::vector<CDNS::CdnsReader*>& readers, unsigned threads,
+                        std::size_t input_ahead, std::size_t total_ahead, const ErrorCallback& on_error)
+            : m_slots(readers.size()), m_input_ahead(input_ahead), m_total_ahead(total_ahead), m_ahead(0),
+              m_stop(false), m_on_error(on_error) {
+            for (std::size_t i = 0; i < readers.size(); i++)
+                m_slots[i].reader = readers[i];
+
+            for (unsigned i = 0; i < threads; i++)
+                m_workers.emplace_back(&BlockPrefetcher::work, this);
+        }
+
+        /**
+         * @brief Stop worker threads. Blocks read ahead are discarded.
+         */
+        ~BlockPrefetcher() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_work_cv.notify_all();
+
+            for (auto& worker : m_workers)
+                worker.join();
+        }
+
+        /**
+         * @brief Get next Block of given input. Waits until a worker thread reads it.
+         * @param input Index of the input
+         * @throw std::exception if reading of the input failed and no error callback is set
+         * @return Next Block of the input or `nullptr` if the input reached its end or failed
+         */
+        std::unique_ptr<T> next(std::size_t input) {
+            Slot& slot = m_slots[input];
+
+            if (m_workers.empty()) {
+                if (slot.end)
+                    return nullptr;
+
+                std::unique_ptr<T> block(new T());
+                try {
+                    read_next(*slot.reader, *block, slot.end);
+                }
+                catch (std::exception& e) {
+                    slot.end = true;
+                    if (!m_on_error)
+                        throw;
+                    m_on_error(input, e);
+                }
+                return slot.end ? nullptr : std::move(block);
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready_cv.wait(lock, [&slot]() { return !slot.ready.empty() || slot.end; });
+
+            if (slot.ready.empty()) {
+                if (slot.error) {
+                    std::exception_ptr error = slot.error;
+                    slot.error = nullptr;
+                    lock.unlock();
+                    report(input, error);
+                }
+                return nullptr;
+            }
+
+            std::unique_ptr<T> block = std::move(slot.ready.front());
+            slot.ready.pop_front();
+            m_ahead--;
+            lock.unlock();
+            m_work_cv.notify_one();
+            return block;
+        }
+
+        private:
+        /**
+         * @brief Report error of reading input to the callback or throw it if no callback is set
+         */
+        void report(std::size_t input, std::exception_ptr error) {
+            try {
+                std::rethrow_exception(error);
+            }
+            catch (std::exception& e) {
+                if (!m_on_error)
+                    throw;
+                m_on_error(input, e);
+            }
+        }
+
+        /**
+         * @brief State of one input
+         */
+        struct Slot {
+            Slot() : reader(nullptr), ready(), busy(false), end(false), error() {}
+
+            CDNS::CdnsReader* reader;
+            std::deque<std::unique_ptr<T>> ready; //!< Blocks read ahead
+            bool busy; //!< `true` if a worker thread is reading the input
+            bool end; //!< `true` if the input reached its end or its reading failed
+            std::exception_ptr error; //!< Exception thrown while reading the input
+        };
+
+        /**
+         * @brief Find input to read ahead. Caller must hold m_mutex.
+         * @param input Set by this method to index of the input
+         * @return `true` if an input was found, `false` otherwise
+         */
+        bool pick(std::size_t& input) {
+            if (m_ahead >= m_total_ahead)
+                return false;
+
+            for (std::size_t i = 0; i < m_slots.size(); i++) {
+                Slot& slot = m_slots[i];
+                if (!slot.busy && !slot.end && slot.ready.size() < m_input_ahead) {
+                    input = i;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief Main loop of worker threads
+         */
+        void work() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            std::size_t input = 0;
+
+            while (true) {
+                m_work_cv.wait(lock, [this, &input]() { return m_stop || pick(input); });
+                if (m_stop)
+                    return;
+
+                Slot& slot = m_slots[input];
+                slot.busy = true;
+                m_ahead++;
+                lock.unlock();
+
+                std::unique_ptr<T> block(new T());
+                bool eof = false;
+                std::exception_ptr error;
+                try {
+                    read_next(*slot.reader, *block, eof);
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+
+                lock.lock();
+                slot.busy = false;
+                if (error || eof) {
+                    slot.end = true;
+                    slot.error = error;
+                    m_ahead--;
+                }
+                else {
+                    slot.ready.push_back(std::move(block));
+                }
+
+                m_ready_cv.notify_all();
+                m_work_cv.notify_one();
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        std::size_t m_input_ahead;
+        std::size_t m_total_ahead;
+        std::size_t m_ahead; //!< Number of Blocks read ahead or being read by worker threads
+        bool m_stop;
+        ErrorCallback m_on_error;
+        std::vector<std::thread> m_workers;
+        std::mutex m_mutex;
+        std::condition_variable m_work_cv;
+        std::condition_variable m_ready_cv;
+    };
+
+    /**
+     * @brief Number of Blocks read ahead per worker thread when inputs are merged one by one
+     */
+    constexpr std::size_t BLOCKS_AHEAD_PER_THREAD = 2;
+
+    /**
+     * @brief State of input in time ordered merge
+     */
+    struct TimeOrderedInput {
+        TimeOrderedInput() : block(), qr(), qr_end(true), mm(), mm_end(true), end(false) {}
+
+        /**
+         * @brief Check if the next item of the input is Query/Response (Query/Response goes first
+         * if timestamps are equal)
+         */
+        bool next_is_qr() const {
+            return mm_end || (!qr_end && qr.ts.value_or(CDNS::Timestamp()) <= mm.ts.value_or(CDNS::Timestamp()));
+        }
+
+        /**
+         * @brief Get timestamp of the next item of the input
+         */
+        CDNS::Timestamp next_ts() const {
+            return next_is_qr() ? qr.ts.value_or(CDNS::Timestamp()) : mm.ts.value_or(CDNS::Timestamp());
+        }
+
+        std::unique_ptr<CDNS::CdnsBlockRead> block; //!< Currently merged Block of the input
+        CDNS::GenericQueryResponse qr; //!< Next Query/Response of the current Block
+        bool qr_end; //!< `true` if all Query/Responses of the current Block were merged
+        CDNS::GenericMalformedMessage mm; //!< Next Malformed Message of the current Block
+        bool mm_end; //!< `true` if all Malformed Messages of the current Block were merged
+        bool end; //!< `true` if all items of the input were merged
+    };
+
+    /**
+     * @brief Read next Blocks of the input until it has an item to merge or it reaches its end.
+     * Address Event Counts of the read Blocks are buffered to the exporter.
+     * @return Number of uncompressed bytes written to output by the exporter
+     */
+    std::size_t next_block(TimeOrderedInput& input, std::size_t index, BlockPrefetcher<CDNS::CdnsBlockRead>& blocks,
+                           CDNS::CdnsExporter& exporter)
+    {
+        std::size_t written = 0;
+
+        while (input.qr_end && input.mm_end) {
+            input.block = blocks.next(index);
+            if (!input.block) {
+                input.end = true;
+                break;
+            }
+
+            bool eof = false;
+            while (true) {
+                CDNS::GenericAddressEventCount aec = input.block->read_generic_aec(eof);
+                if (eof)
+                    break;
+                written += exporter.buffer_aec(aec);
+            }
+
+            input.qr = input.block->read_generic_qr(input.qr_end);
+            input.mm = input.block->read_generic_mm(input.mm_end);
+        }
+
+        return written;
+    }
+
+    /**
+     * @brief Write Blocks of all inputs one by one to the exporter
+     */
+    template<typename T>
+    std::size_t write_blocks(const std::vector<CDNS::CdnsReader*>& readers,
+                             const std::vector<std::vector<CDNS::index_t>>& block_indexes, unsigned threads,
+                             const typename BlockPrefetcher<T>::ErrorCallback& on_error, CDNS::CdnsExporter& exporter)
+    {
+        std::size_t ahead = BLOCKS_AHEAD_PER_THREAD * threads;
+        BlockPrefetcher<T> blocks(readers, threads, ahead, ahead, on_error);
+        std::size_t written = 0;
+
+        for (std::size_t i = 0; i < readers.size(); i++) {
+            while (auto block = blocks.next(i)) {
+                auto index = block->get_block_parameters_index();
+                if (index < block_indexes[i].size())
+                    block->m_block_preamble.block_parameters_index = block_indexes[i][index];
+                else if (!block_indexes[i].empty())
+                    throw CDNS::CdnsEncoderException("Block parameters index of merged C-DNS block is too high");
+
+                written += exporter.write_block(*block);
+            }
+        }
+
+        return written;
+    }
+}
+
+void CDNS::CdnsMerger::add_input(CdnsReader& reader, const std::vector<index_t>& block_indexes)
+{
+    m_inputs.push_back({&reader, block_indexes});
+}
+
+std::size_t CDNS::CdnsMerger::merge_blocks(CdnsExporter& exporter, bool decode)
+{
+    std::vector<CdnsReader*> readers;
+    std::vector<std::vector<index_t>> block_indexes;
+    for (auto& input : m_inputs) {
+        readers.push_back(input.reader);
+        block_indexes.push_back(input.block_indexes);
+    }
+
+    if (decode)
+        return write_blocks<CdnsBlockRead>(readers, block_indexes, m_threads, m_error_callback, exporter);
+    else
+        return write_blocks<CdnsRawBlock>(readers, block_indexes, m_threads, m_error_callback, exporter);
+}
+
+std::size_t CDNS::CdnsMerger::merge_time_ordered(CdnsExporter& exporter)
+{
+    std::vector<CdnsReader*> readers;
+    for (auto& input : m_inputs)
+        readers.push_back(input.reader);
+
+    // Every input needs its next Block soon, so one Block of each input is read ahead
+    BlockPrefetcher<CdnsBlockRead> blocks(readers, m_threads, 1, readers.size(), m_error_callback);
+    std::vector<TimeOrderedInput> inputs(readers.size());
+
+    // Heap of inputs ordered by timestamp of their next item and then by order of inputs
+    using HeapItem = std::pair<Timestamp, std::size_t>;
+    auto cmp = [](const HeapItem& lhs, const HeapItem& rhs) {
+        if (rhs.first < lhs.first)
+            return true;
+        else if (lhs.first < rhs.first)
+            return false;
+        return lhs.second > rhs.second;
+    };
+    std::priority_queue<HeapItem, std::vector<HeapItem>, decltype(cmp)> heap(cmp);
+    std::size_t written = 0;
+
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+        written += next_block(inputs[i], i, blocks, exporter);
+        if (!inputs[i].end)
+            heap.emplace(inputs[i].next_ts(), i);
+    }
+
+    while (!heap.empty()) {
+        std::size_t index = heap.top().second;
+        TimeOrderedInput& input = inputs[index];
+        heap.pop();
+
+        if (input.next_is_qr()) {
+            written += exporter.buffer_qr(input.qr);
+            input.qr = input.block->read_generic_qr(input.qr_end);
+        }
+        else {
+            written += exporter.buffer_mm(input.mm);
+            input.mm = input.block->read_generic_mm(input.mm_end);
+        }
+
+        written += next_block(input, index, blocks, exporter);
+        if (!input.end)
+            heap.emplace(input.next_ts(), index);
+    }
+
+    return written;
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <exception>
+#include <functional>
+
+#include "format_specification.h"
+
+namespace CDNS {
+
+    class CdnsReader;
+    class CdnsExporter;
+
+    /**
+     * @brief Merges Blocks or items from multiple C-DNS inputs into one C-DNS output
+     *
+     * Blocks of the inputs can be read and decoded ahead by a pool of worker threads. The output
+     * doesn't depend on the number of threads, Blocks are always written in the same order.
+     */
+    class CdnsMerger {
+        public:
+        /**
+         * @brief Construct a new CdnsMerger object
+         * @param threads Number of worker threads reading and decoding inputs concurrently
+         * (0 = inputs are read in the caller's thread)
+         */
+        explicit CdnsMerger(unsigned threads = 0) : m_threads(threads) {}
+
+        /**
+         * @brief Add input to merge. The merger reads only Blocks, the reader has to be already
+         * positioned at the first Block (i.e. freshly constructed).
+         * @param reader C-DNS reader of the input, has to outlive the merger
+         * @param block_indexes Indexes of input's Block parameters in output's File preamble used by
+         * merge_blocks() (index `i` of input's Block parameters is rewritten to `block_indexes[i]`).
+         * Indexes are kept as they are if empty.
+         */
+        void add_input(CdnsReader& reader, const std::vector<index_t>& block_indexes = {});
+
+        /**
+         * @brief Set callback reporting errors of reading inputs. If set, input whose reading fails is
+         * treated as if it reached its end and merging continues. Otherwise the error is thrown from
+         * the merging method.
+         * @param cb Callback getting index of the failed input and the error
+         */
+        void set_error_callback(std::function<void(std::size_t, const std::exception&)> cb) {
+            m_error_callback = std::move(cb);
+        }
+
+        /**
+         * @brief Write Blocks of all inputs to given C-DNS exporter, input by input in the order
+         * the inputs were added. Only Block parameters indexes of the Blocks are rewritten.
+         * @param exporter C-DNS exporter to write the Blocks with
+         * @param decode If `true` Blocks are fully decoded and encoded again, otherwise their raw
+         * CBOR data are copied
+         * @throw std::exception if reading any of the inputs or writing output fails
+         * @return Number of uncompressed bytes written to output by the exporter
+         */
+        std::size_t merge_blocks(CdnsExporter& exporter, bool decode = false);
+
+        /**
+         * @brief Merge items of all inputs ordered by time into given C-DNS exporter
+         *
+         * Query/Responses and Malformed Messages of all inputs are ordered by their timestamps with k-way
+         * merge and buffered to the exporter, which re-packs them into full Blocks with newly built Block
+         * tables. Inputs are expected to be (mostly) time-ordered, the output is as ordered as the inputs are.
+         * Items with equal timestamps keep the order of inputs in which they were added to the merger.
+         * Address Event Counts have no timestamp and are buffered when the input Block containing them
+         * is reached. Block statistics of input Blocks are not carried over to output Blocks.
+         *
+         * The last partially filled Block stays buffered in the exporter, call CdnsExporter::write_block()
+         * to write it.
+         * @param exporter C-DNS exporter to buffer merged items into
+         * @throw std::exception if reading any of the inputs or writing output fails
+         * @return Number of uncompressed bytes written to output by the exporter
+         */
+        std::size_t merge_time_ordered(CdnsExporter& exporter);
+
+        private:
+        /**
+         * @brief Merged input
+         */
+        struct Input {
+            CdnsReader* reader;
+            std::vector<index_t> block_indexes;
+        };
+
+        std::vector<Input> m_inputs;
+        unsigned m_threads;
+        std::function<void(std::size_t, const std::exception&)> m_error_callback;
+    };
+}
@@ -0,0 +1,134 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <boost/optional.hpp>
+#include <boost/none.hpp>
+
+#include "hash.h"
+
+namespace CDNS {
+
+    /**
+     * @brief Optional value stored without alignment padding
+     *
+     * The value is stored as raw bytes right after its presence flag, so CompactOptional has alignment 1
+     * and size of the value plus one byte. Bytes of a missing value are always zero. Structures built only
+     * from CompactOptional members therefore have no padding and can be compared and hashed as one block
+     * of memory. Unlike boost::optional the value is accessed by copy.
+     */
+    template<typename T>
+    class CompactOptional {
+        static_assert(std::is_trivially_copyable<T>::value, "CompactOptional needs trivially copyable type");
+
+        public:
+        using value_type = T;
+
+        CompactOptional() : m_set(0), m_value() {}
+        CompactOptional(boost::none_t) : CompactOptional() {}
+        CompactOptional(const T& value) : m_set(1), m_value() { std::memcpy(m_value, &value, sizeof(T)); }
+        CompactOptional(const boost::optional<T>& value) : CompactOptional() {
+            if (value)
+                emplace(*value);
+        }
+
+        CompactOptional& operator=(boost::none_t) {
+            reset();
+            return *this;
+        }
+
+        CompactOptional& operator=(const T& value) {
+            emplace(value);
+            return *this;
+        }
+
+        CompactOptional& operator=(const boost::optional<T>& value) {
+            if (value)
+                emplace(*value);
+            else
+                reset();
+            return *this;
+        }
+
+        /**
+         * @brief Set the value
+         */
+        void emplace(const T& value) {
+            m_set = 1;
+            std::memcpy(m_value, &value, sizeof(T));
+        }
+
+        /**
+         * @brief Remove the value
+         */
+        void reset() {
+            m_set = 0;
+            std::memset(m_value, 0, sizeof(T));
+        }
+
+        bool is_initialized() const { return m_set != 0; }
+        explicit operator bool() const { return m_set != 0; }
+        bool operator!() const { return m_set == 0; }
+
+        /**
+         * @brief Get copy of the value
+         * @throw boost::bad_optional_access if the value isn't set
+         */
+        T value() const {
+            if (!m_set)
+                throw boost::bad_optional_access();
+            return get();
+        }
+
+        /**
+         * @brief Get copy of the value without checking its presence
+         */
+        T get() const {
+            T ret;
+            std::memcpy(&ret, m_value, sizeof(T));
+            return ret;
+        }
+
+        T operator*() const { return get(); }
+
+        T value_or(const T& def) const { return m_set ? get() : def; }
+
+        template<typename U>
+        operator boost::optional<U>() const {
+            return m_set ? boost::optional<U>(static_cast<U>(get())) : boost::none;
+        }
+
+        bool operator==(const CompactOptional& rhs) const {
+            return m_set == rhs.m_set && std::memcmp(m_value, rhs.m_value, sizeof(T)) == 0;
+        }
+
+        bool operator!=(const CompactOptional& rhs) const { return !(*this == rhs); }
+
+        private:
+        uint8_t m_set;
+        unsigned char m_value[sizeof(T)];
+    };
+
+    /**
+     * @brief CRC32 calculation for hashes on std::unordered_map non-primitive keys
+     * @param data Optional data to calculate hash on
+     * @param seed Initial seed value for hash calculation
+     * @return Hash value for "data"
+     */
+    template<class T>
+    std::size_t hash_value(CompactOptional<T> const& data, uint32_t seed = ~0U) {
+        if (data)
+            return hash_value(data.get(), seed);
+        else
+            return seed;
+    }
+}
@@ -0,0 +1,152 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <cstring>
+
+#include "dns_parser.h"
+
+CDNS::DnsMessageParser::DnsMessageParser(const uint8_t* msg, std::size_t size)
+    : m_msg(msg), m_size(size), m_valid(false), m_trailing_data(false), m_pos(0), m_section(0),
+      m_remaining(), m_opt_rdata(nullptr), m_opt_rdata_size(0), m_opt_udp_size(0),
+      m_opt_extended_rcode(0), m_opt_version(0), m_opt_do(false)
+{
+    if (!msg || size < HEADER_SIZE)
+        return;
+
+    // Walk through the whole message to validate it and find OPT record
+    m_valid = true;
+    rewind();
+
+    DnsRecord record;
+    while (next(record)) {
+        if (record.section == DnsSection::ADDITIONAL && record.type == OPT_TYPE && !m_opt_rdata) {
+            // Empty RDATA has to be distinguishable from missing OPT record
+            m_opt_rdata = record.rdata ? record.rdata : m_msg + m_pos;
+            m_opt_rdata_size = record.rdata_size;
+            m_opt_udp_size = record.class_;
+            m_opt_extended_rcode = record.ttl >> 24;
+            m_opt_version = (record.ttl >> 16) & 0xFF;
+            m_opt_do = record.ttl & 0x8000;
+        }
+    }
+
+    if (!m_valid)
+        return;
+
+    m_trailing_data = m_pos < m_size;
+    rewind();
+}
+
+void CDNS::DnsMessageParser::rewind()
+{
+    m_pos = HEADER_SIZE;
+    m_section = 0;
+
+    for (uint8_t i = 0; i < 4; i++)
+        m_remaining[i] = count(static_cast<DnsSection>(i));
+}
+
+bool CDNS::DnsMessageParser::next(DnsRecord& record)
+{
+    if (!m_valid)
+        return false;
+
+    while (m_section < 4 && m_remaining[m_section] == 0)
+        m_section++;
+
+    if (m_section >= 4)
+        return false;
+
+    std::size_t pos = m_pos;
+    record.section = static_cast<DnsSection>(m_section);
+
+    if (!read_name(pos, record.name, record.name_size) || pos + 4 > m_size) {
+        m_valid = false;
+        return false;
+    }
+
+    record.type = read16(pos);
+    record.class_ = read16(pos + 2);
+    pos += 4;
+
+    if (record.section == DnsSection::QUESTION) {
+        record.ttl = 0;
+        record.rdata = nullptr;
+        record.rdata_size = 0;
+    }
+    else {
+        if (pos + 6 > m_size) {
+            m_valid = false;
+            return false;
+        }
+
+        record.ttl = read32(pos);
+        record.rdata_size = read16(pos + 4);
+        pos += 6;
+
+        if (pos + record.rdata_size > m_size) {
+            m_valid = false;
+            return false;
+        }
+
+        record.rdata = record.rdata_size ? m_msg + pos : nullptr;
+        pos += record.rdata_size;
+    }
+
+    m_pos = pos;
+    m_remaining[m_section]--;
+    return true;
+}
+
+bool CDNS::DnsMessageParser::read_name(std::size_t& pos, uint8_t* out, std::size_t& out_size) const
+{
+    std::size_t cur = pos;
+    std::size_t end = 0; // Position after the NAME in the original place, set at first compression pointer
+    out_size = 0;
+
+    while (cur < m_size) {
+        uint8_t label = m_msg[cur];
+
+        if (label == 0) {
+            if (out_size + 1 > DnsRecord::MAX_NAME_SIZE)
+                return false;
+
+            out[out_size++] = 0;
+            pos = end ? end : cur + 1;
+            return true;
+        }
+
+        // Compression pointer. It has to point before itself to prevent loops.
+        if ((label & 0xC0) == 0xC0) {
+            if (cur + 2 > m_size)
+                return false;
+
+            std::size_t target = static_cast<std::size_t>(label & 0x3F) << 8 | m_msg[cur + 1];
+            if (target >= cur)
+                return false;
+
+            if (!end)
+                end = cur + 2;
+            cur = target;
+            continue;
+        }
+
+        // Extended label types aren't supported
+        if (label & 0xC0)
+            return false;
+
+        if (cur + 1 + label > m_size || out_size + 1 + label > DnsRecord::MAX_NAME_SIZE)
+            return false;
+
+        std::memcpy(out + out_size, m_msg + cur, label + 1);
+        out_size += label + 1;
+        cur += label + 1;
+    }
+
+    return false;
+}
@@ -0,0 +1,181 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace CDNS {
+
+    /**
+     * @enum DnsSection
+     * @brief Sections of DNS message
+     */
+    enum class DnsSection : uint8_t {
+        QUESTION = 0,
+        ANSWER,
+        AUTHORITY,
+        ADDITIONAL
+    };
+
+    /**
+     * @brief One Question or Resource record parsed from DNS message.
+     *
+     * NAME is decompressed into the fixed buffer, RDATA points into the parsed DNS message.
+     */
+    struct DnsRecord {
+        static constexpr std::size_t MAX_NAME_SIZE = 255;
+
+        DnsSection section;
+        uint8_t name[MAX_NAME_SIZE]; //!< Uncompressed NAME in wire format
+        std::size_t name_size;
+        uint16_t type;
+        uint16_t class_;
+        uint32_t ttl; // Not used in Question records
+        const uint8_t* rdata; // Not used in Question records
+        uint16_t rdata_size; // Not used in Question records
+    };
+
+    /**
+     * @brief Allocation free parser of DNS messages in wire format
+     *
+     * The whole message is validated in constructor. Records are then iterated with next(). Parser
+     * doesn't copy the message, so the message has to stay valid during the parser's lifetime.
+     */
+    class DnsMessageParser {
+        public:
+        static constexpr std::size_t HEADER_SIZE = 12;
+        static constexpr uint16_t OPT_TYPE = 41;
+
+        /**
+         * @brief Construct a new DnsMessageParser object and validate the DNS message
+         * @param msg Start of the DNS message
+         * @param size Size of the DNS message
+         */
+        DnsMessageParser(const uint8_t* msg, std::size_t size);
+
+        /**
+         * @brief Check if the whole DNS message was parsed successfully
+         */
+        bool valid() const { return m_valid; }
+
+        /**
+         * @brief Get transaction ID from DNS header
+         */
+        uint16_t id() const { return read16(0); }
+
+        /**
+         * @brief Get flags word (QR, OPCODE, AA, TC, RD, RA, Z, AD, CD, RCODE) from DNS header
+         */
+        uint16_t header_flags() const { return read16(2); }
+
+        /**
+         * @brief Check if the DNS message is response
+         */
+        bool is_response() const { return header_flags() & 0x8000; }
+
+        /**
+         * @brief Get OPCODE from DNS header
+         */
+        uint8_t opcode() const { return (header_flags() >> 11) & 0x0F; }
+
+        /**
+         * @brief Get RCODE including the upper bits from OPT record if present
+         */
+        uint16_t rcode() const {
+            return (header_flags() & 0x0F) | (static_cast<uint16_t>(m_opt_extended_rcode) << 4);
+        }
+
+        /**
+         * @brief Get number of records in given section from DNS header
+         */
+        uint16_t count(DnsSection section) const { return read16(4 + 2 * static_cast<uint8_t>(section)); }
+
+        /**
+         * @brief Check if the DNS message has data after the last record
+         */
+        bool has_trailing_data() const { return m_trailing_data; }
+
+        /**
+         * @brief Check if the DNS message contains OPT record
+         */
+        bool has_opt() const { return m_opt_rdata != nullptr; }
+
+        /**
+         * @brief Get EDNS version from OPT record
+         */
+        uint8_t edns_version() const { return m_opt_version; }
+
+        /**
+         * @brief Get EDNS UDP payload size from OPT record
+         */
+        uint16_t udp_size() const { return m_opt_udp_size; }
+
+        /**
+         * @brief Check if DNSSEC OK bit is set in OPT record
+         */
+        bool edns_do() const { return m_opt_do; }
+
+        /**
+         * @brief Get start of OPT record's RDATA
+         */
+        const uint8_t* opt_rdata() const { return m_opt_rdata; }
+
+        /**
+         * @brief Get size of OPT record's RDATA
+         */
+        uint16_t opt_rdata_size() const { return m_opt_rdata_size; }
+
+        /**
+         * @brief Start iterating records from the beginning of the DNS message
+         */
+        void rewind();
+
+        /**
+         * @brief Parse next record of the DNS message
+         * @param record Parsed record
+         * @return `false` if there are no more records or the message is malformed
+         */
+        bool next(DnsRecord& record);
+
+        /**
+         * @brief Decompress NAME from DNS message
+         * @param pos Position of the NAME in DNS message. Set to position after the NAME on success.
+         * @param out Buffer of at least DnsRecord::MAX_NAME_SIZE bytes for uncompressed NAME
+         * @param out_size Size of the uncompressed NAME
+         * @return `false` if the NAME is malformed
+         */
+        bool read_name(std::size_t& pos, uint8_t* out, std::size_t& out_size) const;
+
+        private:
+        uint16_t read16(std::size_t pos) const {
+            return static_cast<uint16_t>(m_msg[pos] << 8 | m_msg[pos + 1]);
+        }
+
+        uint32_t read32(std::size_t pos) const {
+            return static_cast<uint32_t>(read16(pos)) << 16 | read16(pos + 2);
+        }
+
+        const uint8_t* m_msg;
+        std::size_t m_size;
+        bool m_valid;
+        bool m_trailing_data;
+
+        std::size_t m_pos; //!< Position of the next record
+        uint8_t m_section; //!< Section of the next record
+        uint16_t m_remaining[4]; //!< Remaining records in each section
+
+        const uint8_t* m_opt_rdata;
+        uint16_t m_opt_rdata_size;
+        uint16_t m_opt_udp_size;
+        uint8_t m_opt_extended_rcode;
+        uint8_t m_opt_version;
+        bool m_opt_do;
+    };
+}
@@ -164,7 +164,7 @@ namespace CDNS {
      * @enum BlockStatisticsMapIndex
      * @brief Block Statistics map indexes
      */
-    enum class BlockStatisticsMapIndex : uint8_t {
+    enum class BlockStatisticsMapIndex : int8_t {
         processed_messages = 0,
         qr_data_items = 1,
         unmatched_queries = 2,
@@ -172,7 +172,13 @@ namespace CDNS {
         discarded_opcode = 4,
         malformed_items = 5,
 
-        block_statistics_size
+        block_statistics_standard_size, //!< Number of Block statistics defined by RFC 8618
+
+        // Implementation specific Block statistics have negative keys numbered down from -1
+        dropped_items = -1, //!< Items dropped by exporter's output queue since the previous written Block
+        block_statistics_private_last = dropped_items, //!< Has to be set to the last implementation specific key
+
+        block_statistics_size = block_statistics_standard_size - block_statistics_private_last
     };
 
     /**
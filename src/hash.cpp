@@ -0,0 +1,182 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <smmintrin.h>
+#define CDNS_HASH_X86
+#endif
+
+#include "hash.h"
+
+namespace {
+    using Crc32cFunction = uint32_t (*)(const char*, std::size_t, uint32_t);
+
+    /**
+     * @brief Lookup tables for slicing-by-8 CRC32C (Castagnoli polynomial, reflected)
+     */
+    struct Crc32cTables {
+        Crc32cTables() : table() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (unsigned j = 0; j < 8; j++)
+                    crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78 : 0);
+                table[0][i] = crc;
+            }
+
+            for (uint32_t i = 0; i < 256; i++) {
+                for (unsigned t = 1; t < 8; t++)
+                    table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+            }
+        }
+
+        uint32_t table[8][256];
+    };
+
+    const Crc32cTables& tables() {
+        static const Crc32cTables crc_tables;
+        return crc_tables;
+    }
+
+    /**
+     * @brief Portable equivalent of _mm_crc32_u8()
+     */
+    inline uint32_t crc_u8(const Crc32cTables& t, uint32_t crc, const char* p) {
+        return (crc >> 8) ^ t.table[0][(crc ^ static_cast<uint8_t>(*p)) & 0xFF];
+    }
+
+    /**
+     * @brief Portable equivalent of _mm_crc32_u64() on little endian data
+     */
+    inline uint32_t crc_u64(const Crc32cTables& t, uint32_t crc, const char* p) {
+        const uint8_t* b = reinterpret_cast<const uint8_t*>(p);
+        uint32_t low = crc ^ (b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24));
+        return t.table[7][low & 0xFF] ^ t.table[6][(low >> 8) & 0xFF] ^
+               t.table[5][(low >> 16) & 0xFF] ^ t.table[4][low >> 24] ^
+               t.table[3][b[4]] ^ t.table[2][b[5]] ^ t.table[1][b[6]] ^ t.table[0][b[7]];
+    }
+
+    uint32_t crc32c_portable(const char* data, std::size_t size, uint32_t crc) {
+        const Crc32cTables& t = tables();
+
+        if (size >= CDNS::HASH_LANES_THRESHOLD) {
+            std::size_t lane = size / 24 * 8;
+            uint32_t crc1 = ~0U;
+            uint32_t crc2 = ~0U;
+
+            for (std::size_t i = 0; i < lane; i += 8) {
+                crc = crc_u64(t, crc, data + i);
+                crc1 = crc_u64(t, crc1, data + lane + i);
+                crc2 = crc_u64(t, crc2, data + 2 * lane + i);
+            }
+
+            // Fold the other lanes into the first one the same way as 4 byte data
+            for (uint32_t lane_crc : {crc1, crc2}) {
+                char bytes[4];
+                for (unsigned i = 0; i < 4; i++)
+                    bytes[i] = static_cast<char>(lane_crc >> (8 * i));
+                for (unsigned i = 0; i < 4; i++)
+                    crc = crc_u8(t, crc, bytes + i);
+            }
+
+            data += 3 * lane;
+            size -= 3 * lane;
+        }
+
+        for ( ; size >= 8; data += 8, size -= 8)
+            crc = crc_u64(t, crc, data);
+        for ( ; size > 0; data++, size--)
+            crc = crc_u8(t, crc, data);
+
+        return crc;
+    }
+
+#ifdef CDNS_HASH_X86
+    __attribute__((target("sse4.2")))
+    uint32_t crc32c_sse42(const char* data, std::size_t size, uint32_t crc) {
+        uint64_t value;
+
+        if (size >= CDNS::HASH_LANES_THRESHOLD) {
+            std::size_t lane = size / 24 * 8;
+            uint64_t crc0 = crc;
+            uint64_t crc1 = ~0U;
+            uint64_t crc2 = ~0U;
+
+            // Lanes have no data dependency between them, so CPU can pipeline the CRC32 instructions
+            for (std::size_t i = 0; i < lane; i += 8) {
+                std::memcpy(&value, data + i, 8);
+                crc0 = _mm_crc32_u64(crc0, value);
+                std::memcpy(&value, data + lane + i, 8);
+                crc1 = _mm_crc32_u64(crc1, value);
+                std::memcpy(&value, data + 2 * lane + i, 8);
+                crc2 = _mm_crc32_u64(crc2, value);
+            }
+
+            crc = _mm_crc32_u32(static_cast<uint32_t>(crc0), static_cast<uint32_t>(crc1));
+            crc = _mm_crc32_u32(crc, static_cast<uint32_t>(crc2));
+            data += 3 * lane;
+            size -= 3 * lane;
+        }
+
+        for ( ; size >= 8; data += 8, size -= 8) {
+            std::memcpy(&value, data, 8);
+            crc = static_cast<uint32_t>(_mm_crc32_u64(crc, value));
+        }
+        for ( ; size > 0; data++, size--)
+            crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+
+        return crc;
+    }
+#endif
+
+    /**
+     * @brief Select implementation supported by the CPU
+     */
+    Crc32cFunction select_crc32c() {
+#ifdef CDNS_HASH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.2"))
+            return &crc32c_sse42;
+#endif
+        return &crc32c_portable;
+    }
+
+    uint32_t crc32c_resolve(const char* data, std::size_t size, uint32_t crc);
+
+    /**
+     * @brief Selected implementation. Resolved on first call, so it's usable during static initialization.
+     */
+    std::atomic<Crc32cFunction> crc32c_impl(&crc32c_resolve);
+
+    uint32_t crc32c_resolve(const char* data, std::size_t size, uint32_t crc) {
+        Crc32cFunction impl = select_crc32c();
+        crc32c_impl.store(impl, std::memory_order_relaxed);
+        return impl(data, size, crc);
+    }
+}
+
+uint32_t CDNS::crc32c_update(const char* data, std::size_t size, uint32_t crc)
+{
+    return crc32c_impl.load(std::memory_order_relaxed)(data, size, crc);
+}
+
+uint32_t CDNS::crc32c_update_portable(const char* data, std::size_t size, uint32_t crc)
+{
+    return crc32c_portable(data, size, crc);
+}
+
+CDNS::HashImplementation CDNS::get_hash_implementation()
+{
+#ifdef CDNS_HASH_X86
+    if (select_crc32c() == &crc32c_sse42)
+        return HashImplementation::SSE42;
+#endif
+    return HashImplementation::PORTABLE;
+}
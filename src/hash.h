@@ -10,13 +10,61 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <smmintrin.h>
 #include <boost/optional.hpp>
 
+#ifdef __SSE4_2__
+#include <smmintrin.h>
+#endif
+
 namespace CDNS {
 
+    /**
+     * @enum HashImplementation
+     * @brief Implementation of CRC32C used for hashing
+     */
+    enum class HashImplementation : uint8_t {
+        PORTABLE = 0, //!< Table driven implementation for any CPU
+        SSE42 //!< CRC32 instruction of SSE4.2
+    };
+
+    /**
+     * @brief Minimal size of data hashed in three independent CRC lanes
+     */
+    static constexpr std::size_t HASH_LANES_THRESHOLD = 96;
+
+    /**
+     * @brief Update CRC32C register with data using the fastest implementation supported by the CPU.
+     * The implementation is selected on the first call.
+     *
+     * Data of at least HASH_LANES_THRESHOLD bytes are split into three lanes computed independently
+     * and folded together, so the result differs from plain CRC32C for long data, but it's the same
+     * for all implementations.
+     * @param data Pointer to the start of data
+     * @param size Size of the data in bytes
+     * @param crc Current value of CRC register
+     * @return Updated value of CRC register
+     */
+    uint32_t crc32c_update(const char* data, std::size_t size, uint32_t crc);
+
+    /**
+     * @brief Update CRC32C register with data using the portable implementation
+     * @param data Pointer to the start of data
+     * @param size Size of the data in bytes
+     * @param crc Current value of CRC register
+     * @return Updated value of CRC register, same as from crc32c_update()
+     */
+    uint32_t crc32c_update_portable(const char* data, std::size_t size, uint32_t crc);
+
+    /**
+     * @brief Get CRC32C implementation selected for this CPU by crc32c_update()
+     */
+    HashImplementation get_hash_implementation();
+
     /**
      * @brief CRC32 calculation for hashes on std::unordered_map non-primitive keys
+     *
+     * If the library is compiled with SSE4.2 enabled, short data are hashed inline. Otherwise
+     * the implementation is selected at runtime according to the CPU.
      * @param data Pointer to the start of data to calculate hash on
      * @param size Size of the data in bytes
      * @param seed Initial seed value for hash calculation
@@ -25,33 +73,28 @@ namespace CDNS {
     template<class T>
     std::size_t hash_value(T const* data, std::size_t size, uint32_t seed = ~0U) {
         const char* start = reinterpret_cast<const char*>(data);
-        const char* end = start + size;
-        uint32_t ret = seed;
+#ifdef __SSE4_2__
+        if (size < HASH_LANES_THRESHOLD) {
+            const char* end = start + size;
+            uint32_t ret = seed;
 
-        for ( ; start < end; ) {
-            // At least 8 bytes of data left
-            if (start + 8 <= end) {
+            for ( ; start + 8 <= end; start += 8)
                 ret = _mm_crc32_u64(ret, *reinterpret_cast<const uint64_t*>(start));
-                start += 8;
-            }
-            // At least 4 bytes of data left
-            else if (start + 4 <= end) {
+            if (start + 4 <= end) {
                 ret = _mm_crc32_u32(ret, *reinterpret_cast<const uint32_t*>(start));
                 start += 4;
             }
-            // At least 2 bytes of data left
-            else if (start + 2 <= end) {
+            if (start + 2 <= end) {
                 ret = _mm_crc32_u16(ret, *reinterpret_cast<const uint16_t*>(start));
                 start += 2;
             }
-            // 1 byte of data left
-            else {
+            if (start < end)
                 ret = _mm_crc32_u8(ret, *reinterpret_cast<const uint8_t*>(start));
-                start += 1;
-            }
-        }
 
-        return static_cast<std::size_t>(~ret);
+            return static_cast<std::size_t>(~ret);
+        }
+#endif
+        return static_cast<std::size_t>(~crc32c_update(start, size, seed));
     }
 
     /**
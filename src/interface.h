@@ -103,6 +103,35 @@ namespace CDNS {
         boost::optional<std::string> policy_rule; //!< Rule that triggered policy application on query. Based on policy.rule field from dnstap schema
     };
 
+    /**
+     * @brief Structure for holding raw DNS messages of 1 DNS transaction with their transport metadata
+     * before storing it into Block
+     *
+     * Doesn't own any data. Messages and IP addresses have to stay valid until the structure is stored
+     * into Block. DNS messages are parsed by the library and only items enabled by storage hints are stored.
+     */
+    struct WireQueryResponse {
+        WireQueryResponse() : client_ip(nullptr), client_ip_size(0), server_ip(nullptr), server_ip_size(0),
+                              query(nullptr), query_size(0), response(nullptr), response_size(0) {}
+
+        boost::optional<Timestamp> ts;
+        const char* client_ip; //!< Client IP address in network byte order
+        std::size_t client_ip_size;
+        boost::optional<uint16_t> client_port;
+        const char* server_ip; //!< Server IP address in network byte order
+        std::size_t server_ip_size;
+        boost::optional<uint16_t> server_port;
+        boost::optional<QueryResponseTransportFlagsMask> qr_transport_flags;
+        boost::optional<QueryResponseTypeValues> qr_type;
+        boost::optional<uint8_t> client_hoplimit;
+        boost::optional<int64_t> response_delay;
+
+        const uint8_t* query; //!< Query DNS message in wire format or `nullptr` if there's no query
+        std::size_t query_size;
+        const uint8_t* response; //!< Response DNS message in wire format or `nullptr` if there's no response
+        std::size_t response_size;
+    };
+
     /**
      * @brief Generic structure for holding 1 Address Event Count before storing it into Block
      *
@@ -123,7 +152,7 @@ namespace CDNS {
         boost::optional<uint8_t> ae_code;
         boost::optional<QueryResponseTransportFlagsMask> ae_transport_flags;
         std::string ip_address;
-        uint64_t ae_count;
+        uint64_t ae_count; //!< Number of occurrences of the event (0 is buffered as a single occurrence)
     };
 
     /**
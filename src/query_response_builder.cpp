@@ -0,0 +1,673 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <stdexcept>
+
+#include "query_response_builder.h"
+
+namespace {
+    /**
+     * @brief Convert flags from DNS header (and DO bit from OPT record) to query part of DNSFlagsMask.
+     * Response flags are the same shifted by 8 bits.
+     */
+    uint16_t header_to_dns_flags(uint16_t header, bool edns_do)
+    {
+        uint16_t flags = 0;
+
+        if (header & 0x0010)
+            flags |= CDNS::DNSFlagsMask::query_cd;
+        if (header & 0x0020)
+            flags |= CDNS::DNSFlagsMask::query_ad;
+        if (header & 0x0040)
+            flags |= CDNS::DNSFlagsMask::query_z;
+        if (header & 0x0080)
+            flags |= CDNS::DNSFlagsMask::query_ra;
+        if (header & 0x0100)
+            flags |= CDNS::DNSFlagsMask::query_rd;
+        if (header & 0x0200)
+            flags |= CDNS::DNSFlagsMask::query_tc;
+        if (header & 0x0400)
+            flags |= CDNS::DNSFlagsMask::query_aa;
+        if (edns_do)
+            flags |= CDNS::DNSFlagsMask::query_do;
+
+        return flags;
+    }
+
+    /**
+     * @brief Map DNS message section to query or response section of QueryResponse
+     */
+    CDNS::QueryResponseSection qr_section(CDNS::DnsSection section, bool response)
+    {
+        return static_cast<CDNS::QueryResponseSection>(static_cast<uint8_t>(section) + (response ? 4 : 0));
+    }
+}
+
+CDNS::QueryResponseBuilder::QueryResponseBuilder(CdnsBlock& block)
+    : m_block(block), m_ts(), m_qr(), m_qrs(), m_rpd(), m_qr_filled(false), m_qrs_filled(false),
+      m_rpd_filled(false), m_has_query(false), m_sections()
+{
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::timestamp(const Timestamp& ts)
+{
+    m_ts = ts;
+    if (qr_hint(QueryResponseHintsMask::time_offset)) {
+        m_qr.time_offset = ts;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::client_address(const char* address, std::size_t size)
+{
+    if (qr_hint(QueryResponseHintsMask::client_address_index)) {
+        m_qr.client_address_index = m_block.add_generic_ip_address(address, size, true);
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::client_port(uint16_t port)
+{
+    if (qr_hint(QueryResponseHintsMask::client_port)) {
+        m_qr.client_port = port;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::transaction_id(uint16_t id)
+{
+    if (qr_hint(QueryResponseHintsMask::transaction_id)) {
+        m_qr.transaction_id = id;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::server_address(const char* address, std::size_t size)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::server_address_index)) {
+        m_qrs.server_address_index = m_block.add_generic_ip_address(address, size, false);
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::server_port(uint16_t port)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::server_port)) {
+        m_qrs.server_port = port;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::transport_flags(QueryResponseTransportFlagsMask flags)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::qr_transport_flags)) {
+        m_qrs.qr_transport_flags = flags;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::qr_type(QueryResponseTypeValues type)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::qr_type)) {
+        m_qrs.qr_type = type;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::qr_sig_flags(QueryResponseFlagsMask flags)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::qr_sig_flags)) {
+        m_qrs.qr_sig_flags = flags;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_opcode(uint8_t opcode)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_opcode)) {
+        m_qrs.query_opcode = opcode;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::dns_flags(DNSFlagsMask flags)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::qr_dns_flags)) {
+        m_qrs.qr_dns_flags = flags;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_rcode(uint16_t rcode)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_rcode)) {
+        m_qrs.query_rcode = rcode;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_classtype(const ClassType& classtype)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_classtype_index)) {
+        m_qrs.query_classtype_index = m_block.add_classtype(classtype);
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_qdcount(uint16_t count)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_qdcount)) {
+        m_qrs.query_qdcount = count;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_ancount(uint16_t count)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_ancount)) {
+        m_qrs.query_ancount = count;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_nscount(uint16_t count)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_nscount)) {
+        m_qrs.query_nscount = count;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_arcount(uint16_t count)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_arcount)) {
+        m_qrs.query_arcount = count;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_edns_version(uint8_t version)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_edns_version)) {
+        m_qrs.query_edns_version = version;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_udp_size(uint16_t size)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_udp_size)) {
+        m_qrs.query_udp_size = size;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_opt_rdata(const char* rdata, std::size_t size)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::query_opt_rdata_index)) {
+        m_qrs.query_opt_rdata_index = m_block.add_name_rdata(rdata, size);
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::response_rcode(uint16_t rcode)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::response_rcode)) {
+        m_qrs.response_rcode = rcode;
+        m_qrs_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::client_hoplimit(uint8_t hoplimit)
+{
+    if (qr_hint(QueryResponseHintsMask::client_hoplimit)) {
+        m_qr.client_hoplimit = hoplimit;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::response_delay(int64_t delay)
+{
+    if (qr_hint(QueryResponseHintsMask::response_delay)) {
+        m_qr.response_delay = delay;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_name(const char* name, std::size_t size)
+{
+    if (qr_hint(QueryResponseHintsMask::query_name_index)) {
+        m_qr.query_name_index = m_block.add_name_rdata(name, size);
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_name_wire(const uint8_t* name, std::size_t max_size)
+{
+    if (!qr_hint(QueryResponseHintsMask::query_name_index))
+        return *this;
+
+    std::size_t size = wire_name_length(name, max_size);
+    if (size == 0)
+        throw std::runtime_error("Invalid NAME in DNS message");
+
+    return query_name(reinterpret_cast<const char*>(name), size);
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::query_size(std::size_t size)
+{
+    if (qr_hint(QueryResponseHintsMask::query_size)) {
+        m_qr.query_size = size;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::response_size(std::size_t size)
+{
+    if (qr_hint(QueryResponseHintsMask::response_size)) {
+        m_qr.response_size = size;
+        m_qr_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::bailiwick(const char* name, std::size_t size)
+{
+    if (qr_hint(QueryResponseHintsMask::response_processing_data)) {
+        m_rpd.bailiwick_index = m_block.add_name_rdata(name, size);
+        m_rpd_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::processing_flags(ResponseProcessingFlagsMask flags)
+{
+    if (qr_hint(QueryResponseHintsMask::response_processing_data)) {
+        m_rpd.processing_flags = flags;
+        m_rpd_filled = true;
+    }
+
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::add_record(QueryResponseSection section,
+                                                                   const char* name, std::size_t name_size,
+                                                                   const ClassType& classtype,
+                                                                   const boost::optional<uint32_t>& ttl,
+                                                                   const char* rdata, std::size_t rdata_size)
+{
+    if (!section_hint(section))
+        return *this;
+
+    std::vector<index_t>& list = m_sections[static_cast<uint8_t>(section)];
+
+    if (section == QueryResponseSection::QUERY_QUESTION || section == QueryResponseSection::RESPONSE_QUESTION) {
+        Question q;
+        q.name_index = m_block.add_name_rdata(name, name_size);
+        q.classtype_index = m_block.add_classtype(classtype);
+        list.push_back(m_block.add_question(q));
+    }
+    else {
+        const uint8_t& rr_hints = m_block.m_block_parameters.storage_parameters.storage_hints.rr_hints;
+        RR rr;
+        rr.name_index = m_block.add_name_rdata(name, name_size);
+        rr.classtype_index = m_block.add_classtype(classtype);
+        if ((rr_hints & RrHintsMask::ttl) && ttl)
+            rr.ttl = *ttl;
+        if ((rr_hints & RrHintsMask::rdata_index) && rdata)
+            rr.rdata_index = m_block.add_name_rdata(rdata, rdata_size);
+        list.push_back(m_block.add_rr(rr));
+    }
+
+    return *this;
+}
+
+bool CDNS::QueryResponseBuilder::query_wire(const uint8_t* msg, std::size_t size)
+{
+    DnsMessageParser parser(msg, size);
+    if (!parser.valid())
+        return false;
+
+    m_has_query = true;
+    transaction_id(parser.id());
+    query_opcode(parser.opcode());
+    query_rcode(parser.rcode());
+    add_dns_flags(header_to_dns_flags(parser.header_flags(), parser.edns_do()));
+    add_qr_sig_flags(QueryResponseFlagsMask::has_query
+                     | (parser.has_opt() ? QueryResponseFlagsMask::query_has_opt : 0)
+                     | (parser.count(DnsSection::QUESTION) == 0 ? QueryResponseFlagsMask::query_has_no_question : 0));
+    query_qdcount(parser.count(DnsSection::QUESTION));
+    query_ancount(parser.count(DnsSection::ANSWER));
+    query_nscount(parser.count(DnsSection::AUTHORITY));
+    query_arcount(parser.count(DnsSection::ADDITIONAL));
+
+    if (parser.has_opt()) {
+        query_edns_version(parser.edns_version());
+        query_udp_size(parser.udp_size());
+        query_opt_rdata(reinterpret_cast<const char*>(parser.opt_rdata()), parser.opt_rdata_size());
+    }
+
+    if (parser.has_trailing_data() && qr_sig_hint(QueryResponseSignatureHintsMask::qr_transport_flags)) {
+        m_qrs.qr_transport_flags = static_cast<QueryResponseTransportFlagsMask>(
+            m_qrs.qr_transport_flags.value_or(static_cast<QueryResponseTransportFlagsMask>(0))
+            | QueryResponseTransportFlagsMask::query_trailingdata);
+        m_qrs_filled = true;
+    }
+
+    query_size(size);
+
+    DnsRecord record;
+    bool first_question = true;
+    while (parser.next(record)) {
+        // First Question is stored directly in QueryResponse and its signature
+        if (record.section == DnsSection::QUESTION && first_question) {
+            ClassType ct;
+            ct.type = record.type;
+            ct.class_ = record.class_;
+            query_classtype(ct);
+            query_name(reinterpret_cast<const char*>(record.name), record.name_size);
+            first_question = false;
+            continue;
+        }
+
+        // OPT record is stored in Query/Response signature
+        if (record.section == DnsSection::ADDITIONAL && record.type == DnsMessageParser::OPT_TYPE)
+            continue;
+
+        ClassType ct;
+        ct.type = record.type;
+        ct.class_ = record.class_;
+        add_record(qr_section(record.section, false), reinterpret_cast<const char*>(record.name),
+                   record.name_size, ct, record.ttl, reinterpret_cast<const char*>(record.rdata),
+                   record.rdata_size);
+    }
+
+    return true;
+}
+
+bool CDNS::QueryResponseBuilder::response_wire(const uint8_t* msg, std::size_t size)
+{
+    DnsMessageParser parser(msg, size);
+    if (!parser.valid())
+        return false;
+
+    if (!m_has_query) {
+        transaction_id(parser.id());
+        query_opcode(parser.opcode());
+    }
+
+    response_rcode(parser.rcode());
+    add_dns_flags(header_to_dns_flags(parser.header_flags(), false) << 8);
+    add_qr_sig_flags(QueryResponseFlagsMask::has_response
+                     | (parser.has_opt() ? QueryResponseFlagsMask::response_has_opt : 0)
+                     | (parser.count(DnsSection::QUESTION) == 0 ? QueryResponseFlagsMask::response_has_no_question : 0));
+    response_size(size);
+
+    DnsRecord record;
+    bool first_question = true;
+    while (parser.next(record)) {
+        ClassType ct;
+        ct.type = record.type;
+        ct.class_ = record.class_;
+
+        // First Question is stored only if there's no query
+        if (record.section == DnsSection::QUESTION && first_question) {
+            if (!m_has_query) {
+                query_classtype(ct);
+                query_name(reinterpret_cast<const char*>(record.name), record.name_size);
+            }
+            first_question = false;
+            continue;
+        }
+
+        if (record.section == DnsSection::ADDITIONAL && record.type == DnsMessageParser::OPT_TYPE)
+            continue;
+
+        add_record(qr_section(record.section, true), reinterpret_cast<const char*>(record.name),
+                   record.name_size, ct, record.ttl, reinterpret_cast<const char*>(record.rdata),
+                   record.rdata_size);
+    }
+
+    return true;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::asn(const char* asn, std::size_t size)
+{
+    m_qr.asn = std::string(asn, size);
+    m_qr_filled = true;
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::country_code(const char* code, std::size_t size)
+{
+    m_qr.country_code = std::string(code, size);
+    m_qr_filled = true;
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::round_trip_time(int64_t rtt)
+{
+    m_qr.round_trip_time = rtt;
+    m_qr_filled = true;
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::user_id(const char* id, std::size_t size)
+{
+    m_qr.user_id = std::string(id, size);
+    m_qr_filled = true;
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::policy_action(PolicyActionValues action)
+{
+    m_qr.policy_action = action;
+    m_qr_filled = true;
+    return *this;
+}
+
+CDNS::QueryResponseBuilder& CDNS::QueryResponseBuilder::policy_rule(const char* rule, std::size_t size)
+{
+    m_qr.policy_rule = std::string(rule, size);
+    m_qr_filled = true;
+    return *this;
+}
+
+bool CDNS::QueryResponseBuilder::finish(const boost::optional<BlockStatistics>& stats)
+{
+    // Check if it'll be the first record in the block and set earliest time if yes
+    if (m_ts && ((m_block.m_query_responses.size() == 0 && m_block.m_malformed_messages.size() == 0) ||
+                 (*m_ts < m_block.m_block_preamble.earliest_time)))
+        m_block.m_block_preamble.earliest_time = *m_ts;
+
+    if (m_qrs_filled) {
+        m_qr.qr_signature_index = m_block.add_qr_signature(m_qrs);
+        m_qr_filled = true;
+    }
+
+    if (m_rpd_filled) {
+        m_qr.response_processing_data = m_rpd;
+        m_qr_filled = true;
+    }
+
+    // Question and RR lists are added to Block tables in the order of sections
+    QueryResponseExtended ext[2];
+    bool ext_filled[2] = {false, false};
+    for (std::size_t i = 0; i < SECTION_COUNT; i++) {
+        if (m_sections[i].empty())
+            continue;
+
+        QueryResponseExtended& e = ext[i / 4];
+        switch (static_cast<QueryResponseSection>(i % 4)) {
+            case QueryResponseSection::QUERY_QUESTION:
+                e.question_index = m_block.add_question_list(m_sections[i].data(), m_sections[i].size());
+                break;
+            case QueryResponseSection::QUERY_ANSWER:
+                e.answer_index = m_block.add_rr_list(m_sections[i].data(), m_sections[i].size());
+                break;
+            case QueryResponseSection::QUERY_AUTHORITY:
+                e.authority_index = m_block.add_rr_list(m_sections[i].data(), m_sections[i].size());
+                break;
+            default:
+                e.additional_index = m_block.add_rr_list(m_sections[i].data(), m_sections[i].size());
+                break;
+        }
+        ext_filled[i / 4] = true;
+    }
+
+    if (ext_filled[0]) {
+        m_qr.query_extended = ext[0];
+        m_qr_filled = true;
+    }
+
+    if (ext_filled[1]) {
+        m_qr.response_extended = ext[1];
+        m_qr_filled = true;
+    }
+
+    if (m_qr_filled)
+        m_block.m_query_responses.push_back(std::move(m_qr));
+
+    if (stats)
+        m_block.m_block_statistics = stats;
+
+    reset();
+
+    // Indicate if the Block is full (DNS record is inserted anyway, the limit is just a guideline)
+    return m_block.full();
+}
+
+void CDNS::QueryResponseBuilder::reset()
+{
+    m_ts = boost::none;
+    m_qr = QueryResponse();
+    m_qrs = QueryResponseSignature();
+    m_rpd = ResponseProcessingData();
+    m_qr_filled = false;
+    m_qrs_filled = false;
+    m_rpd_filled = false;
+    m_has_query = false;
+
+    for (auto& section : m_sections)
+        section.clear();
+}
+
+std::size_t CDNS::QueryResponseBuilder::wire_name_length(const uint8_t* name, std::size_t max_size)
+{
+    std::size_t pos = 0;
+
+    while (pos < max_size) {
+        uint8_t label = name[pos];
+
+        // Root label terminates the NAME
+        if (label == 0)
+            return pos + 1 <= 255 ? pos + 1 : 0;
+
+        // Compression pointers and extended label types aren't supported
+        if (label & 0xC0)
+            return 0;
+
+        pos += label + 1;
+    }
+
+    return 0;
+}
+
+void CDNS::QueryResponseBuilder::add_qr_sig_flags(uint8_t flags)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::qr_sig_flags)) {
+        m_qrs.qr_sig_flags = static_cast<QueryResponseFlagsMask>(
+            m_qrs.qr_sig_flags.value_or(static_cast<QueryResponseFlagsMask>(0)) | flags);
+        m_qrs_filled = true;
+    }
+}
+
+void CDNS::QueryResponseBuilder::add_dns_flags(uint16_t flags)
+{
+    if (qr_sig_hint(QueryResponseSignatureHintsMask::qr_dns_flags)) {
+        m_qrs.qr_dns_flags = static_cast<DNSFlagsMask>(
+            m_qrs.qr_dns_flags.value_or(static_cast<DNSFlagsMask>(0)) | flags);
+        m_qrs_filled = true;
+    }
+}
+
+bool CDNS::QueryResponseBuilder::section_hint(QueryResponseSection section) const
+{
+    switch (section) {
+        case QueryResponseSection::QUERY_QUESTION:
+        case QueryResponseSection::RESPONSE_QUESTION:
+            // Response questions are stored with the same hint as query questions
+            return qr_hint(QueryResponseHintsMask::query_question_sections);
+        case QueryResponseSection::QUERY_ANSWER:
+            return qr_hint(QueryResponseHintsMask::query_answer_sections);
+        case QueryResponseSection::QUERY_AUTHORITY:
+            return qr_hint(QueryResponseHintsMask::query_authority_sections);
+        case QueryResponseSection::QUERY_ADDITIONAL:
+            return qr_hint(QueryResponseHintsMask::query_additional_sections);
+        case QueryResponseSection::RESPONSE_ANSWER:
+            return qr_hint(QueryResponseHintsMask::response_answer_sections);
+        case QueryResponseSection::RESPONSE_AUTHORITY:
+            return qr_hint(QueryResponseHintsMask::response_authority_sections);
+        case QueryResponseSection::RESPONSE_ADDITIONAL:
+            return qr_hint(QueryResponseHintsMask::response_additional_sections);
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,381 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+#include <boost/optional.hpp>
+
+#include "format_specification.h"
+#include "timestamp.h"
+#include "block.h"
+#include "dns_parser.h"
+
+namespace CDNS {
+
+    /**
+     * @enum QueryResponseSection
+     * @brief Enumerates DNS message sections stored in Query/Response extended information
+     */
+    enum class QueryResponseSection : uint8_t {
+        QUERY_QUESTION = 0,
+        QUERY_ANSWER,
+        QUERY_AUTHORITY,
+        QUERY_ADDITIONAL,
+        RESPONSE_QUESTION,
+        RESPONSE_ANSWER,
+        RESPONSE_AUTHORITY,
+        RESPONSE_ADDITIONAL
+    };
+
+    /**
+     * @brief Builds one QueryResponse directly into Block tables of C-DNS Block
+     *
+     * Unlike GenericQueryResponse, the builder doesn't own any data. Byte strings are given as
+     * pointer and size (e.g. pointing into captured DNS message) and are copied only when they are
+     * inserted into Block table for the first time. Items not enabled by storage hints of the Block
+     * are ignored right away without touching Block tables.
+     *
+     * Block tables are filled in the order of the setter calls. QueryResponse is added to the Block
+     * by finish() and the builder is then ready for the next QueryResponse. The Block mustn't be
+     * cleared or exported while a QueryResponse is being built.
+     */
+    class QueryResponseBuilder {
+        public:
+        static constexpr std::size_t SECTION_COUNT = 8;
+
+        /**
+         * @brief Construct a new QueryResponseBuilder object
+         * @param block C-DNS Block to build QueryResponses into
+         */
+        explicit QueryResponseBuilder(CdnsBlock& block);
+
+        /**
+         * @brief Set timestamp of the DNS message
+         * @param ts Timestamp
+         */
+        QueryResponseBuilder& timestamp(const Timestamp& ts);
+
+        /**
+         * @brief Set client IP address
+         * @param address Start of the IP address byte string
+         * @param size Size of the IP address byte string
+         */
+        QueryResponseBuilder& client_address(const char* address, std::size_t size);
+
+        /**
+         * @brief Set client IPv4 address
+         * @param address IPv4 address in network byte order
+         */
+        QueryResponseBuilder& client_address(const in_addr& address) {
+            return client_address(reinterpret_cast<const char*>(&address), sizeof(address));
+        }
+
+        /**
+         * @brief Set client IPv6 address
+         * @param address IPv6 address in network byte order
+         */
+        QueryResponseBuilder& client_address(const in6_addr& address) {
+            return client_address(reinterpret_cast<const char*>(&address), sizeof(address));
+        }
+
+        /**
+         * @brief Set client transport port
+         */
+        QueryResponseBuilder& client_port(uint16_t port);
+
+        /**
+         * @brief Set DNS transaction ID
+         */
+        QueryResponseBuilder& transaction_id(uint16_t id);
+
+        /**
+         * @brief Set server IP address
+         * @param address Start of the IP address byte string
+         * @param size Size of the IP address byte string
+         */
+        QueryResponseBuilder& server_address(const char* address, std::size_t size);
+
+        /**
+         * @brief Set server IPv4 address
+         * @param address IPv4 address in network byte order
+         */
+        QueryResponseBuilder& server_address(const in_addr& address) {
+            return server_address(reinterpret_cast<const char*>(&address), sizeof(address));
+        }
+
+        /**
+         * @brief Set server IPv6 address
+         * @param address IPv6 address in network byte order
+         */
+        QueryResponseBuilder& server_address(const in6_addr& address) {
+            return server_address(reinterpret_cast<const char*>(&address), sizeof(address));
+        }
+
+        /**
+         * @brief Set server transport port
+         */
+        QueryResponseBuilder& server_port(uint16_t port);
+
+        /**
+         * @brief Set transport flags (IP version, transport protocol, trailing data)
+         */
+        QueryResponseBuilder& transport_flags(QueryResponseTransportFlagsMask flags);
+
+        /**
+         * @brief Set type of the Query/Response
+         */
+        QueryResponseBuilder& qr_type(QueryResponseTypeValues type);
+
+        /**
+         * @brief Set Query/Response signature flags
+         */
+        QueryResponseBuilder& qr_sig_flags(QueryResponseFlagsMask flags);
+
+        /**
+         * @brief Set query OPCODE
+         */
+        QueryResponseBuilder& query_opcode(uint8_t opcode);
+
+        /**
+         * @brief Set DNS header flags of query and response
+         */
+        QueryResponseBuilder& dns_flags(DNSFlagsMask flags);
+
+        /**
+         * @brief Set query RCODE
+         */
+        QueryResponseBuilder& query_rcode(uint16_t rcode);
+
+        /**
+         * @brief Set CLASS and TYPE of the first query Question
+         */
+        QueryResponseBuilder& query_classtype(const ClassType& classtype);
+
+        /**
+         * @brief Set query QDCOUNT
+         */
+        QueryResponseBuilder& query_qdcount(uint16_t count);
+
+        /**
+         * @brief Set query ANCOUNT
+         */
+        QueryResponseBuilder& query_ancount(uint16_t count);
+
+        /**
+         * @brief Set query NSCOUNT
+         */
+        QueryResponseBuilder& query_nscount(uint16_t count);
+
+        /**
+         * @brief Set query ARCOUNT
+         */
+        QueryResponseBuilder& query_arcount(uint16_t count);
+
+        /**
+         * @brief Set EDNS version of the query
+         */
+        QueryResponseBuilder& query_edns_version(uint8_t version);
+
+        /**
+         * @brief Set EDNS UDP payload size of the query
+         */
+        QueryResponseBuilder& query_udp_size(uint16_t size);
+
+        /**
+         * @brief Set RDATA of query OPT record
+         * @param rdata Start of the RDATA
+         * @param size Size of the RDATA
+         */
+        QueryResponseBuilder& query_opt_rdata(const char* rdata, std::size_t size);
+
+        /**
+         * @brief Set response RCODE
+         */
+        QueryResponseBuilder& response_rcode(uint16_t rcode);
+
+        /**
+         * @brief Set client hoplimit (TTL)
+         */
+        QueryResponseBuilder& client_hoplimit(uint8_t hoplimit);
+
+        /**
+         * @brief Set delay between query and response in ticks
+         */
+        QueryResponseBuilder& response_delay(int64_t delay);
+
+        /**
+         * @brief Set NAME of the first query Question
+         * @param name Start of the uncompressed NAME in wire format
+         * @param size Size of the NAME
+         */
+        QueryResponseBuilder& query_name(const char* name, std::size_t size);
+
+        /**
+         * @brief Set NAME of the first query Question directly from DNS message
+         * @param name Start of the NAME in DNS message
+         * @param max_size Number of bytes available from the start of the NAME to the end of DNS message
+         * @throw std::runtime_error if the NAME is malformed, compressed or exceeds available bytes
+         */
+        QueryResponseBuilder& query_name_wire(const uint8_t* name, std::size_t max_size);
+
+        /**
+         * @brief Set size of the query DNS message
+         */
+        QueryResponseBuilder& query_size(std::size_t size);
+
+        /**
+         * @brief Set size of the response DNS message
+         */
+        QueryResponseBuilder& response_size(std::size_t size);
+
+        /**
+         * @brief Set response bailiwick
+         * @param name Start of the bailiwick NAME in wire format
+         * @param size Size of the NAME
+         */
+        QueryResponseBuilder& bailiwick(const char* name, std::size_t size);
+
+        /**
+         * @brief Set response processing flags
+         */
+        QueryResponseBuilder& processing_flags(ResponseProcessingFlagsMask flags);
+
+        /**
+         * @brief Add Question or Resource record to a section of query or response
+         * @param section Section of the DNS message
+         * @param name Start of the record's NAME in wire format
+         * @param name_size Size of the NAME
+         * @param classtype CLASS and TYPE of the record
+         * @param ttl TTL of the record (ignored for Questions)
+         * @param rdata Start of the record's RDATA or `nullptr` if the RDATA isn't present (ignored for Questions)
+         * @param rdata_size Size of the RDATA
+         */
+        QueryResponseBuilder& add_record(QueryResponseSection section, const char* name,
+                                         std::size_t name_size, const ClassType& classtype,
+                                         const boost::optional<uint32_t>& ttl = boost::none,
+                                         const char* rdata = nullptr, std::size_t rdata_size = 0);
+
+        /**
+         * @brief Parse query DNS message in wire format and set all query items from it: transaction ID,
+         * OPCODE, DNS flags, RCODE, record counts, first Question, EDNS items, query size and query sections.
+         * Should be called before response_wire().
+         * @param msg Start of the query DNS message
+         * @param size Size of the query DNS message
+         * @return `false` if the message is malformed, nothing is set in that case
+         */
+        bool query_wire(const uint8_t* msg, std::size_t size);
+
+        /**
+         * @brief Parse response DNS message in wire format and set all response items from it: DNS flags,
+         * RCODE, response size and response sections. Transaction ID and first Question are taken from
+         * response only if query wasn't parsed by query_wire() before.
+         * @param msg Start of the response DNS message
+         * @param size Size of the response DNS message
+         * @return `false` if the message is malformed, nothing is set in that case
+         */
+        bool response_wire(const uint8_t* msg, std::size_t size);
+
+        /**
+         * @brief Set Autonomous system number of client IP address (implementation specific)
+         */
+        QueryResponseBuilder& asn(const char* asn, std::size_t size);
+
+        /**
+         * @brief Set country code of client IP address (implementation specific)
+         */
+        QueryResponseBuilder& country_code(const char* code, std::size_t size);
+
+        /**
+         * @brief Set estimated RTT of TCP connection in ticks (implementation specific)
+         */
+        QueryResponseBuilder& round_trip_time(int64_t rtt);
+
+        /**
+         * @brief Set unique user ID (implementation specific)
+         */
+        QueryResponseBuilder& user_id(const char* id, std::size_t size);
+
+        /**
+         * @brief Set policy applied on the query (implementation specific)
+         */
+        QueryResponseBuilder& policy_action(PolicyActionValues action);
+
+        /**
+         * @brief Set rule that triggered policy application on the query (implementation specific)
+         */
+        QueryResponseBuilder& policy_rule(const char* rule, std::size_t size);
+
+        /**
+         * @brief Add the built QueryResponse to the Block and reset the builder for the next one.
+         * QueryResponse without any filled item isn't added to the Block.
+         * @param stats Updated statistics of the Block
+         * @return `true` if the Block is full
+         */
+        bool finish(const boost::optional<BlockStatistics>& stats = boost::none);
+
+        /**
+         * @brief Drop the QueryResponse being built. Items already inserted into Block tables stay there.
+         */
+        void reset();
+
+        /**
+         * @brief Get size of uncompressed NAME in wire format
+         * @param name Start of the NAME
+         * @param max_size Number of bytes available from the start of the NAME
+         * @return Size of the NAME including the terminating root label or 0 if the NAME is malformed,
+         * compressed or exceeds available bytes
+         */
+        static std::size_t wire_name_length(const uint8_t* name, std::size_t max_size);
+
+        private:
+        /**
+         * @brief Check if given QueryResponse item is enabled by storage hints
+         */
+        bool qr_hint(QueryResponseHintsMask mask) const {
+            return m_block.m_block_parameters.storage_parameters.storage_hints.query_response_hints & mask;
+        }
+
+        /**
+         * @brief Check if given QueryResponseSignature item is enabled by storage hints
+         */
+        bool qr_sig_hint(QueryResponseSignatureHintsMask mask) const {
+            return qr_hint(QueryResponseHintsMask::qr_signature_index) &&
+                (m_block.m_block_parameters.storage_parameters.storage_hints.query_response_signature_hints & mask);
+        }
+
+        /**
+         * @brief Check if given section is enabled by storage hints
+         */
+        bool section_hint(QueryResponseSection section) const;
+
+        /**
+         * @brief Add flags to Query/Response signature flags
+         */
+        void add_qr_sig_flags(uint8_t flags);
+
+        /**
+         * @brief Add flags to DNS flags of Query/Response signature
+         */
+        void add_dns_flags(uint16_t flags);
+
+        CdnsBlock& m_block;
+        boost::optional<Timestamp> m_ts;
+        QueryResponse m_qr;
+        QueryResponseSignature m_qrs;
+        ResponseProcessingData m_rpd;
+        bool m_qr_filled;
+        bool m_qrs_filled;
+        bool m_rpd_filled;
+        bool m_has_query; //!< Query was parsed by query_wire()
+        std::vector<index_t> m_sections[SECTION_COUNT]; //!< Reused lists of Question and RR indexes
+    };
+}
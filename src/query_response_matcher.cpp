@@ -0,0 +1,290 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "query_response_matcher.h"
+#include "dns_parser.h"
+
+CDNS::QueryResponseMatcher::QueryResponseMatcher(const CollectionParameters& cp, uint64_t ticks_per_second,
+                                                 Callback callback)
+    : m_callback(std::move(callback)), m_ticks_per_second(ticks_per_second),
+      m_query_timeout_us((cp.query_timeout ? *cp.query_timeout : DEFAULT_QUERY_TIMEOUT) * 1000),
+      m_skew_timeout_us(cp.skew_timeout ? *cp.skew_timeout : DEFAULT_SKEW_TIMEOUT), m_entries(), m_free(),
+      m_queries(), m_responses(), m_wheel(WHEEL_SIZE), m_wheel_ms(), m_key(), m_incoming(), m_matched(0),
+      m_unmatched_queries(0), m_unmatched_responses(0)
+{
+    if (ticks_per_second == 0)
+        throw std::runtime_error("Ticks per second resolution is zero!");
+}
+
+void CDNS::QueryResponseMatcher::add(const WireQueryResponse& msg)
+{
+    if (!msg.ts || (!msg.query == !msg.response))
+        throw std::runtime_error("Matched DNS message needs timestamp and either query or response");
+
+    bool is_query = msg.query != nullptr;
+    const uint8_t* dns = is_query ? msg.query : msg.response;
+    std::size_t size = is_query ? msg.query_size : msg.response_size;
+    uint64_t now = to_us(*msg.ts);
+
+    advance(*msg.ts);
+
+    // Malformed messages can't be matched
+    if (!build_key(msg, dns, size)) {
+        m_callback(msg);
+        return;
+    }
+
+    PendingMap& counterparts = is_query ? m_responses : m_queries;
+    auto found = find_oldest(counterparts);
+    if (found == counterparts.end()) {
+        store(msg, is_query, now);
+        return;
+    }
+
+    uint32_t entry = found->second;
+    m_incoming.ts = *msg.ts;
+    m_incoming.client_ip.assign(msg.client_ip ? msg.client_ip : "", msg.client_ip ? msg.client_ip_size : 0);
+    m_incoming.server_ip.assign(msg.server_ip ? msg.server_ip : "", msg.server_ip ? msg.server_ip_size : 0);
+    m_incoming.client_port = msg.client_port;
+    m_incoming.server_port = msg.server_port;
+    m_incoming.qr_transport_flags = msg.qr_transport_flags;
+    m_incoming.qr_type = msg.qr_type;
+    m_incoming.client_hoplimit = msg.client_hoplimit;
+    m_incoming.message.assign(reinterpret_cast<const char*>(dns), size);
+
+    if (is_query)
+        emit_match(m_incoming, m_entries[entry]);
+    else
+        emit_match(m_entries[entry], m_incoming);
+
+    release(entry);
+    m_matched++;
+}
+
+void CDNS::QueryResponseMatcher::advance(const Timestamp& now)
+{
+    uint64_t now_us = to_us(now);
+    uint64_t now_ms = now_us / 1000;
+
+    if (!m_wheel_ms || now_ms < *m_wheel_ms)
+        m_wheel_ms = now_ms;
+
+    // Visit every slot between the last processed millisecond and now at most once
+    uint64_t steps = now_ms - *m_wheel_ms + 1;
+    if (steps > WHEEL_SIZE)
+        steps = WHEEL_SIZE;
+
+    for (uint64_t i = 0; i < steps; i++) {
+        std::vector<TimerRef>& slot = m_wheel[(*m_wheel_ms + i) % WHEEL_SIZE];
+        std::size_t kept = 0;
+
+        for (std::size_t j = 0; j < slot.size(); j++) {
+            TimerRef ref = slot[j];
+            PendingMessage& pending = m_entries[ref.entry];
+
+            // Message was matched in the meantime
+            if (!pending.active || pending.generation != ref.generation)
+                continue;
+
+            if (pending.deadline_us < now_us) {
+                emit_single(pending);
+                release(ref.entry);
+            }
+            else {
+                slot[kept++] = ref;
+            }
+        }
+
+        slot.resize(kept);
+    }
+
+    m_wheel_ms = now_ms;
+}
+
+void CDNS::QueryResponseMatcher::flush()
+{
+    std::vector<uint32_t> pending;
+    for (auto& item : m_queries)
+        pending.push_back(item.second);
+    for (auto& item : m_responses)
+        pending.push_back(item.second);
+
+    std::sort(pending.begin(), pending.end(), [this](uint32_t a, uint32_t b) {
+        return m_entries[a].time_us < m_entries[b].time_us;
+    });
+
+    for (auto entry : pending) {
+        emit_single(m_entries[entry]);
+        release(entry);
+    }
+
+    for (auto& slot : m_wheel)
+        slot.clear();
+}
+
+bool CDNS::QueryResponseMatcher::build_key(const WireQueryResponse& msg, const uint8_t* dns, std::size_t size)
+{
+    DnsMessageParser parser(dns, size);
+    if (!parser.valid())
+        return false;
+
+    m_key.clear();
+
+    // Lengths of variable parts make the key unambiguous
+    m_key.push_back(static_cast<char>(msg.client_ip ? msg.client_ip_size : 0));
+    if (msg.client_ip)
+        m_key.append(msg.client_ip, msg.client_ip_size);
+
+    m_key.push_back(static_cast<char>(msg.server_ip ? msg.server_ip_size : 0));
+    if (msg.server_ip)
+        m_key.append(msg.server_ip, msg.server_ip_size);
+
+    uint16_t fixed[3] = {
+        msg.client_port ? *msg.client_port : static_cast<uint16_t>(0),
+        msg.server_port ? *msg.server_port : static_cast<uint16_t>(0),
+        parser.id()
+    };
+    m_key.append(reinterpret_cast<const char*>(fixed), sizeof(fixed));
+
+    DnsRecord record;
+    if (parser.next(record) && record.section == DnsSection::QUESTION) {
+        uint16_t classtype[2] = {record.type, record.class_};
+        m_key.append(reinterpret_cast<const char*>(record.name), record.name_size);
+        m_key.append(reinterpret_cast<const char*>(classtype), sizeof(classtype));
+    }
+
+    return true;
+}
+
+CDNS::QueryResponseMatcher::PendingMap::iterator CDNS::QueryResponseMatcher::find_oldest(PendingMap& map)
+{
+    auto range = map.equal_range(boost::string_view(m_key.data(), m_key.size()));
+    auto oldest = map.end();
+
+    for (auto it = range.first; it != range.second; ++it) {
+        if (oldest == map.end() || m_entries[it->second].time_us < m_entries[oldest->second].time_us)
+            oldest = it;
+    }
+
+    return oldest;
+}
+
+void CDNS::QueryResponseMatcher::store(const WireQueryResponse& msg, bool is_query, uint64_t time_us)
+{
+    uint32_t entry;
+    if (!m_free.empty()) {
+        entry = m_free.back();
+        m_free.pop_back();
+    }
+    else {
+        m_entries.emplace_back();
+        entry = m_entries.size() - 1;
+    }
+
+    PendingMessage& pending = m_entries[entry];
+    const uint8_t* dns = is_query ? msg.query : msg.response;
+    std::size_t size = is_query ? msg.query_size : msg.response_size;
+
+    pending.active = true;
+    pending.is_query = is_query;
+    pending.time_us = time_us;
+    pending.deadline_us = time_us + (is_query ? m_query_timeout_us : m_skew_timeout_us);
+    pending.ts = *msg.ts;
+    pending.key.assign(m_key);
+    pending.client_ip.assign(msg.client_ip ? msg.client_ip : "", msg.client_ip ? msg.client_ip_size : 0);
+    pending.server_ip.assign(msg.server_ip ? msg.server_ip : "", msg.server_ip ? msg.server_ip_size : 0);
+    pending.message.assign(reinterpret_cast<const char*>(dns), size);
+    pending.client_port = msg.client_port;
+    pending.server_port = msg.server_port;
+    pending.qr_transport_flags = msg.qr_transport_flags;
+    pending.qr_type = msg.qr_type;
+    pending.client_hoplimit = msg.client_hoplimit;
+
+    PendingMap& map = is_query ? m_queries : m_responses;
+    map.emplace(boost::string_view(pending.key.data(), pending.key.size()), entry);
+    m_wheel[(pending.deadline_us / 1000) % WHEEL_SIZE].push_back({entry, pending.generation});
+}
+
+void CDNS::QueryResponseMatcher::release(uint32_t entry)
+{
+    PendingMessage& pending = m_entries[entry];
+    PendingMap& map = pending.is_query ? m_queries : m_responses;
+
+    auto range = map.equal_range(boost::string_view(pending.key.data(), pending.key.size()));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == entry) {
+            map.erase(it);
+            break;
+        }
+    }
+
+    pending.active = false;
+    pending.generation++;
+    m_free.push_back(entry);
+}
+
+void CDNS::QueryResponseMatcher::emit_match(const PendingMessage& query, const PendingMessage& response)
+{
+    WireQueryResponse wqr;
+    wqr.ts = query.ts;
+    wqr.client_ip = query.client_ip.empty() ? nullptr : query.client_ip.data();
+    wqr.client_ip_size = query.client_ip.size();
+    wqr.client_port = query.client_port;
+    wqr.server_ip = query.server_ip.empty() ? nullptr : query.server_ip.data();
+    wqr.server_ip_size = query.server_ip.size();
+    wqr.server_port = query.server_port;
+    wqr.qr_transport_flags = query.qr_transport_flags;
+    wqr.qr_type = query.qr_type;
+    wqr.client_hoplimit = query.client_hoplimit;
+
+    Timestamp response_ts = response.ts;
+    wqr.response_delay = response_ts.get_time_offset(query.ts, m_ticks_per_second);
+
+    wqr.query = reinterpret_cast<const uint8_t*>(query.message.data());
+    wqr.query_size = query.message.size();
+    wqr.response = reinterpret_cast<const uint8_t*>(response.message.data());
+    wqr.response_size = response.message.size();
+
+    m_callback(wqr);
+}
+
+void CDNS::QueryResponseMatcher::emit_single(const PendingMessage& msg)
+{
+    WireQueryResponse wqr;
+    wqr.ts = msg.ts;
+    wqr.client_ip = msg.client_ip.empty() ? nullptr : msg.client_ip.data();
+    wqr.client_ip_size = msg.client_ip.size();
+    wqr.client_port = msg.client_port;
+    wqr.server_ip = msg.server_ip.empty() ? nullptr : msg.server_ip.data();
+    wqr.server_ip_size = msg.server_ip.size();
+    wqr.server_port = msg.server_port;
+    wqr.qr_transport_flags = msg.qr_transport_flags;
+    wqr.qr_type = msg.qr_type;
+    wqr.client_hoplimit = msg.client_hoplimit;
+
+    if (msg.is_query) {
+        wqr.query = reinterpret_cast<const uint8_t*>(msg.message.data());
+        wqr.query_size = msg.message.size();
+        m_unmatched_queries++;
+    }
+    else {
+        wqr.response = reinterpret_cast<const uint8_t*>(msg.message.data());
+        wqr.response_size = msg.message.size();
+        m_unmatched_responses++;
+    }
+
+    m_callback(wqr);
+}
+
+uint64_t CDNS::QueryResponseMatcher::to_us(const Timestamp& ts) const
+{
+    return ts.m_secs * MICROS_PER_SEC + ts.m_ticks * MICROS_PER_SEC / m_ticks_per_second;
+}
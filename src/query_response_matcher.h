@@ -0,0 +1,202 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include "hash.h"
+#include "timestamp.h"
+#include "file_preamble.h"
+#include "interface.h"
+
+namespace CDNS {
+
+    /**
+     * @brief Matches independent query and response DNS messages into QueryResponse items
+     *
+     * Messages are matched by client and server address and port, transaction ID and the first
+     * Question's NAME, CLASS and TYPE. Semantics of timeouts follow Collection parameters:
+     * response has to arrive at most `query_timeout` milliseconds after the query, and response can
+     * be seen at most `skew_timeout` microseconds before its query.
+     *
+     * Time is driven by timestamps of the added messages (or explicitly by advance()). Pending
+     * messages are expired by a hashed timer wheel with millisecond slots, so adding a message has
+     * constant cost regardless of the number of pending messages. Matched pairs and expired unmatched
+     * messages are passed to the callback as WireQueryResponse, which can be buffered directly with
+     * CdnsExporter::buffer_wire_qr(). Pointers in the WireQueryResponse are valid only during the
+     * callback.
+     *
+     * The matcher isn't thread-safe; it's intended to be used as one instance per capture thread.
+     */
+    class QueryResponseMatcher {
+        public:
+        static constexpr uint64_t DEFAULT_QUERY_TIMEOUT = 5000; //!< Milliseconds
+        static constexpr uint64_t DEFAULT_SKEW_TIMEOUT = 10; //!< Microseconds
+        static constexpr std::size_t WHEEL_SIZE = 1024; //!< Number of millisecond slots in timer wheel
+
+        using Callback = std::function<void(const WireQueryResponse&)>;
+
+        /**
+         * @brief Construct a new QueryResponseMatcher object
+         * @param cp Collection parameters with `query_timeout` and `skew_timeout` (defaults are used if missing)
+         * @param ticks_per_second Subsecond resolution of message timestamps and of computed response delay
+         * @param callback Function called with every matched or expired DNS transaction
+         * @throw std::runtime_error if ticks_per_second is 0
+         */
+        QueryResponseMatcher(const CollectionParameters& cp, uint64_t ticks_per_second, Callback callback);
+
+        /**
+         * @brief Add query or response DNS message to the matcher
+         *
+         * The message is given as WireQueryResponse with either `query` or `response` set. Its
+         * timestamp is mandatory. Messages that can't be parsed are passed to the callback right away.
+         * @param msg DNS message with its transport metadata
+         * @throw std::runtime_error if the message doesn't have timestamp or has both or none of
+         * query and response set
+         */
+        void add(const WireQueryResponse& msg);
+
+        /**
+         * @brief Expire messages that can't be matched at the given time
+         * @param now Current time
+         */
+        void advance(const Timestamp& now);
+
+        /**
+         * @brief Pass all pending messages to the callback as unmatched
+         */
+        void flush();
+
+        /**
+         * @brief Get number of matched query/response pairs
+         */
+        uint64_t get_matched_count() const { return m_matched; }
+
+        /**
+         * @brief Get number of queries that expired without response
+         */
+        uint64_t get_unmatched_queries() const { return m_unmatched_queries; }
+
+        /**
+         * @brief Get number of responses that expired without query
+         */
+        uint64_t get_unmatched_responses() const { return m_unmatched_responses; }
+
+        /**
+         * @brief Get number of messages waiting for their counterpart
+         */
+        std::size_t get_pending_count() const { return m_queries.size() + m_responses.size(); }
+
+        private:
+        /**
+         * @brief Copy of one DNS message waiting for its counterpart.
+         * Entries are reused to keep their buffers allocated.
+         */
+        struct PendingMessage {
+            uint32_t generation = 0;
+            bool active = false;
+            bool is_query = false;
+            uint64_t time_us = 0;
+            uint64_t deadline_us = 0;
+            Timestamp ts;
+            std::string key;
+            std::string client_ip;
+            std::string server_ip;
+            std::string message;
+            boost::optional<uint16_t> client_port;
+            boost::optional<uint16_t> server_port;
+            boost::optional<QueryResponseTransportFlagsMask> qr_transport_flags;
+            boost::optional<QueryResponseTypeValues> qr_type;
+            boost::optional<uint8_t> client_hoplimit;
+        };
+
+        /**
+         * @brief Reference to pending message stored in timer wheel slot
+         */
+        struct TimerRef {
+            uint32_t entry;
+            uint32_t generation;
+        };
+
+        /**
+         * @brief Hash of the matching key
+         */
+        struct ViewHash {
+            std::size_t operator()(const boost::string_view& view) const {
+                return hash_value(view.data(), view.size());
+            }
+        };
+
+        using PendingMap = std::unordered_multimap<boost::string_view, uint32_t, ViewHash>;
+
+        /**
+         * @brief Build matching key of the DNS message into m_key
+         * @return `false` if the DNS message is malformed
+         */
+        bool build_key(const WireQueryResponse& msg, const uint8_t* dns, std::size_t size);
+
+        /**
+         * @brief Find the oldest pending message with key m_key in the given map
+         * @return Iterator to the found message or end of the map
+         */
+        PendingMap::iterator find_oldest(PendingMap& map);
+
+        /**
+         * @brief Store DNS message as pending and schedule its expiration
+         */
+        void store(const WireQueryResponse& msg, bool is_query, uint64_t time_us);
+
+        /**
+         * @brief Remove pending message from its map and return its entry for reuse
+         */
+        void release(uint32_t entry);
+
+        /**
+         * @brief Pass matched query and response to the callback
+         */
+        void emit_match(const PendingMessage& query, const PendingMessage& response);
+
+        /**
+         * @brief Pass unmatched message to the callback
+         */
+        void emit_single(const PendingMessage& msg);
+
+        /**
+         * @brief Convert Timestamp to microseconds
+         */
+        uint64_t to_us(const Timestamp& ts) const;
+
+        Callback m_callback;
+        uint64_t m_ticks_per_second;
+        uint64_t m_query_timeout_us;
+        uint64_t m_skew_timeout_us;
+
+        std::deque<PendingMessage> m_entries; //!< Pending messages, deque keeps keys in place
+        std::vector<uint32_t> m_free; //!< Unused entries
+        PendingMap m_queries;
+        PendingMap m_responses;
+
+        std::vector<std::vector<TimerRef>> m_wheel;
+        boost::optional<uint64_t> m_wheel_ms; //!< Last processed millisecond of timer wheel
+
+        std::string m_key; //!< Buffer for matching key
+        PendingMessage m_incoming; //!< Buffer for message matched on arrival
+
+        uint64_t m_matched;
+        uint64_t m_unmatched_queries;
+        uint64_t m_unmatched_responses;
+    };
+}
@@ -10,7 +10,7 @@
 
 #include "timestamp.h"
 
-int64_t CDNS::Timestamp::get_time_offset(const Timestamp& reference, uint64_t ticks_per_second)
+int64_t CDNS::Timestamp::get_time_offset(const Timestamp& reference, uint64_t ticks_per_second) const
 {
     if (ticks_per_second == 0)
         throw std::runtime_error("Ticks per second resolution is zero!");
@@ -74,7 +74,7 @@ namespace CDNS {
          * @throw std::runtime_error if ticks_per_second is 0 (prevents division by 0)
          * @return Difference between the two timestamps in ticks per second
          */
-        int64_t get_time_offset(const Timestamp& reference, uint64_t ticks_per_second);
+        int64_t get_time_offset(const Timestamp& reference, uint64_t ticks_per_second) const;
 
         /**
          * @brief Add given time offset to the Timestamp
@@ -0,0 +1,433 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "cdns.h"
+#include "traffic_generator.h"
+
+namespace {
+    const char* const syllables[] = {
+        "ka", "lo", "mi", "net", "ra", "so", "te", "vi", "zo", "bel", "cor", "dan", "fer", "gal", "hu",
+        "jin", "mar", "nor", "pol", "qui", "rid", "sun", "tor", "ul", "ven", "wis", "xa", "yor", "zen"
+    };
+
+    const char* const hosts[] = {"www", "api", "cdn", "mail", "static", "img", "login", "m", "app", "ns1"};
+
+    /**
+     * @brief Top level domains with their relative popularity
+     */
+    const std::pair<const char*, unsigned> tlds[] = {
+        {"com", 50}, {"net", 12}, {"org", 8}, {"cz", 10}, {"de", 6}, {"io", 4}, {"uk", 4}, {"arpa", 2},
+        {"eu", 2}, {"info", 2}
+    };
+
+    /**
+     * @brief Query types with their probability (A, AAAA, HTTPS, PTR, MX, TXT, NS, SRV, SOA, DS, DNSKEY)
+     */
+    const std::pair<uint16_t, double> qtypes[] = {
+        {1, 0.52}, {28, 0.24}, {65, 0.09}, {12, 0.05}, {15, 0.02}, {16, 0.02}, {2, 0.015}, {33, 0.015},
+        {6, 0.01}, {43, 0.005}, {48, 0.005}
+    };
+
+    const uint16_t CNAME = 5;
+    const uint16_t SOA = 6;
+
+    /**
+     * @brief Append label to domain name in DNS wire format
+     */
+    void append_label(std::string& name, const std::string& label) {
+        name.push_back(static_cast<char>(label.size()));
+        name += label;
+    }
+
+    /**
+     * @brief Get the zone (last two labels) of domain name in DNS wire format
+     */
+    std::string zone_of(const std::string& name) {
+        std::vector<std::size_t> labels;
+        for (std::size_t i = 0; i < name.size() && name[i] != 0; i += static_cast<uint8_t>(name[i]) + 1)
+            labels.push_back(i);
+
+        if (labels.size() <= 2)
+            return name;
+        return name.substr(labels[labels.size() - 2]);
+    }
+}
+
+CDNS::TrafficGenerator::TrafficGenerator(const TrafficGeneratorConfig& config)
+    : m_config(config), m_rng(config.seed), m_clients(), m_names(), m_servers(), m_client_cdf(), m_name_cdf(),
+      m_secs(config.start.m_secs), m_ticks(config.start.m_ticks), m_qr_count(0), m_aec_count(0), m_mm_count(0)
+{
+    if (config.clients == 0 || config.names == 0 || config.servers == 0)
+        throw std::invalid_argument("Traffic generator needs at least one client, name and server");
+
+    if (config.ticks_per_second == 0 || config.queries_per_second <= 0)
+        throw std::invalid_argument("Traffic generator needs positive ticks per second and query rate");
+
+    // Clients come from a limited number of networks, IPv6 clients usually share /64 prefix per network
+    m_clients.reserve(config.clients);
+    for (std::size_t i = 0; i < config.clients; i++) {
+        std::string ip;
+        uint32_t network = m_rng() % 256;
+        if (uniform() < config.ipv6_ratio) {
+            ip.assign("\x20\x01\x0d\xb8", 4);
+            ip.push_back(static_cast<char>(network));
+            ip.append(3, '\0');
+            for (unsigned j = 8; j < 16; j++)
+                ip.push_back(static_cast<char>(m_rng()));
+        }
+        else {
+            ip.push_back(static_cast<char>(network < 128 ? 10 : 100));
+            ip.push_back(static_cast<char>(network));
+            for (unsigned j = 2; j < 4; j++)
+                ip.push_back(static_cast<char>(m_rng()));
+        }
+        m_clients.push_back(ip);
+    }
+
+    unsigned tld_weights = 0;
+    for (auto& tld : tlds)
+        tld_weights += tld.second;
+
+    m_names.reserve(config.names);
+    for (std::size_t i = 0; i < config.names; i++) {
+        std::string domain;
+        unsigned length = 2 + m_rng() % 3;
+        for (unsigned j = 0; j < length; j++)
+            domain += syllables[m_rng() % (sizeof(syllables) / sizeof(syllables[0]))];
+
+        unsigned weight = m_rng() % tld_weights;
+        const char* tld = tlds[0].first;
+        for (auto& t : tlds) {
+            if (weight < t.second) {
+                tld = t.first;
+                break;
+            }
+            weight -= t.second;
+        }
+
+        std::string name;
+        double host = uniform();
+        if (host < 0.6)
+            append_label(name, hosts[m_rng() % (sizeof(hosts) / sizeof(hosts[0]))]);
+        else if (host < 0.7)
+            append_label(name, "h" + std::to_string(m_rng() % 100000));
+        append_label(name, domain);
+        append_label(name, tld);
+        name.push_back('\0');
+        m_names.push_back(name);
+    }
+
+    // First half of servers listen on IPv4, second half on IPv6
+    m_servers.reserve(config.servers * 2);
+    for (std::size_t i = 0; i < config.servers; i++)
+        m_servers.push_back(std::string("\xC0\x00\x02", 3) + static_cast<char>(i + 1));
+    for (std::size_t i = 0; i < config.servers; i++)
+        m_servers.push_back(std::string("\x20\x01\x0d\xb8\xff\xff", 6) + std::string(9, '\0') +
+            static_cast<char>(i + 1));
+
+    m_client_cdf = zipf_cdf(config.clients, config.client_skew);
+    m_name_cdf = zipf_cdf(config.names, config.name_skew);
+}
+
+std::vector<double> CDNS::TrafficGenerator::zipf_cdf(std::size_t size, double skew)
+{
+    std::vector<double> cdf(size);
+    double sum = 0.0;
+
+    for (std::size_t i = 0; i < size; i++) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+        cdf[i] = sum;
+    }
+
+    for (auto& value : cdf)
+        value /= sum;
+
+    return cdf;
+}
+
+std::size_t CDNS::TrafficGenerator::pick(const std::vector<double>& cdf)
+{
+    auto it = std::upper_bound(cdf.begin(), cdf.end(), uniform());
+    return std::min(static_cast<std::size_t>(it - cdf.begin()), cdf.size() - 1);
+}
+
+CDNS::GenericResourceRecord CDNS::TrafficGenerator::make_rr(const std::string& name, uint16_t type,
+                                                             uint32_t ttl, std::size_t seq)
+{
+    GenericResourceRecord rr;
+    ClassType classtype;
+    classtype.type = type;
+    classtype.class_ = 1;
+
+    rr.name = name;
+    rr.classtype = classtype;
+    rr.ttl = ttl;
+
+    // RDATA is derived from the name, so the same name gets the same answers
+    uint32_t base = static_cast<uint32_t>(hash_value(name.data(), name.size()) + seq);
+    std::string rdata;
+    switch (type) {
+        case 1:
+            rdata.assign("\xCB\x00", 2);
+            rdata.push_back(static_cast<char>(base >> 8));
+            rdata.push_back(static_cast<char>(base));
+            break;
+        case 28:
+            rdata.assign("\x20\x01\x0d\xb8\x00\x01", 6);
+            rdata.append(6, '\0');
+            for (unsigned i = 0; i < 4; i++)
+                rdata.push_back(static_cast<char>(base >> (8 * i)));
+            break;
+        case CNAME:
+            append_label(rdata, "edge" + std::to_string(base % 64));
+            rdata += zone_of(name);
+            break;
+        case SOA:
+            append_label(rdata, "ns1");
+            rdata += zone_of(name);
+            append_label(rdata, "hostmaster");
+            rdata += zone_of(name);
+            rdata.append(std::string("\x78\x5f\x3b\x01\x00\x00\x0e\x10\x00\x00\x03\x84\x00\x09\x3a\x80\x00\x00\x0e\x10", 20));
+            break;
+        default:
+            rdata.assign(8 + base % 56, static_cast<char>(base));
+            break;
+    }
+    rr.rdata = rdata;
+
+    return rr;
+}
+
+CDNS::GenericQueryResponse CDNS::TrafficGenerator::next_qr()
+{
+    GenericQueryResponse qr;
+
+    // Exponential interarrival times give Poisson arrival of queries
+    double gap = -std::log(1.0 - uniform()) / m_config.queries_per_second;
+    m_ticks += std::max<uint64_t>(1, static_cast<uint64_t>(gap * m_config.ticks_per_second));
+    m_secs += m_ticks / m_config.ticks_per_second;
+    m_ticks %= m_config.ticks_per_second;
+
+    const std::string& client = m_clients[pick(m_client_cdf)];
+    const std::string& name = m_names[pick(m_name_cdf)];
+    bool ipv6 = client.size() == 16;
+
+    double type = uniform();
+    uint16_t qtype = qtypes[0].first;
+    for (auto& t : qtypes) {
+        if (type < t.second) {
+            qtype = t.first;
+            break;
+        }
+        type -= t.second;
+    }
+
+    ClassType classtype;
+    classtype.type = qtype;
+    classtype.class_ = 1;
+
+    uint16_t server_port = 53;
+    uint8_t transport = QueryResponseTransportFlagsMask::udp;
+    double proto = uniform();
+    if (proto < m_config.encrypted_ratio) {
+        bool doh = proto < m_config.encrypted_ratio / 2;
+        transport = doh ? QueryResponseTransportFlagsMask::https : QueryResponseTransportFlagsMask::tls;
+        server_port = doh ? 443 : 853;
+    }
+    else if (proto < m_config.encrypted_ratio + m_config.tcp_ratio) {
+        transport = QueryResponseTransportFlagsMask::tcp;
+    }
+    if (ipv6)
+        transport |= QueryResponseTransportFlagsMask::ip_address;
+
+    bool edns = uniform() < 0.9;
+    bool answered = uniform() > 0.005;
+    uint8_t sig_flags = QueryResponseFlagsMask::has_query;
+    if (edns)
+        sig_flags |= QueryResponseFlagsMask::query_has_opt;
+    if (answered) {
+        sig_flags |= QueryResponseFlagsMask::has_response;
+        if (edns)
+            sig_flags |= QueryResponseFlagsMask::response_has_opt;
+    }
+
+    uint16_t dns_flags = DNSFlagsMask::query_rd;
+    if (answered)
+        dns_flags |= DNSFlagsMask::response_rd | DNSFlagsMask::response_ra;
+
+    qr.ts = Timestamp(m_secs, m_ticks);
+    qr.client_ip = client;
+    qr.client_port = static_cast<uint16_t>(1024 + m_rng() % 64512);
+    qr.transaction_id = static_cast<uint16_t>(m_rng());
+    qr.server_ip = m_servers[(ipv6 ? m_config.servers : 0) + m_rng() % m_config.servers];
+    qr.server_port = server_port;
+    qr.qr_transport_flags = static_cast<QueryResponseTransportFlagsMask>(transport);
+    qr.qr_type = QueryResponseTypeValues::stub;
+    qr.qr_sig_flags = static_cast<QueryResponseFlagsMask>(sig_flags);
+    qr.query_opcode = 0;
+    qr.qr_dns_flags = static_cast<DNSFlagsMask>(dns_flags);
+    qr.query_rcode = 0;
+    qr.query_classtype = classtype;
+    qr.query_qdcount = 1;
+    qr.query_ancount = 0;
+    qr.query_nscount = 0;
+    qr.query_arcount = edns ? 1 : 0;
+    if (edns) {
+        qr.query_edns_version = 0;
+        qr.query_udp_size = uniform() < 0.8 ? 1232 : 4096;
+    }
+    qr.client_hoplimit = static_cast<uint8_t>((ipv6 ? 64 : (uniform() < 0.7 ? 64 : 128)) - m_rng() % 16);
+    qr.query_name = name;
+    qr.query_size = 12 + name.size() + 4 + (edns ? 11 : 0);
+
+    if (!answered)
+        return qr;
+
+    // Most responses are answered from cache, the rest take time to resolve
+    bool cached = uniform() < 0.8;
+    double delay = cached ? 0.00002 + uniform() * 0.0005 : 0.005 + uniform() * 0.2;
+    qr.response_delay = static_cast<int64_t>(delay * m_config.ticks_per_second);
+    qr.processing_flags = static_cast<ResponseProcessingFlagsMask>(cached ? ResponseProcessingFlagsMask::from_cache : 0);
+
+    double rcode = uniform();
+    qr.response_rcode = rcode < 0.87 ? 0 : (rcode < 0.97 ? 3 : (rcode < 0.99 ? 2 : 5));
+
+    std::vector<GenericResourceRecord> answers;
+    std::vector<GenericResourceRecord> authority;
+    uint32_t ttl = cached ? 1 + m_rng() % 3600 : 3600;
+
+    if (*qr.response_rcode == 0 && uniform() < 0.9) {
+        std::string owner = name;
+        if (uniform() < 0.15) {
+            answers.push_back(make_rr(owner, CNAME, ttl, 0));
+            owner = *answers.back().rdata;
+        }
+
+        unsigned count = 1;
+        double more = uniform();
+        if (qtype == 1 || qtype == 28)
+            count += (more < 0.3) + (more < 0.1) + (more < 0.05);
+        else if (qtype == 2 || qtype == 15)
+            count += 1 + (more < 0.5);
+
+        for (unsigned i = 0; i < count; i++)
+            answers.push_back(make_rr(owner, qtype, ttl, i));
+    }
+    else if (*qr.response_rcode == 0 || *qr.response_rcode == 3) {
+        // NODATA and NXDOMAIN responses carry SOA of the zone in authority section
+        authority.push_back(make_rr(zone_of(name), SOA, 900, 0));
+    }
+
+    std::size_t response_size = *qr.query_size;
+    for (auto& rr : answers)
+        response_size += 2 + 10 + rr.rdata->size();
+    for (auto& rr : authority)
+        response_size += rr.name.size() + 10 + rr.rdata->size();
+
+    qr.response_size = response_size;
+    qr.response_answers = answers;
+    qr.response_authority = authority;
+
+    return qr;
+}
+
+CDNS::GenericAddressEventCount CDNS::TrafficGenerator::next_aec()
+{
+    GenericAddressEventCount aec;
+    const std::string& client = m_clients[pick(m_client_cdf)];
+    bool ipv6 = client.size() == 16;
+    double type = uniform();
+
+    if (type < 0.4) {
+        aec.ae_type = AddressEventTypeValues::tcp_reset;
+    }
+    else if (type < 0.7) {
+        aec.ae_type = ipv6 ? AddressEventTypeValues::icmpv6_dest_unreachable :
+            AddressEventTypeValues::icmp_dest_unreachable;
+        aec.ae_code = static_cast<uint8_t>(m_rng() % 4);
+    }
+    else if (type < 0.9) {
+        aec.ae_type = ipv6 ? AddressEventTypeValues::icmpv6_time_exceeded :
+            AddressEventTypeValues::icmp_time_exceeded;
+        aec.ae_code = 0;
+    }
+    else {
+        aec.ae_type = ipv6 ? AddressEventTypeValues::icmpv6_packet_too_big :
+            AddressEventTypeValues::icmp_dest_unreachable;
+        aec.ae_code = ipv6 ? 0 : 4;
+    }
+
+    uint8_t transport = aec.ae_type == AddressEventTypeValues::tcp_reset ?
+        QueryResponseTransportFlagsMask::tcp : QueryResponseTransportFlagsMask::udp;
+    if (ipv6)
+        transport |= QueryResponseTransportFlagsMask::ip_address;
+
+    aec.ae_transport_flags = static_cast<QueryResponseTransportFlagsMask>(transport);
+    aec.ip_address = client;
+    aec.ae_count = 1 + static_cast<uint64_t>(-std::log(1.0 - uniform()) * 3);
+
+    return aec;
+}
+
+CDNS::GenericMalformedMessage CDNS::TrafficGenerator::next_mm()
+{
+    GenericMalformedMessage mm;
+    const std::string& client = m_clients[pick(m_client_cdf)];
+    bool ipv6 = client.size() == 16;
+
+    mm.ts = Timestamp(m_secs, m_ticks);
+    mm.client_ip = client;
+    mm.client_port = static_cast<uint16_t>(1024 + m_rng() % 64512);
+    mm.server_ip = m_servers[(ipv6 ? m_config.servers : 0) + m_rng() % m_config.servers];
+    mm.server_port = 53;
+    mm.mm_transport_flags = static_cast<QueryResponseTransportFlagsMask>(ipv6 ?
+        QueryResponseTransportFlagsMask::ip_address : QueryResponseTransportFlagsMask::udp);
+
+    // Truncated or garbled DNS header followed by random bytes
+    std::string payload(4 + m_rng() % 60, '\0');
+    for (auto& byte : payload)
+        byte = static_cast<char>(m_rng());
+    mm.mm_payload = payload;
+
+    return mm;
+}
+
+std::vector<CDNS::GenericQueryResponse> CDNS::TrafficGenerator::generate_qrs(std::size_t count)
+{
+    std::vector<GenericQueryResponse> ret;
+    ret.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++)
+        ret.push_back(next_qr());
+
+    return ret;
+}
+
+std::size_t CDNS::TrafficGenerator::generate(CdnsExporter& exporter, uint64_t qr_count)
+{
+    std::size_t written = 0;
+
+    for (uint64_t i = 0; i < qr_count; i++) {
+        written += exporter.buffer_qr(next_qr());
+
+        m_qr_count++;
+
+        // Small epsilon keeps products like 20 * 0.05 from falling just below an integer
+        for ( ; m_aec_count < static_cast<uint64_t>(m_qr_count * m_config.aec_ratio + 1e-9); m_aec_count++)
+            written += exporter.buffer_aec(next_aec());
+
+        for ( ; m_mm_count < static_cast<uint64_t>(m_qr_count * m_config.mm_ratio + 1e-9); m_mm_count++)
+            written += exporter.buffer_mm(next_mm());
+    }
+
+    return written;
+}
@@ -0,0 +1,146 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+
+#include "interface.h"
+#include "timestamp.h"
+
+namespace CDNS {
+
+    class CdnsExporter;
+
+    /**
+     * @brief Parameters of synthetic DNS traffic generated by TrafficGenerator
+     */
+    struct TrafficGeneratorConfig {
+        TrafficGeneratorConfig() : seed(42), clients(20000), names(50000), servers(4), client_skew(0.9),
+                                   name_skew(1.0), ipv6_ratio(0.2), tcp_ratio(0.05), encrypted_ratio(0.02),
+                                   queries_per_second(10000), start(1700000000, 0),
+                                   ticks_per_second(1000000), aec_ratio(0.01), mm_ratio(0.001) {}
+
+        uint32_t seed; //!< Seed of the pseudorandom generator, same seed produces the same traffic on the same platform
+        std::size_t clients; //!< Number of distinct client addresses
+        std::size_t names; //!< Number of distinct query names
+        std::size_t servers; //!< Number of distinct server addresses
+        double client_skew; //!< Exponent of Zipfian distribution of client activity
+        double name_skew; //!< Exponent of Zipfian distribution of query name popularity
+        double ipv6_ratio; //!< Ratio of IPv6 clients
+        double tcp_ratio; //!< Ratio of queries over TCP
+        double encrypted_ratio; //!< Ratio of queries over DNS-over-TLS or DNS-over-HTTPS
+        double queries_per_second; //!< Average rate of queries (interarrival times are exponential)
+        Timestamp start; //!< Timestamp of the beginning of generated traffic
+        uint64_t ticks_per_second; //!< Sub-second resolution of generated timestamps
+        double aec_ratio; //!< Number of generated Address Event Counts per Query/Response
+        double mm_ratio; //!< Number of generated Malformed Messages per Query/Response
+    };
+
+    /**
+     * @brief Generates reproducible synthetic DNS traffic resembling traffic of a recursive resolver
+     *
+     * Query names and clients are picked with Zipfian distribution, so a few of them are very frequent
+     * and there's a long tail of rare ones. Query types, response codes, transports and resource records
+     * in the answer and authority sections follow the mix typically seen on a resolver. The generator
+     * uses its own conversions of pseudorandom numbers instead of standard library distributions, so
+     * the same seed produces the same traffic on the same platform and math library. Name and client
+     * popularity and query timing use std::pow() and std::log(), so their results can differ slightly
+     * between math library implementations.
+     */
+    class TrafficGenerator {
+        public:
+        /**
+         * @brief Construct a new TrafficGenerator object
+         * @param config Parameters of generated traffic
+         * @throw std::invalid_argument if the number of clients, names or servers is 0
+         */
+        explicit TrafficGenerator(const TrafficGeneratorConfig& config = TrafficGeneratorConfig());
+
+        /**
+         * @brief Get parameters of generated traffic
+         */
+        const TrafficGeneratorConfig& get_config() const {
+            return m_config;
+        }
+
+        /**
+         * @brief Generate next DNS transaction. Timestamps of subsequent transactions are increasing.
+         * @return Generated Query/Response
+         */
+        GenericQueryResponse next_qr();
+
+        /**
+         * @brief Generate next Address Event Count
+         * @return Generated Address Event Count
+         */
+        GenericAddressEventCount next_aec();
+
+        /**
+         * @brief Generate next Malformed Message. Uses current time of generated traffic.
+         * @return Generated Malformed Message
+         */
+        GenericMalformedMessage next_mm();
+
+        /**
+         * @brief Generate given number of DNS transactions
+         * @param count Number of DNS transactions to generate
+         * @return Generated Query/Responses
+         */
+        std::vector<GenericQueryResponse> generate_qrs(std::size_t count);
+
+        /**
+         * @brief Generate traffic into C-DNS exporter. Address Event Counts and Malformed Messages
+         * are interleaved with Query/Responses according to their ratios in the configuration. The last
+         * partially filled Block stays buffered in the exporter, call CdnsExporter::write_block() to write it.
+         * @param exporter C-DNS exporter to buffer generated items into
+         * @param qr_count Number of Query/Responses to generate
+         * @return Number of uncompressed bytes written to output by the exporter
+         */
+        std::size_t generate(CdnsExporter& exporter, uint64_t qr_count);
+
+        private:
+        /**
+         * @brief Cumulative distribution of Zipfian distribution over given number of items
+         */
+        static std::vector<double> zipf_cdf(std::size_t size, double skew);
+
+        /**
+         * @brief Uniformly distributed number from [0, 1)
+         */
+        double uniform() {
+            return (m_rng() >> 5) * (1.0 / 134217728.0);
+        }
+
+        /**
+         * @brief Pick index of an item according to cumulative distribution
+         */
+        std::size_t pick(const std::vector<double>& cdf);
+
+        /**
+         * @brief Create resource record for given query name and type
+         */
+        GenericResourceRecord make_rr(const std::string& name, uint16_t type, uint32_t ttl, std::size_t seq);
+
+        TrafficGeneratorConfig m_config;
+        std::mt19937 m_rng;
+        std::vector<std::string> m_clients;
+        std::vector<std::string> m_names;
+        std::vector<std::string> m_servers;
+        std::vector<double> m_client_cdf;
+        std::vector<double> m_name_cdf;
+        uint64_t m_secs;
+        uint64_t m_ticks;
+        uint64_t m_qr_count; //!< Number of Query/Responses generated by generate()
+        uint64_t m_aec_count; //!< Number of Address Event Counts generated by generate()
+        uint64_t m_mm_count; //!< Number of Malformed Messages generated by generate()
+    };
+}
@@ -117,3 +117,238 @@ lzma_ret CDNS::XzCborOutputWriter::write_lzma(std::size_t in_size, lzma_action a
 
     return ret;
 }
+
+CDNS::AsyncCborOutputWriter::AsyncCborOutputWriter(std::unique_ptr<BaseCborOutputWriter>&& writer,
+                                                   const OutputQueueParameters& params)
+    : m_writer(std::move(writer)), m_params(params), m_pending(), m_queue(), m_blocks(0), m_bytes(0),
+      m_dropped(0), m_dropped_total(0), m_dropped_blocks(0), m_output_time(0), m_blocked_time(0), m_error(), m_stop(false)
+{
+    m_thread = std::thread(&AsyncCborOutputWriter::run, this);
+}
+
+CDNS::AsyncCborOutputWriter::~AsyncCborOutputWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pending.empty())
+            push(Chunk{std::move(m_pending), 0, 0, false, false, boost::any()});
+        m_stop = true;
+        m_work_cv.notify_one();
+    }
+
+    m_thread.join();
+
+    try {
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+    catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+}
+
+void CDNS::AsyncCborOutputWriter::write(const char* p, std::size_t size)
+{
+    m_pending.append(p, size);
+}
+
+void CDNS::AsyncCborOutputWriter::rotate_output(const boost::any& value)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    check_error();
+
+    if (!m_pending.empty()) {
+        push(Chunk{std::move(m_pending), 0, 0, false, false, boost::any()});
+        m_pending.clear();
+    }
+
+    push(Chunk{std::string(), 0, 0, false, true, value});
+}
+
+bool CDNS::AsyncCborOutputWriter::commit(uint64_t items, bool droppable, uint64_t carried)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    check_error();
+
+    Chunk chunk{std::move(m_pending), items, carried, droppable, false, boost::any()};
+    m_pending.clear();
+
+    if (!droppable) {
+        push(std::move(chunk));
+        return true;
+    }
+
+    std::size_t size = chunk.data.size();
+    switch (m_params.policy) {
+        case OutputQueuePolicy::BLOCK:
+            if (!has_room(size)) {
+                auto start = std::chrono::steady_clock::now();
+                m_room_cv.wait(lock, [this, size]{ return has_room(size) || m_error; });
+                m_blocked_time += std::chrono::steady_clock::now() - start;
+            }
+            check_error();
+            break;
+
+        case OutputQueuePolicy::DROP_OLDEST:
+            // Drop the oldest Blocks that aren't being written yet
+            for (auto it = m_queue.begin(); it != m_queue.end() && !has_room(size);) {
+                if (!it->droppable) {
+                    ++it;
+                    continue;
+                }
+
+                m_blocks--;
+                m_bytes -= it->data.size();
+                drop(*it);
+                it = m_queue.erase(it);
+            }
+
+            // If the Block being written by worker thread still occupies the queue, drop the new one
+            // fall through
+
+        case OutputQueuePolicy::DROP_NEWEST:
+            if (!has_room(size)) {
+                drop(chunk);
+                return false;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    push(std::move(chunk));
+    return true;
+}
+
+uint64_t CDNS::AsyncCborOutputWriter::take_dropped_items()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t dropped = m_dropped;
+    m_dropped = 0;
+    return dropped;
+}
+
+uint64_t CDNS::AsyncCborOutputWriter::get_dropped_items_count()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped_total;
+}
+
+uint64_t CDNS::AsyncCborOutputWriter::get_dropped_blocks_count()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dropped_blocks;
+}
+
+std::size_t CDNS::AsyncCborOutputWriter::get_queued_blocks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_blocks;
+}
+
+std::size_t CDNS::AsyncCborOutputWriter::get_queued_bytes()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+std::chrono::nanoseconds CDNS::AsyncCborOutputWriter::get_output_time()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_output_time;
+}
+
+std::chrono::nanoseconds CDNS::AsyncCborOutputWriter::get_blocked_time()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_blocked_time;
+}
+
+bool CDNS::AsyncCborOutputWriter::has_room(std::size_t size) const
+{
+    // Always allow at least one Block in flight so that oversized Blocks don't get stuck
+    if (m_blocks == 0)
+        return true;
+
+    if (m_params.max_blocks != 0 && m_blocks >= m_params.max_blocks)
+        return false;
+
+    if (m_params.max_bytes != 0 && m_bytes + size > m_params.max_bytes)
+        return false;
+
+    return true;
+}
+
+void CDNS::AsyncCborOutputWriter::push(Chunk&& chunk)
+{
+    m_bytes += chunk.data.size();
+    if (chunk.droppable)
+        m_blocks++;
+
+    m_queue.push_back(std::move(chunk));
+    m_work_cv.notify_one();
+}
+
+void CDNS::AsyncCborOutputWriter::drop(const Chunk& chunk)
+{
+    m_dropped += chunk.items + chunk.carried;
+    m_dropped_total += chunk.items;
+    m_dropped_blocks++;
+}
+
+void CDNS::AsyncCborOutputWriter::check_error()
+{
+    if (m_error) {
+        std::exception_ptr error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void CDNS::AsyncCborOutputWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        m_work_cv.wait(lock, [this]{ return !m_queue.empty() || m_stop; });
+        if (m_queue.empty())
+            break;
+
+        Chunk chunk = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+
+        // Compress and write the chunk without holding the lock, in pieces small enough
+        // for stack buffers of compressing writers
+        std::exception_ptr error;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            if (chunk.rotate) {
+                m_writer->rotate_output(chunk.value);
+            }
+            else {
+                for (std::size_t offset = 0; offset < chunk.data.size(); offset += WRITE_SIZE) {
+                    std::size_t size = chunk.data.size() - offset;
+                    m_writer->write(chunk.data.data() + offset, size > WRITE_SIZE ? WRITE_SIZE : size);
+                }
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        m_output_time += elapsed;
+        m_bytes -= chunk.data.size();
+        if (chunk.droppable)
+            m_blocks--;
+
+        if (error && !m_error)
+            m_error = error;
+
+        m_room_cv.notify_all();
+    }
+}
@@ -17,6 +17,13 @@
 #include <boost/any.hpp>
 #include <memory>
 #include <type_traits>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -37,6 +44,29 @@ namespace CDNS {
         XZ
     };
 
+    /**
+     * @enum OutputQueuePolicy
+     * @brief Enumerates behaviors of asynchronous output queue when it's full
+     */
+    enum class OutputQueuePolicy : uint8_t {
+        BLOCK = 0, //!< Block the caller until there's room in the queue
+        DROP_NEWEST, //!< Drop the Block that is being inserted to the queue
+        DROP_OLDEST //!< Drop the oldest Blocks waiting in the queue to make room for the new one
+    };
+
+    /**
+     * @brief Limits and overflow policy of asynchronous output queue
+     */
+    struct OutputQueueParameters {
+        OutputQueueParameters() : max_blocks(DEFAULT_MAX_BLOCKS), max_bytes(0), policy(OutputQueuePolicy::BLOCK) {}
+
+        static constexpr std::size_t DEFAULT_MAX_BLOCKS = 4;
+
+        std::size_t max_blocks; //!< Maximum number of Blocks in flight (0 = unlimited)
+        std::size_t max_bytes; //!< Maximum number of uncompressed bytes in flight (0 = unlimited)
+        OutputQueuePolicy policy; //!< What to do with new Block if the queue is full
+    };
+
     /**
      * @brief Exception thrown if there's some issue with export of CBOR data to file
      */
@@ -70,6 +100,13 @@ namespace CDNS {
          */
         virtual void rotate_output(const boost::any& value) = 0;
 
+        /**
+         * @brief Get total number of bytes written to the final output (after compression)
+         * since construction of the writer
+         * @return Number of bytes written to output
+         */
+        virtual uint64_t get_output_bytes() const { return 0; }
+
         protected:
         /**
          * @brief Open the output with given identifier or check if its valid
@@ -126,12 +163,16 @@ namespace CDNS {
          * @throw CborOutputExtension if opening of the output file fails
          */
         Writer(const std::string& filename, const std::string extension = "")
-            : BaseCborOutputWriter(), m_value(filename), m_extension(extension), m_out() { open(); }
+            : BaseCborOutputWriter(), m_value(filename), m_extension(extension), m_out(), m_closing(),
+              m_output_bytes(0) { open(); }
 
         /**
          * @brief Destroy the Writer object and close the current output file
          */
-        ~Writer() override { close(); }
+        ~Writer() override {
+            close();
+            wait_closing();
+        }
 
         /** Delete copy and move constructors */
         Writer(Writer& copy) = delete;
@@ -145,10 +186,16 @@ namespace CDNS {
          */
         void write(const char* p, std::size_t size) override {
             m_out.write(p, size);
+            m_output_bytes += size;
         }
 
         /**
          * @brief Rotate the output file (currently opened output is closed)
+         *
+         * Flushing, closing and renaming of the current output file is done in a background thread
+         * so the caller isn't stalled by slow disk. The background thread is joined at the next rotation
+         * or when the Writer is destroyed. If the new output file has the same name as the current one,
+         * the caller waits for the current file to be renamed before the new one is opened.
          * @param value Name of the new output file
          * @throw CborOutputException if opening of the output file fails
          */
@@ -156,11 +203,25 @@ namespace CDNS {
             if (value.type() != typeid(std::string))
                 return;
 
-            close();
-            m_value = boost::any_cast<std::string>(value);
+            std::string name = boost::any_cast<std::string>(value);
+            bool same_name = name == m_value;
+            close_async();
+            m_value = name;
+
+            // Both files would share the same ".part" file and the new one would get renamed
+            if (same_name)
+                wait_closing();
+
             open();
         }
 
+        /**
+         * @brief Get total number of bytes written to all output files
+         */
+        uint64_t get_output_bytes() const override {
+            return m_output_bytes;
+        }
+
         protected:
         /**
          * @brief Open the output file with given name
@@ -176,13 +237,42 @@ namespace CDNS {
          * @brief Close the opened output file with given name
          */
         void close() override {
+            if (m_out.is_open())
+                close_file(m_out, m_value + m_extension);
+        }
+
+        /**
+         * @brief Close the opened output file with given name in a background thread
+         */
+        void close_async() {
+            wait_closing();
+            if (!m_out.is_open())
+                return;
+
+            m_closing = std::thread([](std::ofstream out, std::string name) { close_file(out, name); },
+                                    std::move(m_out), m_value + m_extension);
+            m_out = std::ofstream();
+        }
+
+        /**
+         * @brief Wait for background closing of previous output file to finish
+         */
+        void wait_closing() {
+            if (m_closing.joinable())
+                m_closing.join();
+        }
+
+        /**
+         * @brief Flush and close given output file and remove the ".part" suffix from its name
+         * @param out Output file stream
+         * @param name Final name of the output file
+         */
+        static void close_file(std::ofstream& out, const std::string& name) {
             try {
-                if (m_out.is_open()) {
-                    m_out.flush();
-                    m_out.close();
-                    if (std::rename((m_value + m_extension + ".part").c_str(), (m_value + m_extension).c_str()))
-                        std::cerr << "Couldn't rename the output file!" << std::endl;
-                }
+                out.flush();
+                out.close();
+                if (std::rename((name + ".part").c_str(), name.c_str()))
+                    std::cerr << "Couldn't rename the output file!" << std::endl;
             }
             catch (std::exception& e) {
                 std::cerr << e.what() << std::endl;
@@ -192,6 +282,8 @@ namespace CDNS {
         std::string m_value;
         std::string m_extension;
         std::ofstream m_out;
+        std::thread m_closing;
+        std::atomic<uint64_t> m_output_bytes; //!< Read from other threads if the output is asynchronous
     };
 
     /**
@@ -208,7 +300,7 @@ namespace CDNS {
          * @throw CborOutputException if the file descriptor isn't valid
          */
         Writer(const int& fd, const std::string extension = "")
-            : BaseCborOutputWriter(), m_value(fd) { open(); }
+            : BaseCborOutputWriter(), m_value(fd), m_output_bytes(0) { open(); }
 
         /**
          * @brief Destroy the Writer object and close the current output file descriptor
@@ -231,6 +323,7 @@ namespace CDNS {
                 throw CborOutputException("Given " + std::to_string(size) + " bytes to write, but "
                                         "only " + std::to_string(ret) + " bytes were written!");
             }
+            m_output_bytes += size;
         }
 
         /**
@@ -247,6 +340,13 @@ namespace CDNS {
             open();
         }
 
+        /**
+         * @brief Get total number of bytes written to all output file descriptors
+         */
+        uint64_t get_output_bytes() const override {
+            return m_output_bytes;
+        }
+
         protected:
         /**
          * @brief Check if the given file descriptor is valid
@@ -267,6 +367,45 @@ namespace CDNS {
         }
 
         int m_value;
+        std::atomic<uint64_t> m_output_bytes; //!< Read from other threads if the output is asynchronous
+    };
+
+    /**
+     * @brief Appends given data to a string in memory
+     *
+     * Used for encoding parts of C-DNS data in advance (e.g. pre-encoded Block table items).
+     */
+    class MemoryCborOutputWriter : public BaseCborOutputWriter {
+        public:
+        /**
+         * @brief Construct a new MemoryCborOutputWriter object
+         * @param output String to append the data to, has to outlive the writer
+         */
+        explicit MemoryCborOutputWriter(std::string& output) : BaseCborOutputWriter(), m_output(output) {}
+
+        /** Delete copy and move constructors */
+        MemoryCborOutputWriter(MemoryCborOutputWriter& copy) = delete;
+        MemoryCborOutputWriter(MemoryCborOutputWriter&& copy) = delete;
+
+        /**
+         * @brief Append data in buffer to the output string
+         * @param p Start of the buffer with data
+         * @param size Size of the data in bytes
+         */
+        void write(const char* p, std::size_t size) override {
+            m_output.append(p, size);
+        }
+
+        /**
+         * @brief Memory output can't be rotated
+         * @throw CborOutputException every time
+         */
+        void rotate_output(const boost::any&) override {
+            throw CborOutputException("Memory output can't be rotated!");
+        }
+
+        private:
+        std::string& m_output;
     };
 
     /**
@@ -308,6 +447,13 @@ namespace CDNS {
             m_writer->rotate_output(value);
         }
 
+        /**
+         * @brief Get total number of bytes written to the final output (after compression)
+         */
+        uint64_t get_output_bytes() const override {
+            return m_writer->get_output_bytes();
+        }
+
         private:
         std::unique_ptr<BaseCborOutputWriter> m_writer;
     };
@@ -357,6 +503,13 @@ namespace CDNS {
             open();
         }
 
+        /**
+         * @brief Get total number of bytes written to the final output (after compression)
+         */
+        uint64_t get_output_bytes() const override {
+            return m_writer->get_output_bytes();
+        }
+
         private:
         /**
          * @brief Open the output with given identifier or check if its valid
@@ -428,6 +581,13 @@ namespace CDNS {
             open();
         }
 
+        /**
+         * @brief Get total number of bytes written to the final output (after compression)
+         */
+        uint64_t get_output_bytes() const override {
+            return m_writer->get_output_bytes();
+        }
+
         private:
         /**
          * @brief Open the output with given identifier or check if its valid
@@ -453,4 +613,179 @@ namespace CDNS {
         std::unique_ptr<BaseCborOutputWriter> m_writer;
         lzma_stream m_lzma;
     };
+
+    /**
+     * @brief Moves compression and writing of data to output into separate thread
+     *
+     * Data given to write() are gathered until commit() is called. Committed data are then inserted
+     * into bounded queue and written to the wrapped output writer by a worker thread. Committed data
+     * can be marked as droppable (whole C-DNS Blocks) and then they can be discarded according to
+     * the queue's policy if the output can't keep up. Data that aren't droppable (file header, end break)
+     * are always written. Exceptions thrown by the wrapped writer are rethrown on the next call of commit()
+     * or rotate_output().
+     */
+    class AsyncCborOutputWriter : public BaseCborOutputWriter {
+        public:
+        /**
+         * @brief Construct a new AsyncCborOutputWriter object and start its worker thread
+         * @param writer Output writer that does the compression and writing to output
+         * @param params Limits and overflow policy of the queue
+         */
+        AsyncCborOutputWriter(std::unique_ptr<BaseCborOutputWriter>&& writer, const OutputQueueParameters& params);
+
+        /**
+         * @brief Destroy the AsyncCborOutputWriter object. Writes all queued data to output
+         * and stops the worker thread.
+         */
+        ~AsyncCborOutputWriter() override;
+
+        /** Delete copy and move constructors */
+        AsyncCborOutputWriter(AsyncCborOutputWriter& copy) = delete;
+        AsyncCborOutputWriter(AsyncCborOutputWriter&& copy) = delete;
+
+        /**
+         * @brief Append data in buffer to currently pending (not committed) data
+         * @param p Start of the buffer with data
+         * @param size Size of the data in bytes
+         */
+        void write(const char* p, std::size_t size) override;
+
+        /**
+         * @brief Commit pending data and queue output rotation after them
+         * @param value Name or other identifier of the new output
+         * @throw std::exception if previous write in worker thread failed
+         */
+        void rotate_output(const boost::any& value) override;
+
+        /**
+         * @brief Get total number of bytes written to the final output by worker thread (after compression)
+         */
+        uint64_t get_output_bytes() const override {
+            return m_writer->get_output_bytes();
+        }
+
+        /**
+         * @brief Insert pending data to the output queue
+         * @param items Number of items (records, events...) contained in the pending data
+         * @param droppable If `true` pending data can be dropped according to queue's policy
+         * @param carried Number of previously dropped items recorded in the pending data. If the pending
+         * data get dropped, these items need to be recorded again in the next data.
+         * @throw std::exception if previous write in worker thread failed
+         * @return `false` if pending data were dropped, `true` otherwise
+         */
+        bool commit(uint64_t items, bool droppable, uint64_t carried = 0);
+
+        /**
+         * @brief Get number of dropped items since the last call of this method
+         * @return Number of dropped items
+         */
+        uint64_t take_dropped_items();
+
+        /**
+         * @brief Get total number of items dropped since construction of the writer
+         * @return Total number of dropped items
+         */
+        uint64_t get_dropped_items_count();
+
+        /**
+         * @brief Get total number of droppable chunks (C-DNS Blocks) dropped since construction
+         * of the writer, including chunks dropped from the queue to make room for newer ones
+         * @return Total number of dropped Blocks
+         */
+        uint64_t get_dropped_blocks_count();
+
+        /**
+         * @brief Get limits and overflow policy of the queue
+         */
+        const OutputQueueParameters& get_parameters() const {
+            return m_params;
+        }
+
+        /**
+         * @brief Get number of droppable chunks (C-DNS Blocks) currently in flight
+         * @return Number of Blocks in flight
+         */
+        std::size_t get_queued_blocks();
+
+        /**
+         * @brief Get number of uncompressed bytes currently in flight
+         * @return Number of bytes in flight
+         */
+        std::size_t get_queued_bytes();
+
+        /**
+         * @brief Get total time the worker thread spent compressing and writing data to output
+         * @return Total output time
+         */
+        std::chrono::nanoseconds get_output_time();
+
+        /**
+         * @brief Get total time commit() spent waiting for room in the full queue
+         * @return Total blocked time
+         */
+        std::chrono::nanoseconds get_blocked_time();
+
+        private:
+        /**
+         * @brief Committed data or output rotation waiting in the queue
+         */
+        struct Chunk {
+            std::string data;
+            uint64_t items;
+            uint64_t carried;
+            bool droppable;
+            bool rotate;
+            boost::any value;
+        };
+
+        /**
+         * @brief Check if the queue has room for new droppable chunk of given size
+         * @param size Size of the new chunk in bytes
+         */
+        bool has_room(std::size_t size) const;
+
+        /**
+         * @brief Insert chunk to the queue and wake up worker thread. Caller must hold m_mutex.
+         * @param chunk Chunk to insert
+         */
+        void push(Chunk&& chunk);
+
+        /**
+         * @brief Count dropped chunk and its items. Caller must hold m_mutex.
+         * @param chunk Dropped chunk
+         */
+        void drop(const Chunk& chunk);
+
+        /**
+         * @brief Rethrow exception thrown in worker thread. Caller must hold m_mutex.
+         */
+        void check_error();
+
+        /**
+         * @brief Main loop of the worker thread
+         */
+        void run();
+
+        static constexpr std::size_t WRITE_SIZE = 16384;
+
+        std::unique_ptr<BaseCborOutputWriter> m_writer;
+        OutputQueueParameters m_params;
+        std::string m_pending;
+
+        std::deque<Chunk> m_queue;
+        std::size_t m_blocks; //!< Droppable chunks queued or being written
+        std::size_t m_bytes; //!< Bytes queued or being written
+        uint64_t m_dropped; //!< Dropped items not yet recorded in any committed data
+        uint64_t m_dropped_total;
+        uint64_t m_dropped_blocks;
+        std::chrono::nanoseconds m_output_time; //!< Time spent by worker thread in the wrapped writer
+        std::chrono::nanoseconds m_blocked_time; //!< Time spent by callers waiting for room in the queue
+        std::exception_ptr m_error;
+        bool m_stop;
+
+        std::mutex m_mutex;
+        std::condition_variable m_work_cv;
+        std::condition_variable m_room_cv;
+        std::thread m_thread;
+    };
 }
@@ -0,0 +1,99 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <memory>
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+#include "../src/anonymizer.h"
+#include "../src/block.h"
+
+namespace CDNS {
+    static const uint8_t cryptopan_key[] = {21, 34, 23, 141, 51, 164, 207, 128, 19, 10, 91, 22, 73, 144, 125, 16,
+                                            216, 152, 143, 131, 121, 121, 101, 39, 98, 87, 76, 45, 42, 132, 34, 2};
+
+    TEST(IpAnonymizerTest, IACTest) {
+        IpAnonymizer anon;
+        EXPECT_EQ(anon.get_method(), IpAnonymizationMethod::PREFIX_MASK);
+        EXPECT_THROW(IpAnonymizer("short key"), std::runtime_error);
+
+        in_addr ip;
+        inet_pton(AF_INET, "192.168.1.1", &ip);
+        anon.anonymize(reinterpret_cast<uint8_t*>(&ip), sizeof(ip));
+        EXPECT_EQ(ntohl(ip.s_addr), 0xC0A80101);
+    }
+
+    TEST(IpAnonymizerTest, IACryptoPAnTest) {
+        IpAnonymizer anon(std::string(reinterpret_cast<const char*>(cryptopan_key), sizeof(cryptopan_key)));
+        EXPECT_EQ(anon.get_method(), IpAnonymizationMethod::CRYPTOPAN);
+
+        // Test vectors from the reference Crypto-PAn implementation
+        std::vector<std::pair<std::string, std::string>> vectors = {
+            {"128.11.68.132", "135.242.180.132"},
+            {"129.118.74.4", "134.136.186.123"},
+            {"130.132.252.244", "133.68.164.234"},
+            {"141.223.7.43", "141.167.8.160"},
+            {"141.233.145.108", "141.129.237.235"}
+        };
+
+        for (auto& vector : vectors) {
+            in_addr ip, expected;
+            inet_pton(AF_INET, vector.first.c_str(), &ip);
+            inet_pton(AF_INET, vector.second.c_str(), &expected);
+            anon.anonymize(reinterpret_cast<uint8_t*>(&ip), sizeof(ip));
+            EXPECT_EQ(ip.s_addr, expected.s_addr);
+        }
+
+        // Prefix preservation for IPv6
+        in6_addr ip6, ip6_2;
+        inet_pton(AF_INET6, "2001:db8:1:2::1", &ip6);
+        inet_pton(AF_INET6, "2001:db8:1:3::1", &ip6_2);
+        anon.anonymize(ip6.s6_addr, sizeof(ip6));
+        anon.anonymize(ip6_2.s6_addr, sizeof(ip6_2));
+        EXPECT_EQ(std::memcmp(ip6.s6_addr, ip6_2.s6_addr, 7), 0);
+        EXPECT_NE(std::memcmp(ip6.s6_addr, ip6_2.s6_addr, 16), 0);
+    }
+
+    TEST(IpAnonymizerTest, IABlockTest) {
+        BlockParameters bp;
+        bp.storage_parameters.client_address_prefix_ipv4 = 24;
+        CdnsBlock block(bp, 0);
+        std::string ip("\xC0\xA8\x01\x01", 4);
+        std::string ip2("\xC0\xA8\x01\x02", 4);
+
+        // Without anonymizer addresses given as strings are stored verbatim
+        GenericAddressEventCount aec;
+        aec.ip_address = ip;
+        block.add_address_event_count(aec);
+        EXPECT_EQ(block.get_ip_address(0), ip);
+
+        block.clear();
+        block.set_anonymizer(std::make_shared<IpAnonymizer>());
+        GenericQueryResponse gqr;
+        gqr.client_ip = ip;
+        gqr.server_ip = ip2;
+        block.add_question_response_record(gqr);
+        gqr.client_ip = ip2;
+        block.add_question_response_record(gqr);
+
+        EXPECT_EQ(block.m_ip_address.size(), 2);
+        EXPECT_EQ(block.get_ip_address(0), std::string("\xC0\xA8\x01", 3));
+        EXPECT_EQ(block.get_ip_address(1), ip2);
+
+        block.clear();
+        block.set_anonymizer(std::make_shared<IpAnonymizer>(
+            std::string(reinterpret_cast<const char*>(cryptopan_key), sizeof(cryptopan_key))));
+        in_addr raw;
+        inet_pton(AF_INET, "128.11.68.132", &raw);
+        index_t index = block.add_ip_address(raw);
+        EXPECT_EQ(block.add_ip_address(raw), index);
+        EXPECT_EQ(block.get_ip_address(index), std::string("\x87\xF2\xB4", 3)); // 135.242.180.0/24
+    }
+}
@@ -0,0 +1,282 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+
+#include "../src/cdns.h"
+#include "common.h"
+
+namespace CDNS {
+
+    TEST(BlockSummaryTest, BSBloomFilterTest) {
+        BloomFilter empty;
+        EXPECT_FALSE(empty.may_contain("value"));
+
+        BloomFilter bf(1000, 10);
+        EXPECT_GE(bf.size(), 10000);
+        for (int i = 0; i < 1000; i++)
+            bf.add("value" + std::to_string(i));
+
+        int false_positives = 0;
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_TRUE(bf.may_contain("value" + std::to_string(i)));
+            false_positives += bf.may_contain("other" + std::to_string(i));
+        }
+        EXPECT_LT(false_positives, 50);
+
+        // Serialized filter gives the same results
+        std::string buffer;
+        {
+            CdnsEncoder enc(buffer);
+            bf.write(enc);
+        }
+        std::istringstream input(buffer);
+        CdnsDecoder dec(input);
+        BloomFilter read;
+        read.read(dec);
+        EXPECT_EQ(read.size(), bf.size());
+        for (int i = 0; i < 1000; i++) {
+            EXPECT_TRUE(read.may_contain("value" + std::to_string(i)));
+            EXPECT_EQ(read.may_contain("other" + std::to_string(i)), bf.may_contain("other" + std::to_string(i)));
+        }
+    }
+
+    TEST(BlockSummaryTest, BSBlockSummaryTest) {
+        FilePreamble fp;
+        CdnsBlock block(fp.get_block_parameters(0), 0);
+
+        GenericQueryResponse gqr;
+        std::string ip = std::string("\x01\x02\x03\x04", 4);
+        std::string name = std::string("\x03www\x02nic\x02" "cz\x00", 12);
+        uint16_t qtype = 28;
+        uint16_t rcode = 3;
+        gqr.ts = Timestamp(100, 500);
+        gqr.client_ip = ip;
+        gqr.query_name = name;
+        ClassType ct;
+        ct.type = qtype;
+        ct.class_ = 1;
+        gqr.query_classtype = ct;
+        gqr.response_rcode = rcode;
+        block.add_question_response_record(gqr);
+        gqr.ts = Timestamp(102, 0);
+        block.add_question_response_record(gqr);
+
+        BlockSummary summary(block, 5);
+        EXPECT_EQ(summary.block_index, 5);
+        EXPECT_EQ(summary.qr_count, 2);
+        EXPECT_EQ(summary.mm_count, 0);
+        ASSERT_TRUE(summary.min_time && summary.max_time);
+        EXPECT_EQ(summary.min_time->m_secs, 100);
+        EXPECT_EQ(summary.max_time->m_secs, 102);
+        EXPECT_EQ(summary.rcodes[rcode], 2);
+        EXPECT_EQ(summary.qtypes[qtype], 2);
+
+        ItemFilter filter;
+        EXPECT_TRUE(summary.may_match(filter));
+        filter.query_name = name;
+        filter.client_ip = ip;
+        EXPECT_TRUE(summary.may_match(filter));
+        filter.time_range = TimeRange(Timestamp(102, 0), Timestamp(103, 0));
+        EXPECT_TRUE(summary.may_match(filter));
+        filter.time_range = TimeRange(Timestamp(0, 0), Timestamp(100, 500));
+        EXPECT_FALSE(summary.may_match(filter));
+        filter.time_range = boost::none;
+        filter.client_ip = std::string("\x01\x02\x03\x05", 4);
+        EXPECT_FALSE(summary.may_match(filter));
+
+        // Round trip through Block summary file
+        {
+            BlockSummaryWriter writer(file);
+            writer.write(summary);
+            writer.write(summary);
+        }
+        std::ifstream ifs(file, std::ifstream::binary);
+        BlockSummaryReader reader(ifs);
+        std::vector<BlockSummary> summaries = reader.read_summaries();
+        ASSERT_EQ(summaries.size(), 2);
+        EXPECT_EQ(summaries[1].block_index, 5);
+        EXPECT_EQ(summaries[1].earliest_time.m_secs, 100);
+        EXPECT_EQ(summaries[1].min_time->m_ticks, 500);
+        EXPECT_EQ(summaries[1].max_time->m_secs, 102);
+        EXPECT_EQ(summaries[1].rcodes, summary.rcodes);
+        EXPECT_EQ(summaries[1].qtypes, summary.qtypes);
+        filter.client_ip = ip;
+        EXPECT_TRUE(summaries[1].may_match(filter));
+
+        // Time offsets relative to Block's earliest time are rejected
+        block.m_query_responses[1].time_offset = Timestamp(2, 0);
+        EXPECT_THROW(BlockSummary(block, 5), std::invalid_argument);
+
+        remove_file(file);
+    }
+
+    TEST(BlockSummaryTest, BSExporterSummariesTest) {
+        TrafficGeneratorConfig config;
+        config.mm_ratio = 0.1;
+        config.names = 5000;
+        TrafficGenerator generator(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 500;
+        std::string summary_file = file + ".summary";
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            exporter.set_block_summaries(".summary");
+            generator.generate(exporter, 5000);
+            exporter.write_block();
+        }
+
+        std::vector<BlockSummary> summaries;
+        {
+            std::ifstream ifs(summary_file, std::ifstream::binary);
+            BlockSummaryReader reader(ifs);
+            summaries = reader.read_summaries();
+        }
+        ASSERT_GT(summaries.size(), 5);
+
+        // Items of the whole file with summaries of their Blocks
+        std::vector<GenericQueryResponse> qrs;
+        uint64_t blocks = 0;
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            CdnsBlockRead block;
+            bool eof = false;
+            while (true) {
+                reader.read_block(block, eof);
+                if (eof)
+                    break;
+
+                ASSERT_LT(blocks, summaries.size());
+                EXPECT_EQ(summaries[blocks].block_index, blocks);
+                EXPECT_EQ(summaries[blocks].qr_count, block.get_qr_count());
+                EXPECT_EQ(summaries[blocks].mm_count, block.get_mm_count());
+
+                // Summary of read Block equals summary of the Block written by exporter
+                BlockSummary read_summary(block, blocks);
+                EXPECT_EQ(read_summary.earliest_time.m_secs, summaries[blocks].earliest_time.m_secs);
+                EXPECT_EQ(read_summary.earliest_time.m_ticks, summaries[blocks].earliest_time.m_ticks);
+                ASSERT_TRUE(read_summary.min_time && summaries[blocks].min_time);
+                EXPECT_EQ(read_summary.min_time->m_secs, summaries[blocks].min_time->m_secs);
+                EXPECT_EQ(read_summary.min_time->m_ticks, summaries[blocks].min_time->m_ticks);
+                EXPECT_EQ(read_summary.max_time->m_secs, summaries[blocks].max_time->m_secs);
+                EXPECT_EQ(read_summary.max_time->m_ticks, summaries[blocks].max_time->m_ticks);
+                EXPECT_EQ(read_summary.rcodes, summaries[blocks].rcodes);
+                EXPECT_EQ(read_summary.qtypes, summaries[blocks].qtypes);
+
+                bool end = false;
+                while (true) {
+                    GenericQueryResponse gqr = block.read_generic_qr(end);
+                    if (end)
+                        break;
+
+                    ItemFilter filter;
+                    filter.query_name = *gqr.query_name;
+                    filter.client_ip = *gqr.client_ip;
+                    filter.time_range = TimeRange(*gqr.ts, Timestamp(gqr.ts->m_secs + 1, 0));
+                    EXPECT_TRUE(summaries[blocks].may_match(filter));
+                    qrs.push_back(gqr);
+                }
+                blocks++;
+            }
+        }
+        EXPECT_EQ(blocks, summaries.size());
+
+        // Blocks not containing the query name are skipped by their summaries
+        std::string name = *qrs.back().query_name;
+        uint64_t expected = 0;
+        for (auto& gqr : qrs)
+            expected += *gqr.query_name == name;
+
+        std::ifstream ifs(file, std::ifstream::binary);
+        CdnsReader reader(ifs);
+        reader.set_query_name_filter(name);
+        reader.set_block_summaries(summaries);
+        CdnsBlockRead block;
+        bool eof = false;
+        uint64_t found = 0;
+        while (true) {
+            reader.read_block(block, eof);
+            if (eof)
+                break;
+
+            bool end = false;
+            while (true) {
+                GenericQueryResponse gqr = block.read_generic_qr(end);
+                if (end)
+                    break;
+                EXPECT_EQ(*gqr.query_name, name);
+                found++;
+            }
+        }
+        EXPECT_EQ(found, expected);
+        EXPECT_GT(reader.get_blocks_skipped_count(), 0);
+
+        remove_file(file);
+        remove_file(summary_file);
+    }
+
+    TEST(BlockSummaryTest, BSExporterDropPolicyTest) {
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 10;
+        std::string summary_file = file + ".summary";
+        OutputQueueParameters qp;
+        qp.max_blocks = 1;
+
+        // Already summarized Blocks can be dropped from the queue later
+        qp.policy = OutputQueuePolicy::DROP_OLDEST;
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION, qp);
+            EXPECT_THROW(exporter.set_block_summaries(".summary"), CdnsEncoderException);
+            EXPECT_NO_THROW(exporter.set_block_summaries(""));
+        }
+        remove_file(file);
+
+        // Blocks dropped when inserted to the queue aren't summarized and don't shift Block indexes
+        qp.policy = OutputQueuePolicy::DROP_NEWEST;
+        TrafficGeneratorConfig config;
+        TrafficGenerator generator(config);
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION, qp);
+            exporter.set_block_summaries(".summary");
+            generator.generate(exporter, 5000);
+        }
+
+        std::vector<BlockSummary> summaries;
+        {
+            std::ifstream ifs(summary_file, std::ifstream::binary);
+            BlockSummaryReader reader(ifs);
+            summaries = reader.read_summaries();
+        }
+
+        std::ifstream ifs(file, std::ifstream::binary);
+        CdnsReader reader(ifs);
+        CdnsBlockRead block;
+        bool eof = false;
+        uint64_t blocks = 0;
+        while (true) {
+            reader.read_block(block, eof);
+            if (eof)
+                break;
+
+            ASSERT_LT(blocks, summaries.size());
+            EXPECT_EQ(summaries[blocks].block_index, blocks);
+            EXPECT_EQ(summaries[blocks].qr_count, block.get_qr_count());
+            EXPECT_EQ(summaries[blocks].mm_count, block.get_mm_count());
+            blocks++;
+        }
+        EXPECT_EQ(blocks, summaries.size());
+
+        remove_file(file);
+        remove_file(summary_file);
+    }
+}
@@ -84,6 +84,26 @@ namespace CDNS {
         EXPECT_EQ(index3, found);
     }
 
+    TEST(BlockTableTest, BTHashFunctionTest) {
+        struct ConstantHash {
+            std::size_t operator()(const ClassType&) const { return 0; }
+        };
+
+        // Every key collides, lookups have to rely on equality
+        BlockTable<ClassType, ClassType, ConstantHash> bt;
+        ClassType ct, ct2;
+        ct.type = 1;
+        ct2.type = 2;
+
+        EXPECT_EQ(bt.add(ct), 0);
+        EXPECT_EQ(bt.add(ct2), 1);
+        EXPECT_EQ(bt.add(ct), 0);
+
+        index_t found;
+        EXPECT_TRUE(bt.find(ct2, found));
+        EXPECT_EQ(found, 1);
+    }
+
     TEST(BlockTableTest, BTFind2Test) {
         AddressEventCount aec, aec2, aec3;
         BlockTable<AddressEventCount> bt;
@@ -106,4 +126,28 @@ namespace CDNS {
         index_t index3 = bt.add(aec3);
         EXPECT_EQ(index, index3);
     }
-}
\ No newline at end of file
+
+    TEST(BlockTableTest, BTStringViewTest) {
+        BlockTable<StringItem> bt;
+        const char data[] = "Test\0Test2";
+
+        index_t i = bt.add(data, 4);
+        index_t i2 = bt.add(data, sizeof(data) - 1);
+        index_t i3 = bt.add(std::string(data, 4).c_str(), 4);
+
+        EXPECT_EQ(i, 0);
+        EXPECT_EQ(i2, 1);
+        EXPECT_EQ(i3, i);
+        EXPECT_EQ(bt[i2].data, std::string(data, sizeof(data) - 1));
+
+        // Copy has its own index over its own strings
+        BlockTable<StringItem> copy(bt);
+        bt.clear();
+        index_t found;
+        EXPECT_TRUE(copy.find(data, 4, found));
+        EXPECT_EQ(found, i);
+        EXPECT_FALSE(copy.find(data, 3, found));
+        EXPECT_EQ(copy.add(data, sizeof(data) - 1), i2);
+        EXPECT_FALSE(bt.find(data, 4, found));
+    }
+}
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <map>
+#include <sstream>
 #include <gtest/gtest.h>
 
 #include "../src/cdns.h"
@@ -137,6 +139,7 @@ namespace CDNS {
         EXPECT_FALSE(bs.unmatched_responses);
         EXPECT_FALSE(bs.discarded_opcode);
         EXPECT_FALSE(bs.malformed_items);
+        EXPECT_FALSE(bs.dropped_items);
     }
 
     TEST(QueryResponseTest, QRCTest) {
@@ -297,6 +300,14 @@ namespace CDNS {
         EXPECT_EQ(list, block.get_rr_list(index7));
         EXPECT_EQ(rr, block.get_rr(index8));
         EXPECT_EQ(mmd, block.get_malformed_message_data(index9));
+
+        // Lists given as array are deduplicated with lists given as vector, longer lists are stored too
+        std::vector<index_t> long_list = {0, 1, 2, 3, 4, 5};
+        EXPECT_EQ(block.add_question_list(list.data(), list.size()), index5);
+        EXPECT_EQ(block.add_rr_list(list.data(), list.size()), index7);
+        index_t long_index = block.add_rr_list(long_list);
+        EXPECT_EQ(block.add_rr_list(long_list.data(), long_list.size()), long_index);
+        EXPECT_EQ(long_list, block.get_rr_list(long_index));
     }
 
     TEST(BlockTest, BlockAddGListTest) {
@@ -334,6 +345,39 @@ namespace CDNS {
         EXPECT_EQ(index4, 1);
     }
 
+    TEST(BlockTest, BlockAddRawIPTest) {
+        BlockParameters bp;
+        bp.storage_parameters.client_address_prefix_ipv4 = 20;
+        bp.storage_parameters.client_address_prefix_ipv6 = 48;
+        CdnsBlock block(bp, 0);
+        in_addr ip4 = {htonl(0xC0A8FF01)}; // 192.168.255.1
+        in_addr ip4_2 = {htonl(0xC0A8F002)}; // 192.168.240.2
+        in6_addr ip6 = {};
+        ip6.s6_addr[0] = 0x20;
+        ip6.s6_addr[1] = 0x01;
+        ip6.s6_addr[5] = 0xFF;
+        ip6.s6_addr[15] = 0x01;
+
+        index_t index = block.add_ip_address(ip4);
+        index_t index_dup = block.add_ip_address(ip4_2);
+        index_t index2 = block.add_ip_address(ip4, false);
+        index_t index3 = block.add_ip_address(ip6);
+        index_t index4 = block.add_ip_address(std::string("\xC0\xA8\xF0", 3));
+
+        EXPECT_EQ(index, 0);
+        EXPECT_EQ(index, index_dup);
+        EXPECT_EQ(index2, 1);
+        EXPECT_EQ(index3, 2);
+        EXPECT_EQ(index4, index);
+        EXPECT_EQ(block.get_ip_address(index), std::string("\xC0\xA8\xF0", 3));
+        EXPECT_EQ(block.get_ip_address(index2), std::string("\xC0\xA8\xFF\x01", 4));
+        EXPECT_EQ(block.get_ip_address(index3), std::string("\x20\x01\x00\x00\x00\xFF", 6));
+        EXPECT_THROW(block.add_ip_address(ip6.s6_addr, 8), std::runtime_error);
+
+        block.clear();
+        EXPECT_EQ(block.add_ip_address(ip6), 0);
+    }
+
     TEST(BlockTest, BlockAddQRTest) {
         BlockParameters bp;
         CdnsBlock block(bp, 0);
@@ -359,6 +403,136 @@ namespace CDNS {
         EXPECT_EQ(block.get_item_count(), 0);
     }
 
+    TEST(BlockTest, BlockQRBuilderTest) {
+        BlockParameters bp;
+        bp.storage_parameters.storage_hints.query_response_hints = static_cast<QueryResponseHintsMask>(0xFFFFFFFF);
+        CdnsBlock block(bp, 0);
+        CdnsBlock block2(bp, 0);
+        const char wire[] = "\x04" "test" "\x02" "cz" "\x00" "\xC0\x0C";
+        ClassType ct;
+        ct.type = 1;
+        ct.class_ = 1;
+
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(13, 1234);
+        gqr.client_ip = std::string("\x0A\x00\x00\x01", 4);
+        gqr.client_port = 1234;
+        gqr.server_ip = std::string("\x0A\x00\x00\x02", 4);
+        gqr.query_classtype = ct;
+        gqr.query_name = std::string(wire, 9);
+        gqr.bailiwick = std::string("\x02" "cz" "\x00", 4);
+        GenericResourceRecord grr;
+        grr.name = std::string(wire, 9);
+        grr.classtype = ct;
+        grr.ttl = 300;
+        grr.rdata = std::string("\x01\x02\x03\x04", 4);
+        gqr.query_questions = std::vector<GenericResourceRecord>{grr};
+        gqr.response_answers = std::vector<GenericResourceRecord>{grr, grr};
+        gqr.user_id = std::string("user");
+
+        EXPECT_FALSE(block.add_question_response_record(gqr));
+
+        QueryResponseBuilder builder(block2);
+        in_addr client = {htonl(0x0A000001)};
+        builder.timestamp(Timestamp(13, 1234))
+               .client_address(client)
+               .client_port(1234)
+               .server_address("\x0A\x00\x00\x02", 4)
+               .query_classtype(ct)
+               .query_name_wire(reinterpret_cast<const uint8_t*>(wire), sizeof(wire))
+               .bailiwick("\x02" "cz" "\x00", 4)
+               .add_record(QueryResponseSection::QUERY_QUESTION, wire, 9, ct)
+               .add_record(QueryResponseSection::RESPONSE_ANSWER, wire, 9, ct, 300u, "\x01\x02\x03\x04", 4)
+               .add_record(QueryResponseSection::RESPONSE_ANSWER, wire, 9, ct, 300u, "\x01\x02\x03\x04", 4)
+               .user_id("user", 4);
+        EXPECT_FALSE(builder.finish());
+
+        EXPECT_EQ(block2.get_qr_count(), 1);
+        EXPECT_EQ(block.string(), block2.string());
+        EXPECT_EQ(block2.get_name_rdata(0), std::string(wire, 9));
+        EXPECT_EQ(block2.get_rr_list(0).size(), 2);
+
+        // Builder is reset after finish and empty QueryResponse isn't added
+        builder.finish();
+        EXPECT_EQ(block2.get_qr_count(), 1);
+
+        // Compressed or truncated NAME is rejected
+        EXPECT_THROW(builder.query_name_wire(reinterpret_cast<const uint8_t*>(wire) + 9, 2), std::runtime_error);
+        EXPECT_THROW(builder.query_name_wire(reinterpret_cast<const uint8_t*>(wire), 8), std::runtime_error);
+        EXPECT_EQ(QueryResponseBuilder::wire_name_length(reinterpret_cast<const uint8_t*>(wire), 9), 9);
+    }
+
+    TEST(BlockTest, BlockTableCacheTest) {
+        BlockParameters bp;
+        CdnsBlock block(bp, 0);
+        CdnsBlock cached(bp, 0);
+        auto anonymizer = std::make_shared<IpAnonymizer>(std::string(IpAnonymizer::KEY_SIZE, 'k'));
+        block.set_anonymizer(anonymizer);
+        cached.set_anonymizer(anonymizer);
+        cached.set_table_cache(100);
+
+        GenericQueryResponse qr;
+        qr.client_ip = std::string("\x0A\x00\x00\x01", 4);
+        qr.client_port = 53;
+        qr.ts = Timestamp(13, 1234);
+
+        for (unsigned i = 0; i < 3; i++) {
+            qr.query_name = "name" + std::to_string(i % 2);
+            block.add_question_response_record(qr);
+            cached.add_question_response_record(qr);
+            in_addr raw = {htonl(0x0A000001)};
+            EXPECT_EQ(cached.add_ip_address(raw), block.add_ip_address(raw));
+            EXPECT_EQ(block.string(), cached.string());
+
+            block.clear();
+            cached.clear();
+        }
+    }
+
+    TEST(BlockTest, BlockPreEncodeTest) {
+        BlockParameters bp;
+        CdnsBlock block(bp, 0);
+        CdnsBlock encoded(bp, 0);
+
+        GenericQueryResponse qr;
+        qr.client_ip = std::string("\x0A\x00\x00\x01", 4);
+        qr.client_port = 53;
+        qr.ts = Timestamp(13, 1234);
+        qr.query_name = "name0";
+        block.add_question_response_record(qr);
+        encoded.add_question_response_record(qr);
+
+        // Items inserted before enabling are encoded too
+        encoded.set_pre_encode(true);
+
+        GenericMalformedMessage mm;
+        mm.ts = Timestamp(13, 1234);
+        mm.client_ip = "8.8.8.8";
+        mm.mm_payload = "TestMM";
+
+        for (unsigned i = 0; i < 3; i++) {
+            qr.query_name = "name" + std::to_string(i + 1);
+            block.add_question_response_record(qr);
+            encoded.add_question_response_record(qr);
+            block.add_malformed_message(mm);
+            encoded.add_malformed_message(mm);
+
+            std::string out, out_encoded, out_copy;
+            CdnsBlock copy(encoded);
+            {
+                CdnsEncoder enc(out), enc_encoded(out_encoded), enc_copy(out_copy);
+                EXPECT_EQ(block.write(enc), encoded.write(enc_encoded));
+                copy.write(enc_copy);
+            }
+            EXPECT_FALSE(out.empty());
+            EXPECT_EQ(out, out_encoded);
+            EXPECT_EQ(out, out_copy);
+
+            block.clear();
+            encoded.clear();
+        }
+    }
+
     TEST(BlockTest, BlockAddAECTest) {
         BlockParameters bp;
         CdnsBlock block(bp, 0);
@@ -510,6 +684,62 @@ namespace CDNS {
         EXPECT_FALSE(gqr.policy_rule);
     }
 
+    TEST(BlockReadTest, BlockReadFilterTablesFirstTest) {
+        FilePreamble fp;
+        CdnsBlock block(fp.get_block_parameters(0), 0);
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(100, 500);
+        gqr.client_ip = std::string("\x01\x02\x03\x04", 4);
+        gqr.query_name = std::string("\x03www\x02nic\x02" "cz\x00", 12);
+        block.add_question_response_record(gqr);
+
+        std::string out;
+        {
+            CdnsEncoder enc(out);
+            block.write(enc);
+        }
+
+        // Reorder the Block map so that Block tables precede Block preamble
+        std::map<int64_t, std::string> entries;
+        {
+            std::istringstream input(out);
+            CdnsDecoder dec(input);
+            bool indef = false;
+            uint64_t length = dec.read_map_start(indef);
+            ASSERT_FALSE(indef);
+            ASSERT_LT(length, 24U);
+            for (uint64_t i = 0; i < length; i++) {
+                std::string entry;
+                dec.start_capture(entry);
+                int64_t key = dec.read_integer();
+                dec.skip_item();
+                dec.stop_capture();
+                entries[key] = entry;
+            }
+        }
+        int64_t tables_key = get_map_index(BlockMapIndex::block_tables);
+        ASSERT_TRUE(entries.count(tables_key));
+        std::string reordered(1, static_cast<char>(0xa0 + entries.size()));
+        reordered += entries[tables_key];
+        for (auto& entry : entries) {
+            if (entry.first != tables_key)
+                reordered += entry.second;
+        }
+
+        for (bool present : {false, true}) {
+            ItemFilter filter;
+            filter.query_name = present ? *gqr.query_name : std::string("\x07missing\x00", 9);
+            std::istringstream input(reordered);
+            CdnsDecoder dec(input);
+            CdnsBlockRead read_block;
+            bool ret = false;
+            ASSERT_NO_THROW(ret = read_block.read(dec, fp.m_block_parameters, filter));
+            EXPECT_EQ(ret, present);
+            EXPECT_EQ(read_block.m_block_preamble.earliest_time.m_secs, 100);
+            EXPECT_EQ(read_block.get_qr_count(), present ? 1U : 0U);
+        }
+    }
+
     TEST(BlockReadTest, BlockReadGenericAECTest) {
         CdnsBlock block;
         AddressEventCount aec;
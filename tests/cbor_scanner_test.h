@@ -0,0 +1,113 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+#include "../src/cdns.h"
+#include "common.h"
+
+namespace CDNS {
+    /**
+     * @brief Get pointer to raw bytes of a string
+     */
+    inline const uint8_t* scan_data(const std::string& str) {
+        return reinterpret_cast<const uint8_t*>(str.data());
+    }
+
+    TEST(CborScannerTest, CSItemSizeTest) {
+        // [1, {"a": [_ h'01', "b"]}, 0("xyz"), (_ "ab" "cd"), 17777216, -500]
+        std::string item = "\x86\x01\xA1\x61\x61\x9F\x41\x01\x61\x62\xFF\xC0\x63xyz"
+                           "\x7F\x62\x61\x62\x62\x63\x64\xFF\x1A\x01\x0F\x42\x40\x39\x01\xF3";
+        std::string input = item + dunsigned + dtextstring;
+
+        EXPECT_EQ(CborScanner::item_size(scan_data(input), input.size()), item.size());
+        EXPECT_EQ(CborScanner::item_size(scan_data(dunsigned), dunsigned.size()), dunsigned.size());
+
+        // Item doesn't end within the buffer
+        for (std::size_t i = 0; i < item.size(); i++)
+            EXPECT_EQ(CborScanner::item_size(scan_data(input), i), 0);
+    }
+
+    TEST(CborScannerTest, CSSingleByteItemsTest) {
+        // Array of 20 small integers and simple values followed by 20 more single byte items
+        std::string items;
+        for (int i = 0; i < 40; i++)
+            items.push_back(static_cast<char>(i % 3 == 0 ? i % 24 : (i % 3 == 1 ? 0x20 + i % 24 : 0xF4)));
+        std::string input = "\x94" + items;
+
+        EXPECT_EQ(CborScanner::item_size(scan_data(input), input.size()), 21);
+
+        CborScanner scanner(21);
+        EXPECT_EQ(scanner.scan(scan_data(input), input.size()), 41);
+        EXPECT_TRUE(scanner.done());
+
+        // Items in indefinite length array
+        std::string indef = "\x9F" + items + dstop_code + dunsigned;
+        EXPECT_EQ(CborScanner::item_size(scan_data(indef), indef.size()), 42);
+    }
+
+    TEST(CborScannerTest, CSChunkedTest) {
+        TrafficGeneratorConfig config;
+        config.aec_ratio = 0.1;
+        config.mm_ratio = 0.05;
+        TrafficGenerator generator(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 300;
+        std::string name = "scanner_test.out";
+
+        {
+            CdnsExporter exporter(fp, name, CborOutputCompression::NO_COMPRESSION);
+            generator.generate(exporter, 1000);
+            exporter.write_block();
+        }
+
+        std::string file;
+        {
+            std::ifstream ifs(name, std::ifstream::binary);
+            file.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        }
+        remove_file(name);
+
+        // Whole C-DNS file is one CBOR item
+        EXPECT_EQ(CborScanner::item_size(scan_data(file), file.size()), file.size());
+
+        // The same item boundary is found with item heads and strings split between chunks
+        for (std::size_t chunk : {1, 2, 7, 100, 4096}) {
+            CborScanner scanner;
+            std::size_t scanned = 0;
+            while (!scanner.done() && scanned < file.size()) {
+                std::size_t size = std::min(chunk, file.size() - scanned);
+                std::size_t consumed = scanner.scan(scan_data(file) + scanned, size);
+                scanned += consumed;
+                if (consumed < size)
+                    break;
+            }
+
+            EXPECT_TRUE(scanner.done());
+            EXPECT_EQ(scanned, file.size());
+        }
+    }
+
+    TEST(CborScannerTest, CSMalformedTest) {
+        std::string unexpected_break = "\x82\x01\xFF";
+        EXPECT_THROW(CborScanner::item_size(scan_data(unexpected_break), unexpected_break.size()),
+                     CdnsDecoderException);
+
+        std::string unsupported = "\x82\x01\x1C";
+        EXPECT_THROW(CborScanner::item_size(scan_data(unsupported), unsupported.size()),
+                     CdnsDecoderException);
+
+        std::string indef_int = "\x1F";
+        EXPECT_THROW(CborScanner::item_size(scan_data(indef_int), indef_int.size()),
+                     CdnsDecoderException);
+    }
+}
@@ -227,4 +227,138 @@ namespace CDNS {
         peek = dec.peek_type();
         EXPECT_EQ(peek, CborType::SIMPLE);
     }
+
+    TEST(CdnsDecoderTest, CDSkipNestedTest) {
+        // [1, {"a": [_ h'01', "b"]}, 0("xyz")] followed by indefinite map {_ 1: (_ "ab" "cd")}
+        std::string nested = "\x83\x01\xA1\x61\x61\x9F\x41\x01\x61\x62\xFF\xC0\x63xyz";
+        std::string indef = "\xBF\x01\x7F\x62\x61\x62\x62\x63\x64\xFF\xFF";
+        std::istringstream is(nested + indef + dunsigned);
+        CdnsDecoder dec(is);
+
+        dec.skip_item();
+        EXPECT_EQ(dec.peek_type(), CborType::MAP);
+
+        dec.skip_item();
+        EXPECT_EQ(dec.read_unsigned(), 42);
+    }
+
+    TEST(CdnsDecoderTest, CDSkipLargeStringTest) {
+        // Byte string larger than decoder's buffer
+        std::string data(CdnsDecoder::BUFFER_SIZE * 3 + 5, 'x');
+        std::string cbor = "\x5A" + std::string(4, '\0') + data + dunsigned;
+        cbor[1] = static_cast<char>((data.size() >> 24) & 0xFF);
+        cbor[2] = static_cast<char>((data.size() >> 16) & 0xFF);
+        cbor[3] = static_cast<char>((data.size() >> 8) & 0xFF);
+        cbor[4] = static_cast<char>(data.size() & 0xFF);
+
+        {
+            std::ofstream out("skip_test.out", std::ios::binary);
+            out << cbor;
+        }
+
+        // Seekable input
+        {
+            std::ifstream is("skip_test.out", std::ios::binary);
+            CdnsDecoder dec(is);
+            dec.skip_item();
+            EXPECT_EQ(dec.read_unsigned(), 42);
+        }
+
+        // Skipped data are captured
+        {
+            std::ifstream is("skip_test.out", std::ios::binary);
+            CdnsDecoder dec(is);
+            std::string raw;
+            dec.start_capture(raw);
+            dec.skip_item();
+            dec.stop_capture();
+            EXPECT_EQ(raw, cbor.substr(0, cbor.size() - dunsigned.size()));
+            EXPECT_EQ(dec.read_unsigned(), 42);
+        }
+
+        // Truncated input
+        {
+            std::istringstream is(cbor.substr(0, CdnsDecoder::BUFFER_SIZE * 2));
+            CdnsDecoder dec(is);
+            EXPECT_THROW(dec.skip_item(), CdnsDecoderEnd);
+        }
+
+        // Array ending with the string at the end of input
+        for (bool seekable : {false, true}) {
+            std::string array = "\x82" + dunsigned + cbor.substr(0, cbor.size() - dunsigned.size());
+            {
+                std::ofstream out("skip_test.out", std::ios::binary);
+                out << array;
+            }
+            std::ifstream ifs("skip_test.out", std::ios::binary);
+            std::istringstream iss(array);
+            CdnsDecoder dec(seekable ? static_cast<std::istream&>(ifs) : static_cast<std::istream&>(iss));
+            EXPECT_NO_THROW(dec.skip_item());
+            EXPECT_THROW(dec.read_unsigned(), CdnsDecoderEnd);
+        }
+
+        remove_file("skip_test.out");
+    }
+
+    TEST(CdnsDecoderTest, CDTryReadTest) {
+        // Indefinite length text string (_ "te" "st")
+        std::string indef_text = "\x7F\x62te\x62st\xFF";
+        std::istringstream is(dunsigned + dnegative + indef_text + darray + dsimple + dstop_code);
+        CdnsDecoder dec(is);
+
+        // Wrong type doesn't consume the item
+        std::string str;
+        bool indef = false;
+        uint64_t length = 0;
+        EXPECT_EQ(dec.try_read_textstring(str), CdnsDecoderStatus::WRONG_TYPE);
+        int64_t value = 0;
+        EXPECT_EQ(dec.try_read_negative(value), CdnsDecoderStatus::WRONG_TYPE);
+        EXPECT_EQ(dec.try_read_break(), CdnsDecoderStatus::WRONG_TYPE);
+
+        uint64_t uvalue = 0;
+        EXPECT_EQ(dec.try_read_unsigned(uvalue), CdnsDecoderStatus::OK);
+        EXPECT_EQ(uvalue, 42);
+
+        EXPECT_EQ(dec.try_read_integer(value), CdnsDecoderStatus::OK);
+        EXPECT_EQ(value, -4242);
+
+        EXPECT_EQ(dec.try_read_textstring(str), CdnsDecoderStatus::OK);
+        EXPECT_EQ(str, "test");
+
+        EXPECT_EQ(dec.try_read_map_start(length, indef), CdnsDecoderStatus::WRONG_TYPE);
+        EXPECT_EQ(dec.try_read_array_start(length, indef), CdnsDecoderStatus::OK);
+        EXPECT_EQ(length, 2);
+        EXPECT_FALSE(indef);
+
+        // Simple value other than true/false isn't bool
+        bool bvalue = false;
+        EXPECT_EQ(dec.try_read_bool(bvalue), CdnsDecoderStatus::INVALID_VALUE);
+        EXPECT_THROW(dec.read_bool(), CdnsDecoderException);
+        dec.skip_item();
+
+        CborType peek;
+        EXPECT_EQ(dec.try_peek_type(peek), CdnsDecoderStatus::OK);
+        EXPECT_EQ(peek, CborType::BREAK);
+        EXPECT_EQ(dec.try_read_break(), CdnsDecoderStatus::OK);
+
+        EXPECT_EQ(dec.try_peek_type(peek), CdnsDecoderStatus::END);
+        EXPECT_EQ(dec.try_read_unsigned(uvalue), CdnsDecoderStatus::END);
+        EXPECT_THROW(dec.read_unsigned(), CdnsDecoderEnd);
+    }
+
+    TEST(CdnsDecoderTest, CDTryReadMalformedTest) {
+        // Indefinite length text string with byte string chunk
+        std::istringstream is("\x7F\x62te\x42st\xFF");
+        CdnsDecoder dec(is);
+
+        std::string str;
+        EXPECT_EQ(dec.try_read_textstring(str), CdnsDecoderStatus::MALFORMED);
+
+        // Truncated unsigned integer
+        std::istringstream is2("\x19\x10");
+        CdnsDecoder dec2(is2);
+
+        uint64_t value;
+        EXPECT_EQ(dec2.try_read_unsigned(value), CdnsDecoderStatus::END);
+    }
 }
\ No newline at end of file
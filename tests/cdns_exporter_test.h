@@ -12,6 +12,9 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
 #include <gtest/gtest.h>
 
 #include "../src/cdns.h"
@@ -162,13 +165,309 @@ namespace CDNS {
         EXPECT_EQ(exporter->get_block_item_count(), 1);
         std::size_t written = exporter->rotate_output(file2, true);
 
-        test_size_and_remove_file(file, written);
-
         exporter->buffer_qr(gqr2);
         EXPECT_EQ(exporter->get_block_item_count(), 1);
-        written = exporter->write_block();
+        std::size_t written2 = exporter->write_block();
+        delete exporter;
+
+        // Rotated file is closed and renamed in background, so it's complete only after the exporter is destroyed
+        test_size_and_remove_file(file, written);
+        test_size_and_remove_file(file2, written2 + 1);
+    }
+
+    /**
+     * @brief Count QueryResponses and dropped items recorded in Block statistics of given C-DNS data
+     * @param input Uncompressed C-DNS data
+     * @param dropped Sum of dropped items in Block statistics
+     * @return Number of QueryResponses
+     */
+    std::size_t count_qrs(std::istream& input, uint64_t& dropped) {
+        CdnsReader reader(input);
+        std::size_t qrs = 0;
+        bool eof = false;
+        dropped = 0;
+
+        while (true) {
+            CdnsBlockRead block = reader.read_block(eof);
+            if (eof)
+                break;
+
+            qrs += block.get_qr_count();
+            if (block.m_block_statistics && block.m_block_statistics->dropped_items)
+                dropped += block.m_block_statistics->dropped_items.value();
+        }
+
+        return qrs;
+    }
+
+    TEST(CdnsExporterTest, CEAsyncRotateTest) {
+        FilePreamble fp;
+        fp.m_block_parameters[0].storage_parameters.max_block_items = 3;
+        OutputQueueParameters qp;
+        qp.max_blocks = 2;
+        qp.policy = OutputQueuePolicy::BLOCK;
+        CdnsExporter* exporter = new CdnsExporter(fp, file, CborOutputCompression::NO_COMPRESSION, qp);
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        gqr.client_ip = std::string("8.8.8.8");
+
+        for (int i = 0; i < 10; i++)
+            exporter->buffer_qr(gqr);
+        exporter->rotate_output(file2, true);
+
+        for (int i = 0; i < 7; i++)
+            exporter->buffer_qr(gqr);
+        exporter->write_block();
+        EXPECT_EQ(exporter->get_dropped_items_count(), 0);
+        delete exporter;
+
+        uint64_t dropped = 0;
+        std::ifstream in1(file), in2(file2);
+        EXPECT_EQ(count_qrs(in1, dropped), 10);
+        EXPECT_EQ(dropped, 0);
+        EXPECT_EQ(count_qrs(in2, dropped), 7);
+        EXPECT_EQ(dropped, 0);
+
+        remove_file(file);
+        remove_file(file2);
+    }
+
+    TEST(CdnsExporterTest, CEAsyncDropTest) {
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+
+        FilePreamble fp;
+        fp.m_block_parameters[0].storage_parameters.max_block_items = 10;
+        OutputQueueParameters qp;
+        qp.max_blocks = 1;
+        qp.policy = OutputQueuePolicy::DROP_NEWEST;
+        CdnsExporter* exporter = new CdnsExporter(fp, fds[1], CborOutputCompression::NO_COMPRESSION, qp);
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        gqr.user_id = std::string(1000, 'x');
+
+        // Nobody reads the pipe yet so the output gets stuck and Blocks have to be dropped
+        const std::size_t total = 5000;
+        for (std::size_t i = 0; i < total; i++)
+            exporter->buffer_qr(gqr);
+        EXPECT_GT(exporter->get_dropped_items_count(), 0);
+
+        std::string output;
+        std::thread reader([&output, &fds]() {
+            char buff[4096];
+            ssize_t ret;
+            while ((ret = read(fds[0], buff, sizeof(buff))) > 0)
+                output.append(buff, ret);
+        });
+
+        uint64_t dropped_total = exporter->get_dropped_items_count();
+        delete exporter;
+        reader.join();
+        close(fds[0]);
+
+        uint64_t dropped = 0;
+        std::istringstream in(output);
+        EXPECT_EQ(count_qrs(in, dropped) + dropped_total, total);
+        EXPECT_LE(dropped, dropped_total);
+    }
+
+    TEST(CdnsExporterTest, CEAsyncDropOldestTest) {
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+
+        FilePreamble fp;
+        fp.m_block_parameters[0].storage_parameters.max_block_items = 10;
+        OutputQueueParameters qp;
+        qp.max_blocks = 2;
+        qp.policy = OutputQueuePolicy::DROP_OLDEST;
+        CdnsExporter* exporter = new CdnsExporter(fp, fds[1], CborOutputCompression::NO_COMPRESSION, qp);
+        uint64_t new_dropped = 0;
+        exporter->set_metrics_callback([&new_dropped](const BlockMetrics& bm) { new_dropped += bm.dropped; });
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        gqr.user_id = std::string(1000, 'x');
+
+        // Nobody reads the pipe yet so queued Blocks get evicted by the new ones
+        const std::size_t total = 5000;
+        for (std::size_t i = 0; i < total; i++)
+            exporter->buffer_qr(gqr);
+
+        ExporterMetrics metrics = exporter->get_metrics();
+        EXPECT_EQ(new_dropped, 0U);
+        EXPECT_GT(metrics.blocks_dropped, 0U);
+        EXPECT_EQ(metrics.blocks_dropped * 10, metrics.dropped_items);
+
+        std::string output;
+        std::thread reader([&output, &fds]() {
+            char buff[4096];
+            ssize_t ret;
+            while ((ret = read(fds[0], buff, sizeof(buff))) > 0)
+                output.append(buff, ret);
+        });
+
+        metrics = exporter->get_metrics();
+        delete exporter;
+        reader.join();
+        close(fds[0]);
+
+        uint64_t dropped = 0;
+        std::istringstream in(output);
+        EXPECT_EQ(count_qrs(in, dropped) + metrics.dropped_items, total);
+        EXPECT_EQ(metrics.blocks_written, total / 10);
+    }
+
+    TEST(CdnsExporterTest, CERotationPolicyTest) {
+        FilePreamble fp;
+        fp.m_block_parameters[0].storage_parameters.max_block_items = 2;
+        CdnsExporter* exporter = new CdnsExporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+        RotationParameters rp;
+        EXPECT_THROW(exporter->set_rotation_parameters(rp), CdnsEncoderException);
+        rp.max_blocks = 2;
+        rp.name_template = "test_rot_%N%%.out";
+        exporter->set_rotation_parameters(rp);
+
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        gqr.client_ip = std::string("8.8.8.8");
+
+        for (int i = 0; i < 10; i++)
+            exporter->buffer_qr(gqr);
+        EXPECT_EQ(exporter->get_blocks_written_count(), 1);
+        delete exporter;
+
+        uint64_t dropped = 0;
+        std::vector<std::string> files = {file, "test_rot_0%.out", "test_rot_1%.out"};
+        std::vector<std::size_t> counts = {4, 4, 2};
+        for (std::size_t i = 0; i < files.size(); i++) {
+            std::ifstream in(files[i]);
+            EXPECT_EQ(count_qrs(in, dropped), counts[i]);
+            remove_file(files[i]);
+        }
+    }
+
+    TEST(CdnsExporterTest, CERawBlockTimeRotationTest) {
+        FilePreamble fp;
+        fp.m_block_parameters[0].storage_parameters.max_block_items = 1;
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        {
+            CdnsExporter exporter(fp, file2, CborOutputCompression::NO_COMPRESSION);
+            exporter.buffer_qr(gqr);
+            exporter.buffer_qr(gqr);
+        }
+
+        std::ifstream input(file2, std::ifstream::binary);
+        CdnsReader reader(input);
+        bool eof = false;
+        CdnsRawBlock block1 = reader.read_raw_block(eof);
+        CdnsRawBlock block2 = reader.read_raw_block(eof);
+        ASSERT_FALSE(eof);
+
+        CdnsExporter* exporter = new CdnsExporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+        RotationParameters rp;
+        rp.interval = 1;
+        rp.name_template = "test_rot_%N.out";
+        exporter->set_rotation_parameters(rp);
+
+        // Copied raw Blocks are split to different outputs by time based rotation
+        exporter->write_block(block1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+        exporter->write_block(block2);
+        delete exporter;
+
+        uint64_t dropped = 0;
+        std::size_t total = 0;
+        for (const std::string& name : {file, std::string("test_rot_0.out"), std::string("test_rot_1.out")}) {
+            struct stat st;
+            if (stat(name.c_str(), &st) == 0 && st.st_size > 0) {
+                std::ifstream in(name, std::ifstream::binary);
+                std::size_t qrs = count_qrs(in, dropped);
+                EXPECT_EQ(qrs, 1U);
+                total += qrs;
+            }
+            remove(name.c_str());
+        }
+        EXPECT_EQ(total, 2U);
+        remove_file(file2);
+    }
+
+    TEST(CdnsExporterTest, CERotationPolicyFdTest) {
+        FilePreamble fp;
+        RotationParameters rp;
+        rp.max_blocks = 1;
+        rp.name_template = "test_rot_%N.out";
+
+        int fd = open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT_NE(fd, -1);
+        CdnsExporter* exporter = new CdnsExporter(fp, fd, CborOutputCompression::NO_COMPRESSION);
+        EXPECT_THROW(exporter->set_rotation_parameters(rp), CdnsEncoderException);
+
+        // Blocks keep going to the file descriptor as one C-DNS stream
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        for (int i = 0; i < 3; i++) {
+            exporter->buffer_qr(gqr);
+            exporter->write_block();
+        }
+        delete exporter;
+
+        uint64_t dropped = 0;
+        std::ifstream in(file);
+        EXPECT_EQ(count_qrs(in, dropped), 3);
+        EXPECT_FALSE(std::ifstream("test_rot_0.out").good());
+        remove_file(file);
+    }
+
+    TEST(CdnsExporterTest, CEMetricsTest) {
+        FilePreamble fp;
+        fp.m_block_parameters[0].storage_parameters.max_block_items = 2;
+        CdnsExporter* exporter = new CdnsExporter(fp, file, CborOutputCompression::GZIP);
+        std::vector<BlockMetrics> blocks;
+        exporter->set_metrics_callback([&blocks](const BlockMetrics& bm) { blocks.push_back(bm); });
+
+        GenericQueryResponse gqr;
+        gqr.ts = Timestamp(12, 12543);
+        gqr.client_ip = std::string("8.8.8.8");
+
+        std::size_t written = 0;
+        for (int i = 0; i < 5; i++)
+            written += exporter->buffer_qr(gqr);
+        written += exporter->write_block();
+
+        ExporterMetrics metrics = exporter->get_metrics();
+        EXPECT_EQ(metrics.qr_items, 5U);
+        EXPECT_EQ(metrics.aec_items, 0U);
+        EXPECT_EQ(metrics.blocks_written, 3U);
+        EXPECT_EQ(metrics.blocks_dropped, 0U);
+        EXPECT_EQ(metrics.uncompressed_bytes, written);
+        EXPECT_EQ(metrics.queued_blocks, 0U);
+        EXPECT_EQ(metrics.last_block.qr_count, 1U);
+
+        ASSERT_EQ(blocks.size(), 3U);
+        EXPECT_EQ(blocks[0].qr_count, 2U);
+        EXPECT_GT(blocks[0].bytes, 0U);
+        EXPECT_EQ(blocks[0].tables.ip_address.items, 1U);
+        EXPECT_EQ(blocks[0].tables.ip_address.lookups, 2U);
+        EXPECT_DOUBLE_EQ(blocks[0].tables.ip_address.hit_ratio(), 0.5);
+        EXPECT_DOUBLE_EQ(blocks[0].tables.name_rdata.hit_ratio(), 0.0);
+
+        // Query/Responses given as raw DNS messages are counted too
+        const uint8_t query[] = {
+            0x12, 0x34, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x04, 't', 'e', 's', 't', 0x02, 'c', 'z', 0x00, 0x00, 0x01, 0x00, 0x01
+        };
+        WireQueryResponse wqr;
+        wqr.ts = Timestamp(12, 12543);
+        wqr.query = query;
+        wqr.query_size = sizeof(query);
+        exporter->buffer_wire_qr(wqr);
+        EXPECT_EQ(exporter->get_metrics().qr_items, 6U);
+        EXPECT_EQ(exporter->get_block_qr_count(), 1U);
         delete exporter;
 
-        test_size_and_remove_file(file2, written + 1);
+        std::ifstream in(file + ".gz", std::ifstream::binary);
+        std::string compressed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        EXPECT_GT(compressed.size(), 0U);
+        remove_file(file + ".gz");
     }
 }
@@ -0,0 +1,241 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "common.h"
+#include "../src/cdns.h"
+
+namespace CDNS {
+
+    /**
+     * @brief Generate C-DNS file with given seed and maximum number of items in Block
+     */
+    void generate_merge_input(const std::string& name, uint32_t seed, uint64_t block_items) {
+        TrafficGeneratorConfig config;
+        config.seed = seed;
+        config.aec_ratio = 0.1;
+        config.mm_ratio = 0.05;
+        TrafficGenerator generator(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = block_items;
+
+        CdnsExporter exporter(fp, name, CborOutputCompression::NO_COMPRESSION);
+        generator.generate(exporter, 1000);
+        exporter.write_block();
+    }
+
+    /**
+     * @brief Count Query/Responses, sum of Address Event counts and Malformed Messages in C-DNS file
+     */
+    void count_merge_items(const std::string& name, uint64_t& qr_count, uint64_t& aec_count, uint64_t& mm_count) {
+        std::ifstream ifs(name, std::ifstream::binary);
+        CdnsReader reader(ifs);
+        bool eof = false;
+        qr_count = aec_count = mm_count = 0;
+
+        while (true) {
+            CdnsBlockRead block = reader.read_block(eof);
+            if (eof)
+                break;
+
+            qr_count += block.get_qr_count();
+            mm_count += block.get_mm_count();
+            while (true) {
+                GenericAddressEventCount aec = block.read_generic_aec(eof);
+                if (eof)
+                    break;
+                aec_count += aec.ae_count;
+            }
+        }
+    }
+
+    TEST(CdnsMergerTest, CMTimeOrderedTest) {
+        std::string input1("test_merge1.out"), input2("test_merge2.out");
+        generate_merge_input(input1, 1, 300);
+        generate_merge_input(input2, 2, 700);
+
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 500;
+        {
+            std::ifstream ifs1(input1, std::ifstream::binary);
+            std::ifstream ifs2(input2, std::ifstream::binary);
+            CdnsReader reader1(ifs1);
+            CdnsReader reader2(ifs2);
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+
+            CdnsMerger merger;
+            merger.add_input(reader1);
+            merger.add_input(reader2);
+            merger.merge_time_ordered(exporter);
+            exporter.write_block();
+        }
+
+        uint64_t qr1, aec1, mm1, qr2, aec2, mm2, qr, aec, mm;
+        count_merge_items(input1, qr1, aec1, mm1);
+        count_merge_items(input2, qr2, aec2, mm2);
+        count_merge_items(file, qr, aec, mm);
+        EXPECT_EQ(qr, 2000);
+        EXPECT_EQ(qr, qr1 + qr2);
+        EXPECT_EQ(aec, aec1 + aec2);
+        EXPECT_EQ(mm, mm1 + mm2);
+
+        // Query/Responses are ordered by time and all Blocks except the last one are full
+        std::ifstream ifs(file, std::ifstream::binary);
+        CdnsReader reader(ifs);
+        std::vector<uint64_t> block_qrs;
+        Timestamp last_ts;
+        bool eof = false;
+
+        while (true) {
+            CdnsBlockRead block = reader.read_block(eof);
+            if (eof)
+                break;
+            block_qrs.push_back(block.get_qr_count());
+
+            while (true) {
+                GenericQueryResponse gqr = block.read_generic_qr(eof);
+                if (eof)
+                    break;
+                ASSERT_TRUE(gqr.ts);
+                EXPECT_TRUE(last_ts <= *gqr.ts);
+                last_ts = *gqr.ts;
+            }
+        }
+
+        ASSERT_GE(block_qrs.size(), 4);
+        for (std::size_t i = 0; i < 4; i++)
+            EXPECT_EQ(block_qrs[i], 500);
+
+        ifs.close();
+        remove_file(file);
+        remove_file(input1);
+        remove_file(input2);
+    }
+
+    /**
+     * @brief Merge given inputs with given number of threads and return content of the output file
+     * @param mode 0 = raw Blocks, 1 = decoded Blocks, 2 = time ordered
+     */
+    std::string merge_inputs(const std::vector<std::string>& inputs, unsigned threads, int mode) {
+        std::vector<std::unique_ptr<std::ifstream>> streams;
+        std::vector<std::unique_ptr<CdnsReader>> readers;
+        CdnsMerger merger(threads);
+
+        for (auto& input : inputs) {
+            streams.emplace_back(new std::ifstream(input, std::ifstream::binary));
+            readers.emplace_back(new CdnsReader(*streams.back()));
+            merger.add_input(*readers.back());
+        }
+
+        {
+            FilePreamble fp;
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            if (mode == 2) {
+                merger.merge_time_ordered(exporter);
+                exporter.write_block();
+            }
+            else {
+                merger.merge_blocks(exporter, mode == 1);
+            }
+        }
+
+        std::ifstream output(file, std::ifstream::binary);
+        std::string ret((std::istreambuf_iterator<char>(output)), std::istreambuf_iterator<char>());
+        remove_file(file);
+        return ret;
+    }
+
+    TEST(CdnsMergerTest, CMThreadsTest) {
+        std::vector<std::string> inputs;
+        for (uint32_t i = 0; i < 5; i++) {
+            inputs.push_back("test_merge" + std::to_string(i) + ".out");
+            generate_merge_input(inputs.back(), i, 100 + 50 * i);
+        }
+
+        for (int mode = 0; mode < 3; mode++) {
+            std::string single = merge_inputs(inputs, 0, mode);
+            EXPECT_FALSE(single.empty());
+            EXPECT_EQ(merge_inputs(inputs, 1, mode), single);
+            EXPECT_EQ(merge_inputs(inputs, 3, mode), single);
+            EXPECT_EQ(merge_inputs(inputs, 8, mode), single);
+        }
+
+        for (auto& input : inputs)
+            remove_file(input);
+    }
+
+    TEST(CdnsMergerTest, CMErrorCallbackTest) {
+        std::string input1("test_merge1.out"), input2("test_merge2.out");
+        generate_merge_input(input1, 1, 300);
+        generate_merge_input(input2, 2, 300);
+
+        // Cut the second input in the middle of a Block
+        std::string data;
+        {
+            std::ifstream ifs(input2, std::ifstream::binary);
+            data.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream ofs(input2, std::ofstream::binary | std::ofstream::trunc);
+            ofs.write(data.data(), data.size() / 2);
+        }
+
+        for (unsigned threads : {0, 2}) {
+            std::ifstream ifs1(input1, std::ifstream::binary);
+            std::ifstream ifs2(input2, std::ifstream::binary);
+            CdnsReader reader1(ifs1);
+            CdnsReader reader2(ifs2);
+            FilePreamble fp;
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            CdnsMerger merger(threads);
+            merger.add_input(reader2);
+            merger.add_input(reader1);
+
+            EXPECT_ANY_THROW(merger.merge_blocks(exporter));
+        }
+
+        for (unsigned threads : {0, 2}) {
+            std::ifstream ifs1(input1, std::ifstream::binary);
+            std::ifstream ifs2(input2, std::ifstream::binary);
+            CdnsReader reader1(ifs1);
+            CdnsReader reader2(ifs2);
+            std::vector<std::size_t> failed;
+            {
+                FilePreamble fp;
+                CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+                CdnsMerger merger(threads);
+                merger.set_error_callback([&failed](std::size_t input, const std::exception&) {
+                    failed.push_back(input);
+                });
+                merger.add_input(reader2);
+                merger.add_input(reader1);
+                merger.merge_blocks(exporter);
+            }
+
+            ASSERT_EQ(failed.size(), 1);
+            EXPECT_EQ(failed[0], 0);
+
+            // Complete Blocks of the cut input and the whole other input are merged
+            uint64_t qr1, aec1, mm1, qr, aec, mm;
+            count_merge_items(input1, qr1, aec1, mm1);
+            count_merge_items(file, qr, aec, mm);
+            EXPECT_GT(qr, qr1);
+            EXPECT_LT(qr, qr1 + 1000);
+        }
+
+        remove_file(file);
+        remove_file(input1);
+        remove_file(input2);
+    }
+}
@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <fstream>
+#include <tuple>
 #include <gtest/gtest.h>
 
 #include "../src/cdns.h"
@@ -248,4 +249,407 @@ namespace CDNS {
         ifs.close();
         remove_file(file);
     }
+
+    TEST(CdnsReaderTest, CRReadRawBlockTest) {
+        create_test_file();
+        std::ifstream ifs(file, std::ifstream::binary);
+        CdnsReader reader(ifs);
+
+        bool eof = false;
+        CdnsRawBlock block = reader.read_raw_block(eof);
+        ASSERT_FALSE(eof);
+        EXPECT_EQ(block.get_qr_count(), 2);
+        EXPECT_EQ(block.get_aec_count(), 2);
+        EXPECT_EQ(block.get_mm_count(), 1);
+        EXPECT_EQ(block.get_block_parameters_index(), 0);
+        EXPECT_EQ(block.m_block_preamble.earliest_time.m_secs, 12);
+
+        block = reader.read_raw_block(eof);
+        ASSERT_FALSE(eof);
+        EXPECT_EQ(block.get_item_count(), 2);
+
+        block = reader.read_raw_block(eof);
+        ASSERT_TRUE(eof);
+
+        ifs.close();
+        remove_file(file);
+    }
+
+    TEST(CdnsReaderTest, CRReadBlockCountsTest) {
+        TrafficGeneratorConfig config;
+        config.aec_ratio = 0.2;
+        config.mm_ratio = 0.1;
+        TrafficGenerator generator(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 1000;
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            generator.generate(exporter, 5500);
+            exporter.write_block();
+        }
+
+        std::ifstream ifs1(file, std::ifstream::binary);
+        std::ifstream ifs2(file, std::ifstream::binary);
+        CdnsReader reader1(ifs1);
+        CdnsReader reader2(ifs2);
+        bool eof1 = false, eof2 = false;
+        uint64_t blocks = 0;
+
+        while (true) {
+            CdnsBlockRead block = reader1.read_block(eof1);
+            BlockItemCounts counts = reader2.read_block_counts(eof2);
+            ASSERT_EQ(eof1, eof2);
+            if (eof1)
+                break;
+
+            EXPECT_EQ(counts.qr_count, block.get_qr_count());
+            EXPECT_EQ(counts.aec_count, block.get_aec_count());
+            EXPECT_EQ(counts.mm_count, block.get_mm_count());
+            EXPECT_GT(counts.aec_count, 0);
+            EXPECT_GT(counts.mm_count, 0);
+            blocks++;
+        }
+
+        EXPECT_EQ(blocks, 6);
+        BlockItemCounts counts = reader2.read_block_counts(eof2);
+        EXPECT_TRUE(eof2);
+        EXPECT_EQ(counts.qr_count, 0);
+
+        ifs1.close();
+        ifs2.close();
+        remove_file(file);
+    }
+
+    TEST(CdnsReaderTest, CRCopyRawBlockTest) {
+        // Blocks bigger than decoder's buffer
+        TrafficGenerator generator;
+        FilePreamble fp;
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            generator.generate(exporter, 25000);
+            exporter.write_block();
+        }
+
+        std::string copy("test_copy.out");
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            CdnsExporter exporter(reader.m_file_preamble, copy, CborOutputCompression::NO_COMPRESSION);
+            bool eof = false;
+            uint64_t qr_count = 0;
+
+            while (true) {
+                CdnsRawBlock block = reader.read_raw_block(eof);
+                if (eof)
+                    break;
+
+                EXPECT_GT(block.get_raw_size(), CdnsDecoder::BUFFER_SIZE);
+                qr_count += block.get_qr_count();
+                exporter.write_block(block);
+            }
+
+            EXPECT_EQ(qr_count, 25000);
+            EXPECT_EQ(exporter.get_metrics().blocks_written, 3);
+        }
+
+        // Copied file is identical to the original
+        std::ifstream orig(file, std::ifstream::binary);
+        std::ifstream copied(copy, std::ifstream::binary);
+        std::string orig_data((std::istreambuf_iterator<char>(orig)), std::istreambuf_iterator<char>());
+        std::string copied_data((std::istreambuf_iterator<char>(copied)), std::istreambuf_iterator<char>());
+        EXPECT_EQ(orig_data, copied_data);
+
+        // Block parameters index is rewritten and the rest of the Block decodes the same
+        BlockParameters bp;
+        fp.add_block_parameters(bp);
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            CdnsExporter exporter(fp, copy, CborOutputCompression::NO_COMPRESSION);
+            bool eof = false;
+            CdnsRawBlock block = reader.read_raw_block(eof);
+            ASSERT_FALSE(eof);
+            block.m_block_preamble.block_parameters_index = 1;
+            exporter.write_block(block);
+
+            block.m_block_preamble.block_parameters_index = 2;
+            EXPECT_THROW(exporter.write_block(block), CdnsEncoderException);
+        }
+
+        std::ifstream ifs1(file, std::ifstream::binary);
+        std::ifstream ifs2(copy, std::ifstream::binary);
+        CdnsReader reader1(ifs1);
+        CdnsReader reader2(ifs2);
+        bool eof1 = false, eof2 = false;
+        CdnsBlockRead block1 = reader1.read_block(eof1);
+        CdnsBlockRead block2 = reader2.read_block(eof2);
+        ASSERT_FALSE(eof1);
+        ASSERT_FALSE(eof2);
+        EXPECT_EQ(block2.get_block_parameters_index(), 1);
+        EXPECT_EQ(block1.get_qr_count(), block2.get_qr_count());
+
+        while (true) {
+            GenericQueryResponse qr1 = block1.read_generic_qr(eof1);
+            GenericQueryResponse qr2 = block2.read_generic_qr(eof2);
+            ASSERT_EQ(eof1, eof2);
+            if (eof1)
+                break;
+            EXPECT_EQ(qr1.ts->m_secs, qr2.ts->m_secs);
+            EXPECT_EQ(qr1.ts->m_ticks, qr2.ts->m_ticks);
+            EXPECT_EQ(*qr1.client_ip, *qr2.client_ip);
+            EXPECT_EQ(*qr1.query_name, *qr2.query_name);
+        }
+
+        ifs1.close();
+        ifs2.close();
+        remove_file(file);
+        remove_file(copy);
+    }
+
+    /**
+     * @brief Read timestamps and query names of all Query/Responses and timestamps of all Malformed
+     * messages with given reader
+     */
+    void read_filter_items(CdnsReader& reader, std::vector<std::pair<Timestamp, std::string>>& qrs,
+                           std::vector<Timestamp>& mms, uint64_t& blocks) {
+        CdnsBlockRead block;
+        bool eof = false;
+        blocks = 0;
+
+        while (true) {
+            reader.read_block(block, eof);
+            if (eof)
+                break;
+
+            blocks++;
+            bool end = false;
+            while (true) {
+                GenericQueryResponse gqr = block.read_generic_qr(end);
+                if (end)
+                    break;
+                qrs.emplace_back(*gqr.ts, gqr.query_name ? *gqr.query_name : std::string());
+            }
+
+            while (true) {
+                GenericMalformedMessage gmm = block.read_generic_mm(end);
+                if (end)
+                    break;
+                mms.push_back(*gmm.ts);
+            }
+        }
+    }
+
+    TEST(CdnsReaderTest, CRTimeFilterTest) {
+        TrafficGeneratorConfig config;
+        config.mm_ratio = 0.1;
+        TrafficGenerator generator(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 500;
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            generator.generate(exporter, 5000);
+            exporter.write_block();
+        }
+
+        std::vector<std::pair<Timestamp, std::string>> all_qrs;
+        std::vector<Timestamp> all_mms;
+        uint64_t all_blocks = 0;
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            read_filter_items(reader, all_qrs, all_mms, all_blocks);
+        }
+        ASSERT_EQ(all_qrs.size(), 5000);
+        ASSERT_GT(all_blocks, 5);
+
+        Timestamp start = all_qrs[1700].first;
+        Timestamp end = all_qrs[2300].first;
+        std::vector<std::pair<Timestamp, std::string>> expected_qrs;
+        std::vector<Timestamp> expected_mms;
+        for (auto& qr : all_qrs) {
+            if (start <= qr.first && qr.first < end)
+                expected_qrs.push_back(qr);
+        }
+        for (auto& mm : all_mms) {
+            if (start <= mm && mm < end)
+                expected_mms.push_back(mm);
+        }
+        ASSERT_GT(expected_mms.size(), 0);
+
+        for (bool time_ordered : {false, true}) {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            reader.set_time_filter(start, end, time_ordered);
+
+            std::vector<std::pair<Timestamp, std::string>> qrs;
+            std::vector<Timestamp> mms;
+            uint64_t blocks = 0;
+            read_filter_items(reader, qrs, mms, blocks);
+
+            ASSERT_EQ(qrs.size(), expected_qrs.size());
+            for (std::size_t i = 0; i < qrs.size(); i++) {
+                EXPECT_EQ(qrs[i].first.m_secs, expected_qrs[i].first.m_secs);
+                EXPECT_EQ(qrs[i].first.m_ticks, expected_qrs[i].first.m_ticks);
+                EXPECT_EQ(qrs[i].second, expected_qrs[i].second);
+            }
+            EXPECT_EQ(mms.size(), expected_mms.size());
+            EXPECT_LT(blocks, all_blocks);
+        }
+
+        // Range ending before the first item
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            reader.set_time_filter(Timestamp(0, 0), all_qrs[0].first, true);
+
+            bool eof = false;
+            CdnsBlockRead block = reader.read_block(eof);
+            EXPECT_TRUE(eof);
+
+            // Filter can be removed, but reading already ended
+            reader.clear_time_filter();
+            block = reader.read_block(eof);
+            EXPECT_TRUE(eof);
+        }
+
+        remove_file(file);
+    }
+
+    TEST(CdnsReaderTest, CRItemFilterTest) {
+        TrafficGeneratorConfig config;
+        config.mm_ratio = 0.1;
+        TrafficGenerator generator(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 500;
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            generator.generate(exporter, 5000);
+            exporter.write_block();
+        }
+
+        // Query name, client IP and timestamp of each read item
+        using Item = std::tuple<std::string, std::string, uint64_t>;
+        auto read_items = [](CdnsReader& reader, std::vector<Item>& qrs, std::vector<Item>& mms) {
+            CdnsBlockRead block;
+            bool eof = false;
+            uint64_t blocks = 0;
+
+            while (true) {
+                reader.read_block(block, eof);
+                if (eof)
+                    break;
+
+                blocks++;
+                bool end = false;
+                while (true) {
+                    GenericQueryResponse gqr = block.read_generic_qr(end);
+                    if (end)
+                        break;
+                    qrs.emplace_back(gqr.query_name ? *gqr.query_name : std::string(),
+                                     gqr.client_ip ? *gqr.client_ip : std::string(), gqr.ts->m_secs);
+                }
+
+                while (true) {
+                    GenericMalformedMessage gmm = block.read_generic_mm(end);
+                    if (end)
+                        break;
+                    mms.emplace_back(std::string(), gmm.client_ip ? *gmm.client_ip : std::string(),
+                                     gmm.ts->m_secs);
+                }
+            }
+
+            return blocks;
+        };
+
+        std::vector<Item> all_qrs;
+        std::vector<Item> all_mms;
+        uint64_t all_blocks = 0;
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            all_blocks = read_items(reader, all_qrs, all_mms);
+        }
+        ASSERT_EQ(all_qrs.size(), 5000);
+
+        auto filter_items = [](const std::vector<Item>& items, const std::string* name, const std::string* ip) {
+            std::vector<Item> ret;
+            for (auto& item : items) {
+                if ((!name || std::get<0>(item) == *name) && (!ip || std::get<1>(item) == *ip))
+                    ret.push_back(item);
+            }
+            return ret;
+        };
+
+        std::string name = std::get<0>(all_qrs[100]);
+        std::string ip = std::get<1>(all_qrs[4000]);
+        std::string both_name = std::get<0>(all_qrs[2500]);
+        std::string both_ip = std::get<1>(all_qrs[2500]);
+        std::string missing = std::string("\x07missing\x00", 9);
+
+        struct FilterCase {
+            const std::string* name;
+            const std::string* ip;
+        };
+        for (auto& fc : {FilterCase{&name, nullptr}, FilterCase{nullptr, &ip}, FilterCase{&both_name, &both_ip},
+                         FilterCase{&missing, nullptr}, FilterCase{nullptr, &missing}}) {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            if (fc.name)
+                reader.set_query_name_filter(*fc.name);
+            if (fc.ip)
+                reader.set_client_ip_filter(*fc.ip);
+
+            std::vector<Item> qrs;
+            std::vector<Item> mms;
+            uint64_t blocks = read_items(reader, qrs, mms);
+
+            std::vector<Item> expected_qrs = filter_items(all_qrs, fc.name, fc.ip);
+            std::vector<Item> expected_mms = fc.name ? std::vector<Item>() : filter_items(all_mms, nullptr, fc.ip);
+            EXPECT_EQ(qrs, expected_qrs);
+            EXPECT_EQ(mms, expected_mms);
+            EXPECT_LE(blocks, all_blocks);
+            if (fc.name == &missing || fc.ip == &missing)
+                EXPECT_EQ(blocks, 0);
+            else
+                EXPECT_FALSE(qrs.empty());
+        }
+
+        // Query name and time filter combined
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            reader.set_query_name_filter(name);
+            reader.set_time_filter(Timestamp(0, 0), Timestamp(std::get<2>(all_qrs[2500]), 0));
+
+            std::vector<Item> qrs;
+            std::vector<Item> mms;
+            read_items(reader, qrs, mms);
+
+            std::vector<Item> expected_qrs;
+            for (auto& qr : filter_items(all_qrs, &name, nullptr)) {
+                if (std::get<2>(qr) < std::get<2>(all_qrs[2500]))
+                    expected_qrs.push_back(qr);
+            }
+            EXPECT_EQ(qrs, expected_qrs);
+            EXPECT_TRUE(mms.empty());
+        }
+
+        // Removed filters
+        {
+            std::ifstream ifs(file, std::ifstream::binary);
+            CdnsReader reader(ifs);
+            reader.set_query_name_filter(name);
+            reader.set_client_ip_filter(ip);
+            reader.clear_query_name_filter();
+            reader.clear_client_ip_filter();
+
+            std::vector<Item> qrs;
+            std::vector<Item> mms;
+            EXPECT_EQ(read_items(reader, qrs, mms), all_blocks);
+            EXPECT_EQ(qrs, all_qrs);
+            EXPECT_EQ(mms, all_mms);
+        }
+
+        remove_file(file);
+    }
 }
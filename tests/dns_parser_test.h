@@ -0,0 +1,137 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <gtest/gtest.h>
+
+#include "../src/cdns.h"
+
+namespace CDNS {
+    // Query for test.cz A with RD flag and OPT record with DO bit and UDP size 1232
+    const uint8_t wire_query[] = {
+        0x12, 0x34, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x04, 't', 'e', 's', 't', 0x02, 'c', 'z', 0x00, 0x00, 0x01, 0x00, 0x01,
+        0x00, 0x00, 0x29, 0x04, 0xD0, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00
+    };
+
+    // Response to the query with one compressed A record
+    const uint8_t wire_response[] = {
+        0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x04, 't', 'e', 's', 't', 0x02, 'c', 'z', 0x00, 0x00, 0x01, 0x00, 0x01,
+        0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x01, 0x2C, 0x00, 0x04, 0x01, 0x02, 0x03, 0x04
+    };
+
+    TEST(DnsMessageParserTest, DMPQueryTest) {
+        DnsMessageParser parser(wire_query, sizeof(wire_query));
+        ASSERT_TRUE(parser.valid());
+        EXPECT_EQ(parser.id(), 0x1234);
+        EXPECT_FALSE(parser.is_response());
+        EXPECT_EQ(parser.opcode(), 0);
+        EXPECT_EQ(parser.count(DnsSection::QUESTION), 1);
+        EXPECT_EQ(parser.count(DnsSection::ADDITIONAL), 1);
+        EXPECT_TRUE(parser.has_opt());
+        EXPECT_TRUE(parser.edns_do());
+        EXPECT_EQ(parser.udp_size(), 1232);
+        EXPECT_EQ(parser.opt_rdata_size(), 0);
+        EXPECT_FALSE(parser.has_trailing_data());
+
+        DnsRecord record;
+        ASSERT_TRUE(parser.next(record));
+        EXPECT_EQ(record.section, DnsSection::QUESTION);
+        EXPECT_EQ(std::string(reinterpret_cast<char*>(record.name), record.name_size),
+                  std::string(reinterpret_cast<const char*>(wire_query) + 12, 9));
+        EXPECT_EQ(record.type, 1);
+        ASSERT_TRUE(parser.next(record));
+        EXPECT_EQ(record.section, DnsSection::ADDITIONAL);
+        EXPECT_EQ(record.type, DnsMessageParser::OPT_TYPE);
+        EXPECT_FALSE(parser.next(record));
+    }
+
+    TEST(DnsMessageParserTest, DMPResponseTest) {
+        DnsMessageParser parser(wire_response, sizeof(wire_response));
+        ASSERT_TRUE(parser.valid());
+        EXPECT_TRUE(parser.is_response());
+        EXPECT_FALSE(parser.has_opt());
+
+        DnsRecord record;
+        ASSERT_TRUE(parser.next(record));
+        ASSERT_TRUE(parser.next(record));
+        EXPECT_EQ(record.section, DnsSection::ANSWER);
+        EXPECT_EQ(record.name_size, 9);
+        EXPECT_EQ(record.ttl, 300);
+        EXPECT_EQ(record.rdata_size, 4);
+        EXPECT_EQ(record.rdata, wire_response + sizeof(wire_response) - 4);
+    }
+
+    TEST(DnsMessageParserTest, DMPMalformedTest) {
+        // Truncated message
+        DnsMessageParser truncated(wire_response, sizeof(wire_response) - 1);
+        EXPECT_FALSE(truncated.valid());
+
+        // Too short for DNS header
+        DnsMessageParser header(wire_query, 11);
+        EXPECT_FALSE(header.valid());
+
+        // Compression pointer pointing forward
+        uint8_t loop[sizeof(wire_response)];
+        std::memcpy(loop, wire_response, sizeof(loop));
+        loop[26] = 0x1A;
+        DnsMessageParser looped(loop, sizeof(loop));
+        EXPECT_FALSE(looped.valid());
+
+        // Trailing data doesn't make message malformed
+        uint8_t trailing[sizeof(wire_query) + 2] = {};
+        std::memcpy(trailing, wire_query, sizeof(wire_query));
+        DnsMessageParser trail(trailing, sizeof(trailing));
+        EXPECT_TRUE(trail.valid());
+        EXPECT_TRUE(trail.has_trailing_data());
+    }
+
+    TEST(DnsMessageParserTest, DMPBlockTest) {
+        BlockParameters bp;
+        bp.storage_parameters.storage_hints.query_response_hints = static_cast<QueryResponseHintsMask>(0xFFFFFFFF);
+        CdnsBlock block(bp, 0);
+
+        WireQueryResponse wqr;
+        wqr.ts = Timestamp(10, 0);
+        wqr.client_ip = "\x7F\x00\x00\x01";
+        wqr.client_ip_size = 4;
+        wqr.client_port = 5353;
+        wqr.query = wire_query;
+        wqr.query_size = sizeof(wire_query);
+        wqr.response = wire_response;
+        wqr.response_size = sizeof(wire_response);
+
+        EXPECT_FALSE(block.add_wire_query_response(wqr));
+        EXPECT_EQ(block.get_qr_count(), 1);
+        EXPECT_EQ(block.get_mm_count(), 0);
+
+        QueryResponseSignature qrs = block.get_qr_signature(0);
+        EXPECT_EQ(*qrs.qr_sig_flags, QueryResponseFlagsMask::has_query | QueryResponseFlagsMask::has_response
+                                     | QueryResponseFlagsMask::query_has_opt);
+        EXPECT_EQ(*qrs.qr_dns_flags, DNSFlagsMask::query_rd | DNSFlagsMask::query_do | DNSFlagsMask::response_rd
+                                     | DNSFlagsMask::response_ra);
+        EXPECT_EQ(*qrs.query_udp_size, 1232);
+        EXPECT_EQ(*qrs.query_arcount, 1);
+        EXPECT_EQ(block.get_classtype(*qrs.query_classtype_index).type, 1);
+        EXPECT_EQ(block.get_name_rdata(*qrs.query_opt_rdata_index), "");
+        EXPECT_EQ(block.get_name_rdata(1), std::string(reinterpret_cast<const char*>(wire_query) + 12, 9));
+
+        // Only the response answer is stored in extended sections
+        EXPECT_EQ(block.get_rr_list(0).size(), 1);
+        EXPECT_EQ(*block.get_rr(0).ttl, 300);
+
+        // Malformed response is stored as Malformed message
+        wqr.response_size = sizeof(wire_response) - 1;
+        block.add_wire_query_response(wqr);
+        EXPECT_EQ(block.get_qr_count(), 2);
+        EXPECT_EQ(block.get_mm_count(), 1);
+    }
+}
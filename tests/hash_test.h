@@ -31,6 +31,36 @@ namespace CDNS {
         EXPECT_NE(hash, hash3);
     }
 
+    TEST(HashTest, HImplementationTest) {
+        std::string data;
+        for (unsigned i = 0; i < 1000; i++)
+            data.push_back(static_cast<char>(i * 7 + 3));
+
+        const char* bytes = data.data();
+
+        // CRC32C check value
+        EXPECT_EQ(~crc32c_update_portable("123456789", 9, ~0U), 0xE3069283);
+
+        // All implementations give the same results for short data and data hashed in lanes
+        for (std::size_t size : {0, 1, 7, 8, 13, 95, 96, 100, 255, 1000}) {
+            uint32_t portable = crc32c_update_portable(data.data(), size, ~0U);
+            EXPECT_EQ(crc32c_update(data.data(), size, ~0U), portable);
+            EXPECT_EQ(hash_value(bytes, size), static_cast<std::size_t>(~portable));
+        }
+
+        // Data in every lane affect the hash
+        std::size_t lanes = 600;
+        std::string changed = data;
+        changed[500] ^= 1;
+        EXPECT_NE(hash_value(bytes, lanes), hash_value(static_cast<const char*>(changed.data()), lanes));
+        changed = data;
+        changed[599] ^= 1;
+        EXPECT_NE(hash_value(bytes, lanes), hash_value(static_cast<const char*>(changed.data()), lanes));
+
+        HashImplementation impl = get_hash_implementation();
+        EXPECT_TRUE(impl == HashImplementation::PORTABLE || impl == HashImplementation::SSE42);
+    }
+
     TEST(HashTest, HClassTypeTest) {
         ClassType ct, ct2, ct3;
         CDNS::hash<ClassType> hash_func;
@@ -68,6 +98,31 @@ namespace CDNS {
         EXPECT_NE(hash, hash4);
     }
 
+    TEST(HashTest, HCompactOptionalTest) {
+        CompactOptional<uint16_t> opt, opt2(53), opt3(boost::optional<uint16_t>(53));
+        boost::optional<uint16_t> missing = opt;
+        boost::optional<uint16_t> present = opt2;
+
+        EXPECT_EQ(sizeof(opt), sizeof(uint16_t) + 1);
+        EXPECT_FALSE(opt);
+        EXPECT_FALSE(missing);
+        EXPECT_EQ(*present, 53);
+        EXPECT_EQ(opt2, opt3);
+        EXPECT_THROW(opt.value(), boost::bad_optional_access);
+        EXPECT_EQ(hash_value(opt), hash_value(missing));
+        EXPECT_EQ(hash_value(opt2), hash_value(present));
+
+        // Resetting the value makes the optional equal to a never set one again
+        opt2 = boost::none;
+        EXPECT_EQ(opt, opt2);
+
+        QueryResponseSignature qrs, qrs2;
+        qrs.query_rcode = 0;
+        EXPECT_NE(qrs, qrs2);
+        qrs.query_rcode = boost::none;
+        EXPECT_EQ(qrs, qrs2);
+    }
+
     TEST(HashTest, HQuestionTest) {
         Question q, q2, q3;
         CDNS::hash<Question> hash_func;
@@ -169,9 +224,9 @@ namespace CDNS {
     }
 
     TEST(HashTest, HIndexListItemTest) {
-        std::vector<index_t> list = {1, 2};
-        std::vector<index_t> list2 = {1, 2};
-        std::vector<index_t> list3 = {1, 2, 5};
+        IndexList list = {1, 2};
+        IndexList list2 = {1, 2};
+        IndexList list3 = {1, 2, 5};
         IndexListItem ili, ili2, ili3, ili4;
         CDNS::hash<IndexListItem> hash_func;
         ili.list = list;
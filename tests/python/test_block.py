@@ -133,6 +133,7 @@ class TestBlock(unittest.TestCase):
         self.assertFalse(bs.unmatched_responses)
         self.assertFalse(bs.discarded_opcode)
         self.assertFalse(bs.malformed_items)
+        self.assertFalse(bs.dropped_items)
 
     def test_qr_ctest(self):
         qr = pycdns.QueryResponse()
@@ -148,11 +148,11 @@ class TestCdnsExporter(unittest.TestCase):
         self.assertEqual(exporter.get_block_item_count(), 1)
         written = exporter.rotate_output(common.file2, True)
 
-        common.test_size_and_remove_file(self, common.file, written)
-
         exporter.buffer_qr(gqr2)
         self.assertEqual(exporter.get_block_item_count(), 1)
-        written = exporter.write_block()
+        written2 = exporter.write_block()
         del exporter
 
-        common.test_size_and_remove_file(self, common.file2, written + 1)
+        # Rotated file is closed and renamed in background, so it's complete only after the exporter is destroyed
+        common.test_size_and_remove_file(self, common.file, written)
+        common.test_size_and_remove_file(self, common.file2, written2 + 1)
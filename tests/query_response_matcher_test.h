@@ -0,0 +1,131 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "../src/cdns.h"
+#include "dns_parser_test.h"
+
+namespace CDNS {
+    WireQueryResponse matcher_message(const Timestamp& ts, bool query, uint16_t client_port = 5353) {
+        WireQueryResponse msg;
+        msg.ts = ts;
+        msg.client_ip = "\x7F\x00\x00\x01";
+        msg.client_ip_size = 4;
+        msg.client_port = client_port;
+        msg.server_ip = "\x7F\x00\x00\x02";
+        msg.server_ip_size = 4;
+        msg.server_port = 53;
+
+        if (query) {
+            msg.query = wire_query;
+            msg.query_size = sizeof(wire_query);
+        }
+        else {
+            msg.response = wire_response;
+            msg.response_size = sizeof(wire_response);
+        }
+
+        return msg;
+    }
+
+    TEST(QueryResponseMatcherTest, QRMMatchTest) {
+        CollectionParameters cp;
+        cp.query_timeout = 100;
+        std::vector<WireQueryResponse> out;
+        QueryResponseMatcher matcher(cp, 1000000, [&out](const WireQueryResponse& wqr) { out.push_back(wqr); });
+
+        matcher.add(matcher_message(Timestamp(10, 0), true));
+        EXPECT_EQ(matcher.get_pending_count(), 1);
+
+        // Response from different client port doesn't match
+        matcher.add(matcher_message(Timestamp(10, 1000), false, 5354));
+        EXPECT_EQ(matcher.get_pending_count(), 2);
+
+        // Response from different port expires after skew timeout before the matching response arrives
+        matcher.add(matcher_message(Timestamp(10, 1500), false));
+        ASSERT_EQ(out.size(), 2);
+        EXPECT_TRUE(!out[0].query && out[0].response);
+        EXPECT_EQ(matcher.get_unmatched_responses(), 1);
+        EXPECT_TRUE(out[1].query && out[1].response);
+        EXPECT_EQ(*out[1].response_delay, 1500);
+        EXPECT_EQ(*out[1].client_port, 5353);
+        EXPECT_EQ(matcher.get_matched_count(), 1);
+        EXPECT_EQ(matcher.get_pending_count(), 0);
+    }
+
+    TEST(QueryResponseMatcherTest, QRMTimeoutTest) {
+        CollectionParameters cp;
+        cp.query_timeout = 100;
+        cp.skew_timeout = 50;
+        unsigned matched = 0, queries = 0, responses = 0;
+        QueryResponseMatcher matcher(cp, 1000000, [&](const WireQueryResponse& wqr) {
+            if (wqr.query && wqr.response)
+                matched++;
+            else if (wqr.query)
+                queries++;
+            else
+                responses++;
+        });
+
+        // Query times out before response arrives
+        matcher.add(matcher_message(Timestamp(10, 0), true));
+        matcher.add(matcher_message(Timestamp(10, 100001), false));
+        EXPECT_EQ(queries, 1);
+        EXPECT_EQ(matched, 0);
+        EXPECT_EQ(matcher.get_pending_count(), 1);
+
+        // Response seen shortly before its query is matched
+        matcher.add(matcher_message(Timestamp(20, 0), false));
+        matcher.add(matcher_message(Timestamp(20, 40), true));
+        EXPECT_EQ(matched, 1);
+        EXPECT_EQ(responses, 1);
+
+        // Query is kept for the whole query timeout spanning several turns of timer wheel
+        cp.query_timeout = 3000;
+        QueryResponseMatcher long_matcher(cp, 1000, [&](const WireQueryResponse& wqr) {
+            if (wqr.query && wqr.response)
+                matched++;
+        });
+        long_matcher.add(matcher_message(Timestamp(30, 0), true));
+        long_matcher.advance(Timestamp(31, 500));
+        long_matcher.advance(Timestamp(32, 900));
+        long_matcher.add(matcher_message(Timestamp(33, 0), false));
+        EXPECT_EQ(matched, 2);
+
+        // Malformed message is passed through and pending messages are flushed
+        WireQueryResponse malformed = matcher_message(Timestamp(40, 0), true);
+        malformed.query_size = 5;
+        matcher.add(matcher_message(Timestamp(40, 0), true, 1));
+        matcher.add(malformed);
+        EXPECT_EQ(queries, 2);
+        matcher.flush();
+        EXPECT_EQ(queries, 3);
+        EXPECT_EQ(matcher.get_unmatched_queries(), 2);
+        EXPECT_THROW(matcher.add(WireQueryResponse()), std::runtime_error);
+    }
+
+    TEST(QueryResponseMatcherTest, QRMBlockTest) {
+        CdnsBlock block;
+        QueryResponseMatcher matcher(CollectionParameters(), 1000000, [&block](const WireQueryResponse& wqr) {
+            block.add_wire_query_response(wqr);
+        });
+
+        for (unsigned i = 0; i < 10; i++) {
+            matcher.add(matcher_message(Timestamp(10, i * 10), true, 1000 + i));
+            matcher.add(matcher_message(Timestamp(10, i * 10 + 5), false, 1000 + i));
+        }
+
+        EXPECT_EQ(block.get_qr_count(), 10);
+        EXPECT_EQ(matcher.get_matched_count(), 10);
+        EXPECT_EQ(matcher.get_pending_count(), 0);
+    }
+}
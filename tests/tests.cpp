@@ -9,11 +9,18 @@
 #include <gtest/gtest.h>
 #include "file_preamble_test.h"
 #include "hash_test.h"
+#include "anonymizer_test.h"
 #include "timestamp_test.h"
 #include "block_table_test.h"
 #include "block_test.h"
+#include "dns_parser_test.h"
+#include "query_response_matcher_test.h"
 #include "writer_test.h"
 #include "cdns_encoder_test.h"
 #include "cdns_decoder_test.h"
+#include "cbor_scanner_test.h"
 #include "cdns_exporter_test.h"
 #include "cdns_reader_test.h"
+#include "block_summary_test.h"
+#include "traffic_generator_test.h"
+#include "cdns_merger_test.h"
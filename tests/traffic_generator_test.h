@@ -0,0 +1,107 @@
+/**
+ * Copyright © 2026 CZ.NIC, z. s. p. o.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, you can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <map>
+#include <gtest/gtest.h>
+
+#include "common.h"
+#include "../src/cdns.h"
+
+namespace CDNS {
+
+    TEST(TrafficGeneratorTest, TGDeterministicTest) {
+        TrafficGeneratorConfig config;
+        config.seed = 7;
+        config.clients = 100;
+        config.names = 200;
+        TrafficGenerator gen1(config);
+        TrafficGenerator gen2(config);
+        config.seed = 8;
+        TrafficGenerator gen3(config);
+
+        bool differs = false;
+        for (unsigned i = 0; i < 100; i++) {
+            GenericQueryResponse qr1 = gen1.next_qr();
+            GenericQueryResponse qr2 = gen2.next_qr();
+            GenericQueryResponse qr3 = gen3.next_qr();
+            EXPECT_EQ(qr1.string(), qr2.string());
+            differs |= qr1.string() != qr3.string();
+        }
+        EXPECT_TRUE(differs);
+
+        TrafficGeneratorConfig empty;
+        empty.names = 0;
+        EXPECT_THROW(TrafficGenerator{empty}, std::invalid_argument);
+    }
+
+    TEST(TrafficGeneratorTest, TGDistributionTest) {
+        TrafficGeneratorConfig config;
+        config.names = 1000;
+        TrafficGenerator gen(config);
+        std::map<std::string, unsigned> names;
+        unsigned ipv6 = 0;
+        boost::optional<Timestamp> last;
+
+        for (auto& qr : gen.generate_qrs(10000)) {
+            ASSERT_TRUE(qr.ts && qr.client_ip && qr.query_name && qr.qr_transport_flags);
+            names[*qr.query_name]++;
+            if (qr.client_ip->size() == 16) {
+                ipv6++;
+                EXPECT_TRUE(*qr.qr_transport_flags & QueryResponseTransportFlagsMask::ip_address);
+            }
+            if (last) {
+                EXPECT_TRUE(*last < *qr.ts);
+            }
+            last = qr.ts;
+        }
+
+        // Zipfian popularity: the most popular name is far more frequent than an average one
+        unsigned top = 0;
+        for (auto& name : names)
+            top = std::max(top, name.second);
+        EXPECT_GT(top, 10 * 10000 / names.size());
+        EXPECT_GT(ipv6, 0U);
+        EXPECT_LT(ipv6, 5000U);
+    }
+
+    TEST(TrafficGeneratorTest, TGExportTest) {
+        TrafficGeneratorConfig config;
+        config.aec_ratio = 0.1;
+        config.mm_ratio = 0.05;
+        TrafficGenerator gen(config);
+        FilePreamble fp;
+        fp.get_block_parameters(0).storage_parameters.max_block_items = 500;
+
+        {
+            CdnsExporter exporter(fp, file, CborOutputCompression::NO_COMPRESSION);
+            EXPECT_GT(gen.generate(exporter, 1000), 0U);
+            exporter.write_block();
+        }
+
+        std::ifstream ifs(file, std::ifstream::binary);
+        CdnsReader reader(ifs);
+        bool end = false;
+        uint64_t qrs = 0, aecs = 0, mms = 0;
+        while (true) {
+            CdnsBlockRead block = reader.read_block(end);
+            if (end)
+                break;
+            qrs += block.get_qr_count();
+            aecs += block.get_aec_count();
+            mms += block.get_mm_count();
+        }
+
+        EXPECT_EQ(qrs, 1000U);
+        EXPECT_GT(aecs, 0U);
+        EXPECT_LE(aecs, 100U);
+        EXPECT_EQ(mms, 50U);
+        remove(file.c_str());
+    }
+}
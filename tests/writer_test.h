@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <fstream>
+#include <thread>
 #include <zlib.h>
 #include <lzma.h>
 #include <gtest/gtest.h>
@@ -54,6 +55,24 @@ namespace CDNS {
         test_content_and_remove_file(file2, out);
     }
 
+    TEST(CborOutputWriterTest, COWRotateSameNameTest) {
+        CborOutputWriter* cow = new CborOutputWriter(file);
+        std::string out("test");
+        struct stat buff;
+
+        // Background renaming of the previous file must not move the new one
+        cow->write(out.c_str(), out.size());
+        cow->rotate_output(file);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        EXPECT_EQ(stat((file + ".part").c_str(), &buff), 0);
+
+        cow->write(out.c_str(), out.size());
+        delete cow;
+
+        EXPECT_EQ(stat((file + ".part").c_str(), &buff), -1);
+        test_content_and_remove_file(file, out);
+    }
+
     TEST(CborOutputWriterFDTest, COWFDTest) {
         int fd = open(file.c_str(), O_CREAT | O_RDWR, 0644);
         CborOutputWriter* cow = new CborOutputWriter(fd);